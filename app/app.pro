@@ -0,0 +1,49 @@
+# -------------------------------------------------
+# Project created by QtCreator 2008-12-08T23:14:52
+# -------------------------------------------------
+# Windows-specific for the application icon
+# RC_FILE = carve.rc
+# Mac-specific for the application icon
+ICON = ../Carve.icns
+
+# QT += script \
+# webkit
+QT += svg \
+    xml
+TARGET = Carve
+TEMPLATE = app
+include(../libcarve/libcarve.pri)
+SRC = ../src
+SOURCES += $$SRC/main.cpp \
+    $$SRC/carvewindow.cpp \
+    $$SRC/carvesvgwindow.cpp \
+    $$SRC/carvepreviewwindow.cpp \
+    $$SRC/version.cpp \
+    $$SRC/domtreeview.cpp \
+    $$SRC/propertiespane.cpp \
+    $$SRC/carvescene.cpp \
+    $$SRC/carvedesignview.cpp \
+    $$SRC/carvegraphicsitems.cpp \
+    $$SRC/diagnosticspane.cpp \
+    $$SRC/profilerpane.cpp
+HEADERS += $$SRC/carvewindow.h \
+    $$SRC/carvesvgwindow.h \
+    $$SRC/carvepreviewwindow.h \
+    $$SRC/version.h \
+    $$SRC/domtreeview.h \
+    $$SRC/propertiespane.h \
+    $$SRC/carvescene.h \
+    $$SRC/carvedesignview.h \
+    $$SRC/carve.h \
+    $$SRC/carvegraphicsitems.h \
+    $$SRC/diagnosticspane.h \
+    $$SRC/profilerpane.h
+FORMS += ../ui/carvewindow.ui \
+    ../ui/HelpDialog.ui \
+    ../ui/PreferencesDialog.ui \
+    ../ui/FindDialog.ui
+OTHER_FILES += ../README.txt \
+    ../HISTORY.txt \
+    ../INSTALL.txt \
+    ../LICENSE.txt
+RESOURCES += ../carve.qrc
@@ -0,0 +1,15 @@
+# -------------------------------------------------
+# Benchmarks for the parsers, the model and the highlighter
+# run: carvebench [--filter <substring>] [--output results.json] [--quick]
+# -------------------------------------------------
+QT += xml
+TARGET = carvebench
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+include(../libcarve/libcarve.pri)
+SOURCES += main.cpp \
+    benchmark.cpp \
+    svggenerator.cpp
+HEADERS += benchmark.h \
+    svggenerator.h
@@ -0,0 +1,104 @@
+#include "benchmark.h"
+
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QVector>
+#include <QDateTime>
+#include <algorithm>
+
+// a sample shorter than this is mostly clock overhead
+const qint64 MIN_SAMPLE_NS = 100000;
+const int MAX_SAMPLES = 10000;
+
+BenchmarkRunner::BenchmarkRunner(qint64 minTimeMs, int minSamples) :
+	minTimeNs_(minTimeMs * 1000000), minSamples_(minSamples)
+{
+}
+
+BenchmarkResult BenchmarkRunner::run(Benchmark* benchmark) {
+    benchmark->setUp();
+
+    QElapsedTimer timer;
+
+    // calibrate the batch size with one warm-up call and then by doubling
+    qint64 batch = 1;
+    timer.start();
+    benchmark->run();
+    qint64 elapsed = timer.nsecsElapsed();
+    while(elapsed < MIN_SAMPLE_NS && batch < (Q_INT64_C(1) << 30)) {
+	batch *= 2;
+	timer.restart();
+	for(qint64 i = 0; i < batch; ++i) { benchmark->run(); }
+	elapsed = timer.nsecsElapsed();
+    }
+
+    QVector<double> samples;
+    qint64 total = 0;
+    qint64 iterations = 0;
+    while((total < minTimeNs_ || samples.size() < minSamples_) && samples.size() < MAX_SAMPLES) {
+	timer.restart();
+	for(qint64 i = 0; i < batch; ++i) { benchmark->run(); }
+	qint64 ns = timer.nsecsElapsed();
+	samples.append(double(ns) / batch);
+	total += ns;
+	iterations += batch;
+    }
+
+    benchmark->tearDown();
+
+    std::sort(samples.begin(), samples.end());
+
+    BenchmarkResult result;
+    result.name = benchmark->name();
+    result.iterations = iterations;
+    result.meanNs = double(total) / iterations;
+    result.medianNs = samples.at(samples.size() / 2);
+    result.minNs = samples.first();
+    result.maxNs = samples.last();
+    result.bytes = benchmark->bytes();
+    result.mbPerSec = (result.bytes > 0 && result.meanNs > 0)
+		      ? (double(result.bytes) / (1024.0 * 1024.0)) / (result.meanNs / 1e9) : 0.0;
+    result.items = benchmark->items();
+    result.nsPerItem = result.items > 0 ? result.meanNs / result.items : 0.0;
+    return result;
+}
+
+namespace {
+
+QString jsonString(const QString& s) {
+    QString escaped(s);
+    escaped.replace("\\", "\\\\").replace("\"", "\\\"").replace("\n", "\\n");
+    return QString("\"%1\"").arg(escaped);
+}
+
+QString jsonNumber(double d) {
+    return QString::number(d, 'f', 3);
+}
+
+}
+
+QString BenchmarkRunner::toJson(const QList<BenchmarkResult>& results) {
+    QStringList entries;
+    for(int i = 0; i < results.size(); ++i) {
+	const BenchmarkResult& r = results.at(i);
+	QStringList fields;
+	fields << QString("\"name\": %1").arg(jsonString(r.name))
+	       << QString("\"iterations\": %1").arg(r.iterations)
+	       << QString("\"mean_ns\": %1").arg(jsonNumber(r.meanNs))
+	       << QString("\"median_ns\": %1").arg(jsonNumber(r.medianNs))
+	       << QString("\"min_ns\": %1").arg(jsonNumber(r.minNs))
+	       << QString("\"max_ns\": %1").arg(jsonNumber(r.maxNs))
+	       << QString("\"bytes\": %1").arg(r.bytes)
+	       << QString("\"mb_per_s\": %1").arg(jsonNumber(r.mbPerSec))
+	       << QString("\"items\": %1").arg(r.items)
+	       << QString("\"ns_per_item\": %1").arg(jsonNumber(r.nsPerItem));
+	entries << QString("    { %1 }").arg(fields.join(", "));
+    }
+
+    QString json("{\n");
+    json += QString("  \"qt_version\": %1,\n").arg(jsonString(qVersion()));
+    json += QString("  \"timestamp\": %1,\n").arg(jsonString(QDateTime::currentDateTime().toUTC().toString(Qt::ISODate)));
+    json += QString("  \"benchmarks\": [\n%1\n  ]\n").arg(entries.join(",\n"));
+    json += "}\n";
+    return json;
+}
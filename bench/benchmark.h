@@ -0,0 +1,67 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QString>
+#include <QList>
+#include <QtGlobal>
+
+// A single benchmarked operation.  setUp() and tearDown() run once, outside the
+// timed region; run() is the operation itself and is called many times.
+class Benchmark
+{
+public:
+    Benchmark(const QString& name, qint64 bytes = 0) : name_(name), bytes_(bytes), items_(1) {}
+    virtual ~Benchmark() {}
+
+    const QString& name() const { return name_; }
+    // number of input bytes one run() consumes, used to report throughput (0 if meaningless)
+    qint64 bytes() const { return bytes_; }
+    // number of items (nodes, colors, ...) one run() processes, used to report the cost per item
+    qint64 items() const { return items_; }
+
+    virtual void setUp() {}
+    virtual void run() = 0;
+    virtual void tearDown() {}
+
+protected:
+    void setBytes(qint64 bytes) { bytes_ = bytes; }
+    void setItems(qint64 items) { items_ = items; }
+
+private:
+    QString name_;
+    qint64 bytes_;
+    qint64 items_;
+};
+
+struct BenchmarkResult
+{
+    QString name;
+    qint64 iterations;
+    double meanNs;      // per run()
+    double medianNs;
+    double minNs;
+    double maxNs;
+    qint64 bytes;
+    double mbPerSec;    // 0 when bytes is 0
+    qint64 items;
+    double nsPerItem;
+};
+
+// Times benchmarks in samples: calls are batched so that a sample lasts long
+// enough for the clock to resolve it, and samples are taken until both the
+// minimum time and the minimum number of samples have been reached.
+class BenchmarkRunner
+{
+public:
+    BenchmarkRunner(qint64 minTimeMs = 500, int minSamples = 5);
+
+    BenchmarkResult run(Benchmark* benchmark);
+
+    static QString toJson(const QList<BenchmarkResult>& results);
+
+private:
+    qint64 minTimeNs_;
+    int minSamples_;
+};
+
+#endif // BENCHMARK_H
@@ -0,0 +1,632 @@
+#include <QApplication>
+#include <QDomDocument>
+#include <QDomElement>
+#include <QTextDocument>
+#include <QStringList>
+#include <QFile>
+#include <QTextStream>
+#include <QBuffer>
+#include <QRegExp>
+#include <cstdio>
+
+#include "benchmark.h"
+#include "svggenerator.h"
+#include "domhelper.h"
+#include "carvesvgdocument.h"
+#include "carvesvgnode.h"
+#include "carvegelement.h"
+#include "carverectelement.h"
+#include "carvepathelement.h"
+#include "svghighlighter.h"
+#include "carvestyle.h"
+#include "carvedocumentstore.h"
+#include "carvegzipdevice.h"
+#include "carvepathitem.h"
+#include "carvearena.h"
+
+namespace {
+
+// results are accumulated here so the compiler cannot discard the benchmarked calls
+volatile qint64 sink = 0;
+
+qint64 utf8Size(const QString& text) {
+    return text.toUtf8().size();
+}
+
+// creates every node of the model (but no graphics items)
+int buildModel(CarveSVGNode* node) {
+    if(!node) { return 0; }
+    int count = 1;
+    int numChildren = node->numChildren();
+    for(int i = 0; i < numChildren; ++i) {
+	count += buildModel(node->child(i));
+    }
+    return count;
+}
+
+class PathTraitBenchmark : public Benchmark
+{
+public:
+    PathTraitBenchmark(const QString& name, const QString& d) : Benchmark(name, utf8Size(d)), d_(d) {}
+    void setUp() {
+	elem_ = doc_.createElement("path");
+	elem_.setAttribute("d", d_);
+    }
+    void run() { sink += getPathTrait(elem_, "d").elementCount(); }
+private:
+    QString d_;
+    QDomDocument doc_;
+    QDomElement elem_;
+};
+
+class TransformBenchmark : public Benchmark
+{
+public:
+    TransformBenchmark(const QString& name, const QString& transform) :
+	    Benchmark(name, utf8Size(transform)), transform_(transform) {}
+    void setUp() {
+	elem_ = doc_.createElement("g");
+	elem_.setAttribute("transform", transform_);
+    }
+    void run() { sink += qint64(getTransform(elem_).m11() * 1000); }
+private:
+    QString transform_;
+    QDomDocument doc_;
+    QDomElement elem_;
+};
+
+// getTransform() on every element of a document that has a transform attribute
+class TransformPerNodeBenchmark : public Benchmark
+{
+public:
+    TransformPerNodeBenchmark(const QString& name, const QString& text) : Benchmark(name, utf8Size(text)), text_(text) {}
+    void setUp() {
+	doc_.setContent(text_, false);
+	collect(doc_.documentElement());
+	setItems(elems_.size());
+    }
+    void run() {
+	for(int i = 0; i < elems_.size(); ++i) {
+	    sink += qint64(getTransform(elems_.at(i)).dx());
+	}
+    }
+    void tearDown() {
+	elems_.clear();
+	doc_.clear();
+    }
+private:
+    void collect(const QDomElement& elem) {
+	if(elem.hasAttribute("transform")) { elems_.append(elem); }
+	for(QDomElement child = elem.firstChildElement(); !child.isNull(); child = child.nextSiblingElement()) {
+	    collect(child);
+	}
+    }
+    QString text_;
+    QDomDocument doc_;
+    QList<QDomElement> elems_;
+};
+
+class ColorBenchmark : public Benchmark
+{
+public:
+    ColorBenchmark(const QString& name, const QString& color) : Benchmark(name, utf8Size(color)), color_(color) {}
+    void run() { sink += getRGBColorTrait(color_).color().rgba(); }
+private:
+    QString color_;
+};
+
+// reading the presentation attributes of one element, by literal name or by atom
+class TraitLookupBenchmark : public Benchmark
+{
+public:
+    TraitLookupBenchmark(const QString& name, bool bAtoms) : Benchmark(name), bAtoms_(bAtoms) {}
+    void setUp() {
+	doc_.setContent(QString("<path id='p' fill='red' stroke='blue' stroke-width='2' fill-opacity='0.5' d='M0,0 L10,10'/>"), false);
+	elem_ = doc_.documentElement();
+    }
+    void run() {
+	if(bAtoms_) {
+	    sink += getTrait(elem_, AtomFill).size() + getTrait(elem_, AtomStroke).size()
+		    + qint64(getFloatTrait(elem_, AtomStrokeWidth)) + qint64(getFloatTrait(elem_, AtomFillOpacity) * 10);
+	}
+	else {
+	    sink += getTrait(elem_, "fill").size() + getTrait(elem_, "stroke").size()
+		    + qint64(getFloatTrait(elem_, "stroke-width")) + qint64(getFloatTrait(elem_, "fill-opacity") * 10);
+	}
+    }
+    void tearDown() { doc_.clear(); }
+private:
+    bool bAtoms_;
+    QDomDocument doc_;
+    QDomElement elem_;
+};
+
+// a mix of the forms found in real documents, reported per color
+class StyleBenchmark : public Benchmark
+{
+public:
+    StyleBenchmark(const QString& name, const QString& style) : Benchmark(name, utf8Size(style)), style_(style) {}
+    void run() {
+	CarveStyleBlock* block = CarveStyleBlock::parse(style_);
+	sink += block ? block->has(StyleFill) : 0;
+	delete block;
+    }
+private:
+    QString style_;
+};
+
+class ColorMixBenchmark : public Benchmark
+{
+public:
+    ColorMixBenchmark(const QString& name) : Benchmark(name) {
+	colors_ << "#ff8800" << "#f80" << "black" << "white" << "cornflowerblue" << "lightgoldenrodyellow"
+		<< "rgb(10,20,30)" << "rgb(10%, 20%, 30%)" << "rgba(255,0,0,0.5)" << "#336699";
+	setItems(colors_.size());
+    }
+    void run() {
+	for(int i = 0; i < colors_.size(); ++i) {
+	    sink += getRGBColorTrait(colors_.at(i)).color().rgba();
+	}
+    }
+private:
+    QStringList colors_;
+};
+
+class ElementByIdBenchmark : public Benchmark
+{
+public:
+    ElementByIdBenchmark(const QString& name, const QString& text, const QString& id) :
+	    Benchmark(name), text_(text), id_(id) {}
+    void setUp() { doc_.setContent(text_, false); }
+    void run() { sink += getElementById(doc_.documentElement(), id_).isNull() ? 0 : 1; }
+    void tearDown() { doc_.clear(); }
+private:
+    QString text_;
+    QString id_;
+    QDomDocument doc_;
+};
+
+class GradientChainBenchmark : public Benchmark
+{
+public:
+    GradientChainBenchmark(const QString& name, const QString& text, const QString& id) :
+	    Benchmark(name), text_(text), id_(id) {}
+    void setUp() {
+	doc_.setContent(text_, false);
+	elem_ = getElementById(doc_.documentElement(), id_);
+    }
+    void run() { sink += resolveLinearGradient(elem_, 1.0).stops().size(); }
+    void tearDown() { doc_.clear(); }
+private:
+    QString text_;
+    QString id_;
+    QDomDocument doc_;
+    QDomElement elem_;
+};
+
+// parsing the text into the DOM (setContent only creates the root of the model)
+class SetContentBenchmark : public Benchmark
+{
+public:
+    SetContentBenchmark(const QString& name, const QString& text, CarveSVGDocument* document) :
+	    Benchmark(name, utf8Size(text)), text_(text), document_(document) {}
+    void run() { sink += document_->setContent(text_) ? 1 : 0; }
+private:
+    QString text_;
+    CarveSVGDocument* document_;
+};
+
+// parsing the text into Carve's own document store instead of the DOM
+class StoreParseBenchmark : public Benchmark
+{
+public:
+    StoreParseBenchmark(const QString& name, const QString& text) :
+	    Benchmark(name, utf8Size(text)), text_(text) {}
+    void run() { sink += store_.setContent(text_) ? store_.nodeCount() : 0; }
+    void tearDown() { store_.clear(); }
+private:
+    QString text_;
+    CarveDocumentStore store_;
+};
+
+// writing the store out after one attribute of the last element has changed
+class StoreSerializeBenchmark : public Benchmark
+{
+public:
+    StoreSerializeBenchmark(const QString& name, const QString& text) :
+	    Benchmark(name, utf8Size(text)), text_(text) {}
+    void setUp() {
+	store_.setContent(text_);
+	int last = store_.documentElement();
+	for(int node = 0; node < store_.nodeCount(); ++node) {
+	    if(store_.isElement(node)) { last = node; }
+	}
+	store_.setAttribute(last, AtomId, "changed");
+    }
+    void run() { sink += store_.toString().size(); }
+    void tearDown() { store_.clear(); }
+private:
+    QString text_;
+    CarveDocumentStore store_;
+};
+
+// reading a points list into coordinates: split into strings and converted one
+// by one as the polyline elements used to (which misreads the compact "1-2"
+// pairs), or scanned in place by parsePoints()
+class PointsParseBenchmark : public Benchmark
+{
+public:
+    PointsParseBenchmark(const QString& name, const QString& points, bool bSplit) :
+	    Benchmark(name, utf8Size(points)), points_(points), bSplit_(bSplit) {}
+    void run() {
+	if(!bSplit_) {
+	    sink += parsePoints(points_).size();
+	    return;
+	}
+	QStringList coords(points_.split(QRegExp("(\\s*\\,\\s*)|\\s+")));
+	QPolygonF polygon;
+	for(int i = 0; i + 1 < coords.size(); i += 2) {
+	    polygon << QPointF(coords.at(i).toDouble(), coords.at(i + 1).toDouble());
+	}
+	sink += polygon.size();
+    }
+private:
+    QString points_;
+    bool bSplit_;
+};
+
+// ranking the vertices of a long polyline and building its display levels
+class PathLevelsBenchmark : public Benchmark
+{
+public:
+    PathLevelsBenchmark(const QString& name, const QString& points) :
+	    Benchmark(name, utf8Size(points)), points_(parsePoints(points)) {}
+    void run() {
+	CarvePathLevels levels(points_, false, Qt::WindingFill);
+	sink += levels.elementCount();
+    }
+private:
+    QPolygonF points_;
+};
+
+// decoding an .svgz as CarveSVGWindow::load() does, inflating as the text stream reads
+class GzipReadBenchmark : public Benchmark
+{
+public:
+    GzipReadBenchmark(const QString& name, const QString& text) :
+	    Benchmark(name, utf8Size(text)), text_(text) {}
+    void setUp() {
+	QBuffer buffer(&compressed_);
+	buffer.open(QIODevice::WriteOnly);
+	CarveGzipDevice gzip(&buffer);
+	gzip.open(QIODevice::WriteOnly);
+	gzip.write(text_.toUtf8());
+    }
+    void run() {
+	QBuffer buffer(&compressed_);
+	buffer.open(QIODevice::ReadOnly);
+	CarveGzipDevice gzip(&buffer);
+	gzip.open(QIODevice::ReadOnly | QIODevice::Text);
+	QTextStream in(&gzip);
+	in.setCodec("UTF-8");
+	sink += in.readAll().size();
+    }
+    void tearDown() { compressed_.clear(); }
+private:
+    QString text_;
+    QByteArray compressed_;
+};
+
+// compressing the encoded text as saving an .svgz does
+class GzipWriteBenchmark : public Benchmark
+{
+public:
+    GzipWriteBenchmark(const QString& name, const QString& text) :
+	    Benchmark(name, utf8Size(text)), bytes_(text.toUtf8()) {}
+    void run() {
+	QByteArray compressed;
+	QBuffer buffer(&compressed);
+	buffer.open(QIODevice::WriteOnly);
+	CarveGzipDevice gzip(&buffer);
+	gzip.open(QIODevice::WriteOnly);
+	gzip.write(bytes_);
+	gzip.close();
+	sink += compressed.size();
+    }
+private:
+    QByteArray bytes_;
+};
+
+// writing the document out after the Properties pane has changed the last element's fill:
+// the whole DOM reformatted, or the source with only the edited element rewritten
+class SerializeBenchmark : public Benchmark
+{
+public:
+    SerializeBenchmark(const QString& name, const QString& text, CarveSVGDocument* document, bool bDom) :
+	    Benchmark(name, utf8Size(text)), text_(text), document_(document), bDom_(bDom) {}
+    void setUp() {
+	document_->setContent(text_);
+	CarveSVGNode* node = document_->root()->child(0);
+	while(node && node->numChildren() > 0) {
+	    node = node->child(node->numChildren() - 1);
+	}
+	if(node) { node->setTrait("fill", "#123456"); }
+    }
+    void run() {
+	if(bDom_) { sink += document_->domDocument()->toString(2).size(); }
+	else { sink += document_->serialize().size(); }
+    }
+private:
+    QString text_;
+    CarveSVGDocument* document_;
+    bool bDom_;
+};
+
+// what the editor does after a change: re-parse, clear the scene and create the whole model
+// (cold: as the first time, with none of the outlines in the path cache yet)
+class RebuildBenchmark : public Benchmark
+{
+public:
+    RebuildBenchmark(const QString& name, const QString& text, CarveSVGDocument* document, bool bCold = false) :
+	    Benchmark(name, utf8Size(text)), text_(text), document_(document), bCold_(bCold) {}
+    void run() {
+	if(bCold_) { document_->pathCache()->clear(); }
+	document_->setContent(text_);
+	sink += buildModel(document_->root());
+	document_->realizeAll();
+    }
+private:
+    QString text_;
+    CarveSVGDocument* document_;
+    bool bCold_;
+};
+
+// creating the model without any graphics items, as the DOM Browser does when everything is expanded
+class BuildModelBenchmark : public Benchmark
+{
+public:
+    BuildModelBenchmark(const QString& name, const QString& text, CarveSVGDocument* document) :
+	    Benchmark(name, utf8Size(text)), text_(text), document_(document), nodes_(0) {}
+    void run() {
+	document_->setContent(text_);
+	nodes_ = buildModel(document_->root());
+	sink += nodes_;
+    }
+    // what the model of the last run holds, to compare node layouts by
+    void tearDown() {
+	fprintf(stderr, "  %d nodes, sizeof(CarveSVGNode) = %d, CarveGElement = %d, CarveRectElement = %d, CarvePathElement = %d\n",
+		nodes_, int(sizeof(CarveSVGNode)), int(sizeof(CarveGElement)), int(sizeof(CarveRectElement)), int(sizeof(CarvePathElement)));
+	CarveArena* arena = document_->arena();
+	fprintf(stderr, "  arena: %lld bytes used, %lld reserved\n", arena->bytesUsed(), arena->bytesReserved());
+    }
+private:
+    QString text_;
+    CarveSVGDocument* document_;
+    int nodes_;
+};
+
+// what opening a document in Design mode costs: only the items in a 100x100 view are created
+class RealizeVisibleBenchmark : public Benchmark
+{
+public:
+    RealizeVisibleBenchmark(const QString& name, const QString& text, CarveSVGDocument* document) :
+	    Benchmark(name, utf8Size(text)), text_(text), document_(document) {}
+    void run() {
+	document_->setContent(text_);
+	document_->realizeRect(QRectF(0, 0, 100, 100));
+    }
+private:
+    QString text_;
+    CarveSVGDocument* document_;
+};
+
+// what opening the DOM Browser costs: the root element is expanded and its first rows are shown
+class ModelFetchBenchmark : public Benchmark
+{
+public:
+    ModelFetchBenchmark(const QString& name, const QString& text, CarveSVGDocument* document) :
+	    Benchmark(name, utf8Size(text)), text_(text), document_(document) {}
+    void run() {
+	document_->setContent(text_);
+	QModelIndex root = document_->index(0, 0);
+	if(document_->canFetchMore(root)) { document_->fetchMore(root); }
+	int rows = document_->rowCount(root);
+	for(int i = 0; i < rows; ++i) {
+	    sink += document_->index(i, 0, root).isValid() ? 1 : 0;
+	}
+    }
+private:
+    QString text_;
+    CarveSVGDocument* document_;
+};
+
+// what selecting a shape in Design mode costs the DOM Browser: finding the row of the
+// last element of the document (the deepest one, for nested groups)
+class IndexForNodeBenchmark : public Benchmark
+{
+public:
+    IndexForNodeBenchmark(const QString& name, const QString& text, CarveSVGDocument* document) :
+	    Benchmark(name), text_(text), document_(document), node_(NULL) {}
+    void setUp() {
+	document_->setContent(text_);
+	node_ = document_->root()->child(0);
+	while(node_ && node_->numChildren() > 0) {
+	    node_ = node_->child(node_->numChildren() - 1);
+	}
+    }
+    void run() { sink += document_->indexForNode(node_).row(); }
+private:
+    QString text_;
+    CarveSVGDocument* document_;
+    CarveSVGNode* node_;
+};
+
+class HighlighterBenchmark : public Benchmark
+{
+public:
+    HighlighterBenchmark(const QString& name, const QString& text) :
+	    Benchmark(name, utf8Size(text)), text_(text), doc_(NULL), highlighter_(NULL) {}
+    void setUp() {
+	doc_ = new QTextDocument();
+	doc_->setPlainText(text_);
+	highlighter_ = new SVGHighlighter(doc_);
+    }
+    void run() { highlighter_->rehighlight(); }
+    void tearDown() {
+	delete highlighter_;
+	delete doc_;
+    }
+private:
+    QString text_;
+    QTextDocument* doc_;
+    SVGHighlighter* highlighter_;
+};
+
+void usage() {
+    fprintf(stderr, "usage: carvebench [--filter <substring>] [--output <file.json>] [--quick] [--list]\n");
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    // the scenes and the highlighter's QTextDocument need a QApplication, but not a display
+    QApplication app(argc, argv, false);
+
+    QString filter;
+    QString outputFile;
+    bool bQuick = false;
+    bool bList = false;
+    QStringList args = app.arguments();
+    for(int i = 1; i < args.size(); ++i) {
+	if(args.at(i) == "--filter" && i + 1 < args.size()) { filter = args.at(++i); }
+	else if(args.at(i) == "--output" && i + 1 < args.size()) { outputFile = args.at(++i); }
+	else if(args.at(i) == "--quick") { bQuick = true; }
+	else if(args.at(i) == "--list") { bList = true; }
+	else {
+	    usage();
+	    return 1;
+	}
+    }
+
+    // --quick shrinks the corpus for smoke runs; the full sizes are what gets tracked
+    const int scale = bQuick ? 10 : 1;
+    const QString deepGroups = generateDeepGroups(1000 / scale);
+    const QString manyPaths = generateManyPaths(100000 / scale);
+    const QString styledPaths = generateStyledPaths(100000 / scale, 200);
+    const QString manyUses = generateManyUses(50000 / scale, 16 * 1024);
+    const QString gradientChain = generateGradientChain(200 / scale, 16);
+    const QString longPathData = generateLongPathData(1024 * 1024 / scale);
+    const QString longPath = generateLongPath(1024 * 1024 / scale);
+    const QString pointList = generatePointList(100000 / scale);
+    const QString manyImages = generateManyImages(5000 / scale);
+    const QString tree = generateTree(1000000 / scale, 10);
+    const QString lastPathId = QString("p%1").arg(100000 / scale - 1);
+    const QString lastGradientId = QString("grad%1").arg(200 / scale - 1);
+
+    // a headless document: its items go into the scene of a plain CarveSceneBuilder
+    CarveSVGDocument* document = new CarveSVGDocument("<svg xmlns='http://www.w3.org/2000/svg'/>");
+
+    QList<Benchmark*> benchmarks;
+    benchmarks << new PathTraitBenchmark("getPathTrait/short", "M10,10 L90,10 L90,90 h-80 v-40 c0,-10 10,-20 20,-20 z")
+	       << new PathTraitBenchmark("getPathTrait/1MB", longPathData)
+	       << new TransformBenchmark("getTransform/translate", "translate(10,20)")
+	       << new TransformBenchmark("getTransform/list", "translate(10,20) rotate(45 5 5) scale(2,3) skewX(10) matrix(1,0,0,1,5,5)")
+	       << new TransformBenchmark("getTransform/exponents", "matrix(1.5e0,-2.5E-1,+.25e+1,1e0,-1.25e2,3.0e-2)")
+	       << new TransformPerNodeBenchmark("getTransform/deep-groups-per-node", deepGroups)
+	       << new ColorBenchmark("getRGBColorTrait/hex6", "#ff8800")
+	       << new ColorBenchmark("getRGBColorTrait/hex3", "#f80")
+	       << new ColorBenchmark("getRGBColorTrait/named", "cornflowerblue")
+	       << new ColorBenchmark("getRGBColorTrait/rgb", "rgb(10, 20, 30)")
+	       << new ColorBenchmark("getRGBColorTrait/rgb-percent", "rgb(10%, 20%, 30%)")
+	       << new ColorBenchmark("getRGBColorTrait/rgba", "rgba(255, 0, 0, 0.5)")
+	       << new ColorBenchmark("getRGBColorTrait/named-long", "lightgoldenrodyellow")
+	       << new ColorBenchmark("getRGBColorTrait/invalid", "notacolor")
+	       << new ColorMixBenchmark("getRGBColorTrait/mix-per-color")
+	       << new TraitLookupBenchmark("getTrait/literal-names", false)
+	       << new TraitLookupBenchmark("getTrait/atoms", true)
+	       << new StyleBenchmark("CarveStyleBlock::parse/short", "fill:#f80;stroke:none")
+	       << new StyleBenchmark("CarveStyleBlock::parse/inkscape",
+		      "opacity:1;fill:#ff8800;fill-opacity:0.5;fill-rule:evenodd;stroke:#000000;stroke-width:2.5;"
+		      "stroke-linecap:round;stroke-linejoin:miter;stroke-miterlimit:4;stroke-dasharray:none;stroke-opacity:1")
+	       << new StyleBenchmark("CarveStyleBlock::parse/important-comments",
+		      "fill: red !important; /* overridden */ fill: blue; font-family: 'Deja Vu', serif")
+	       << new ElementByIdBenchmark("getElementById/many-paths-last", manyPaths, lastPathId)
+	       << new ElementByIdBenchmark("getElementById/many-paths-missing", manyPaths, "nosuchid")
+	       << new GradientChainBenchmark("resolveLinearGradient/href-chain", gradientChain, lastGradientId)
+	       << new SetContentBenchmark("setContent/deep-groups", deepGroups, document)
+	       << new SetContentBenchmark("setContent/many-paths", manyPaths, document)
+	       << new SetContentBenchmark("setContent/styled-paths", styledPaths, document)
+	       << new SetContentBenchmark("setContent/many-uses", manyUses, document)
+	       << new SetContentBenchmark("setContent/gradient-chain", gradientChain, document)
+	       << new SetContentBenchmark("setContent/long-path", longPath, document)
+	       << new SetContentBenchmark("setContent/many-images", manyImages, document)
+	       << new StoreParseBenchmark("CarveDocumentStore::setContent/deep-groups", deepGroups)
+	       << new StoreParseBenchmark("CarveDocumentStore::setContent/many-paths", manyPaths)
+	       << new StoreParseBenchmark("CarveDocumentStore::setContent/long-path", longPath)
+	       << new StoreParseBenchmark("CarveDocumentStore::setContent/tree-1M", tree)
+	       << new StoreSerializeBenchmark("CarveDocumentStore::toString/many-paths", manyPaths)
+	       << new StoreSerializeBenchmark("CarveDocumentStore::toString/tree-1M", tree)
+	       << new PointsParseBenchmark("points/100k-split", pointList, true)
+	       << new PointsParseBenchmark("parsePoints/100k", pointList, false)
+	       << new PathLevelsBenchmark("CarvePathLevels/100k", pointList)
+	       << new GzipReadBenchmark("CarveGzipDevice::read/many-paths", manyPaths)
+	       << new GzipWriteBenchmark("CarveGzipDevice::write/many-paths", manyPaths)
+	       << new SerializeBenchmark("serialize/many-paths-dom", manyPaths, document, true)
+	       << new SerializeBenchmark("serialize/many-paths-edited", manyPaths, document, false)
+	       << new SerializeBenchmark("serialize/deep-groups-dom", deepGroups, document, true)
+	       << new SerializeBenchmark("serialize/deep-groups-edited", deepGroups, document, false)
+	       << new RebuildBenchmark("rebuild/deep-groups", deepGroups, document)
+	       << new RebuildBenchmark("rebuild/many-paths", manyPaths, document)
+	       << new RebuildBenchmark("rebuild/many-paths-cold", manyPaths, document, true)
+	       << new RebuildBenchmark("rebuild/styled-paths", styledPaths, document)
+	       << new RebuildBenchmark("rebuild/many-uses", manyUses, document)
+	       << new RebuildBenchmark("rebuild/gradient-chain", gradientChain, document)
+	       << new RebuildBenchmark("rebuild/long-path", longPath, document)
+	       << new RebuildBenchmark("rebuild/many-images", manyImages, document)
+	       << new BuildModelBenchmark("buildModel/many-paths", manyPaths, document)
+	       << new BuildModelBenchmark("buildModel/tree-1M", tree, document)
+	       << new RealizeVisibleBenchmark("realizeVisible/deep-groups", deepGroups, document)
+	       << new RealizeVisibleBenchmark("realizeVisible/many-paths", manyPaths, document)
+	       << new RealizeVisibleBenchmark("realizeVisible/many-uses", manyUses, document)
+	       << new RealizeVisibleBenchmark("realizeVisible/many-images", manyImages, document)
+	       << new ModelFetchBenchmark("fetchModel/deep-groups", deepGroups, document)
+	       << new ModelFetchBenchmark("fetchModel/many-paths", manyPaths, document)
+	       << new IndexForNodeBenchmark("indexForNode/deep-groups", deepGroups, document)
+	       << new IndexForNodeBenchmark("indexForNode/many-paths", manyPaths, document)
+	       << new HighlighterBenchmark("SVGHighlighter/many-paths", manyPaths)
+	       << new HighlighterBenchmark("SVGHighlighter/long-path", longPath);
+
+    BenchmarkRunner runner(bQuick ? 50 : 500, bQuick ? 1 : 5);
+    QList<BenchmarkResult> results;
+    for(int i = 0; i < benchmarks.size(); ++i) {
+	Benchmark* benchmark = benchmarks.at(i);
+	if(!filter.isEmpty() && !benchmark->name().contains(filter)) { continue; }
+	if(bList) {
+	    printf("%s\n", qPrintable(benchmark->name()));
+	    continue;
+	}
+	fprintf(stderr, "%s...\n", qPrintable(benchmark->name()));
+	results.append(runner.run(benchmark));
+    }
+    qDeleteAll(benchmarks);
+    delete document;
+
+    if(bList) { return 0; }
+
+    QString json = BenchmarkRunner::toJson(results);
+    if(outputFile.isEmpty()) {
+	printf("%s", json.toUtf8().constData());
+    }
+    else {
+	QFile file(outputFile);
+	if(!file.open(QFile::WriteOnly | QFile::Text)) {
+	    fprintf(stderr, "Cannot write %s\n", qPrintable(outputFile));
+	    return 1;
+	}
+	QTextStream out(&file);
+	out.setCodec("UTF-8");
+	out << json;
+    }
+    return 0;
+}
@@ -0,0 +1,184 @@
+#include "svggenerator.h"
+
+namespace {
+
+QString header() {
+    return QString("<svg xmlns='http://www.w3.org/2000/svg' xmlns:xlink='http://www.w3.org/1999/xlink'\n"
+		   "     version='1.2' baseProfile='tiny' width='1000' height='1000'>\n");
+}
+
+QString footer() {
+    return QString("</svg>\n");
+}
+
+const char* const COLORS[] = { "red", "#00f", "#33cc99", "rgb(10,20,30)", "cornflowerblue", "rgb(50%,25%,0%)", "none" };
+const int NUM_COLORS = sizeof(COLORS) / sizeof(COLORS[0]);
+
+}
+
+QString generateDeepGroups(int depth) {
+    QString text(header());
+    for(int i = 0; i < depth; ++i) {
+	text += QString("<g id='g%1' transform='translate(1,1) rotate(%2)' fill='%3'>\n")
+		.arg(i).arg(i % 360).arg(COLORS[i % NUM_COLORS]);
+	text += QString("<rect x='%1' y='%1' width='10' height='10'/>\n").arg(i % 1000);
+    }
+    for(int i = 0; i < depth; ++i) {
+	text += "</g>\n";
+    }
+    text += footer();
+    return text;
+}
+
+namespace {
+
+// writes the subtree of the element numbered n in breadth-first order: its children are n*fanout+1...
+void writeTreeElement(QString& text, int n, int count, int fanout, int depth) {
+    QString indent(depth, ' ');
+    int first = n * fanout + 1;
+    if(first >= count) {
+	text += indent + QString("<rect id='e%1' x='%2' y='%3' width='5' height='5' fill='%4'/>\n")
+		.arg(n).arg((n * 37) % 1000).arg((n * 91) % 1000).arg(COLORS[n % NUM_COLORS]);
+	return;
+    }
+    text += indent + QString("<g id='e%1'>\n").arg(n);
+    for(int child = first; child < first + fanout && child < count; ++child) {
+	writeTreeElement(text, child, count, fanout, depth + 1);
+    }
+    text += indent + "</g>\n";
+}
+
+}
+
+QString generateTree(int count, int fanout) {
+    QString text(header());
+    text.reserve(count * 80);
+    if(count > 0) {
+	writeTreeElement(text, 0, count, fanout, 1);
+    }
+    text += footer();
+    return text;
+}
+
+QString generateManyPaths(int count) {
+    QString text(header());
+    text.reserve(count * 120);
+    for(int i = 0; i < count; ++i) {
+	int x = (i * 37) % 1000;
+	int y = (i * 91) % 1000;
+	text += QString("<path id='p%1' fill='%2' stroke='%3' stroke-width='%4' d='M%5,%6 L%7,%6 l0,10 h-5 v-5 z'/>\n")
+		.arg(i).arg(COLORS[i % NUM_COLORS]).arg(COLORS[(i + 3) % NUM_COLORS]).arg(1 + i % 4)
+		.arg(x).arg(y).arg(x + 10);
+    }
+    text += footer();
+    return text;
+}
+
+QString generateStyledPaths(int count, int numClasses) {
+    QString text(header());
+    text.reserve(count * 100 + numClasses * 60);
+    text += "<defs><style type='text/css'><![CDATA[\n";
+    for(int c = 0; c < numClasses; ++c) {
+	text += QString(".cls-%1{fill:%2;stroke:%3;stroke-width:%4}\n")
+		.arg(c).arg(COLORS[c % NUM_COLORS]).arg(COLORS[(c + 3) % NUM_COLORS]).arg(1 + c % 4);
+    }
+    text += "path{stroke-linejoin:round}\n#p0{fill:red !important}\ng.layer > path.cls-0{stroke-opacity:0.5}\n";
+    text += "]]></style></defs>\n<g class='layer'>\n";
+    for(int i = 0; i < count; ++i) {
+	int x = (i * 37) % 1000;
+	int y = (i * 91) % 1000;
+	text += QString("<path id='p%1' class='cls-%2' d='M%3,%4 L%5,%4 l0,10 h-5 v-5 z'/>\n")
+		.arg(i).arg(i % numClasses).arg(x).arg(y).arg(x + 10);
+    }
+    text += "</g>\n";
+    text += footer();
+    return text;
+}
+
+QString generateManyUses(int count, int symbolBytes) {
+    QString text(header());
+    text.reserve(count * 80 + symbolBytes + 256);
+    text += "<defs><symbol id='sym'>\n";
+    text += QString("<path fill='#33cc99' d='%1'/>\n").arg(generateLongPathData(symbolBytes));
+    text += "<circle cx='5' cy='5' r='4' stroke='black'/>\n";
+    text += "</symbol></defs>\n";
+    for(int i = 0; i < count; ++i) {
+	text += QString("<use xlink:href='#sym' x='%1' y='%2' fill='%3'/>\n")
+		.arg((i * 37) % 1000).arg((i * 91) % 1000).arg(COLORS[i % (NUM_COLORS - 1)]);
+    }
+    text += footer();
+    return text;
+}
+
+QString generateGradientChain(int chainLength, int stopsPerGradient) {
+    QString text(header());
+    text += "<defs>\n";
+    for(int i = 0; i < chainLength; ++i) {
+	text += QString("<linearGradient id='grad%1'").arg(i);
+	if(i > 0) {
+	    text += QString(" xlink:href='#grad%1'").arg(i - 1);
+	}
+	text += QString(" x1='0' y1='0' x2='%1' y2='1'>\n").arg((i % 10) / 10.0);
+	for(int s = 0; s < stopsPerGradient; ++s) {
+	    text += QString("<stop offset='%1' stop-color='%2'/>\n")
+		    .arg(qreal(s) / stopsPerGradient).arg(COLORS[(i + s) % (NUM_COLORS - 1)]);
+	}
+	text += "</linearGradient>\n";
+    }
+    text += "</defs>\n";
+    text += QString("<rect width='100' height='100' fill='url(#grad%1)'/>\n").arg(chainLength - 1);
+    text += footer();
+    return text;
+}
+
+QString generatePointList(int count) {
+    QString points;
+    points.reserve(count * 16);
+    for(int i = 0; i < count; ++i) {
+	switch(i % 4) {
+	    case 0: points += QString("%1,%2 ").arg(i % 997).arg((i * 7) % 991); break;
+	    case 1: points += QString("%1.5 %2.25 ").arg(i % 613).arg((i * 3) % 577); break;
+	    case 2: points += QString("%1-%2 ").arg(i % 101).arg(i % 89); break;
+	    default: points += QString("%1e-1,%2E2 ").arg(i % 1009).arg(i % 7); break;
+	}
+    }
+    return points.trimmed();
+}
+
+QString generateLongPathData(int bytes) {
+    QString d;
+    d.reserve(bytes + 64);
+    d += "M0,0";
+    int i = 0;
+    while(d.size() < bytes) {
+	switch(i % 4) {
+	    case 0: d += QString(" L%1,%2").arg(i % 997).arg((i * 7) % 991); break;
+	    case 1: d += QString(" l%1,-%2").arg(i % 13).arg(i % 11); break;
+	    case 2: d += QString(" C%1,%2 %3,%4 %5,%6").arg(i % 500).arg(i % 400).arg(i % 300)
+			 .arg(i % 200).arg(i % 100).arg(i % 50); break;
+	    default: d += QString(" h%1 v%2").arg(i % 17).arg(i % 19); break;
+	}
+	++i;
+    }
+    d += " z";
+    return d;
+}
+
+QString generateLongPath(int bytes) {
+    QString text(header());
+    text += "<path fill='none' stroke='black' d='";
+    text += generateLongPathData(bytes);
+    text += "'/>\n";
+    text += footer();
+    return text;
+}
+
+QString generateManyImages(int count) {
+    QString text(header());
+    for(int i = 0; i < count; ++i) {
+	text += QString("<image x='%1' y='%2' width='16' height='16' xlink:href='missing/image%3.png'/>\n")
+		.arg((i * 16) % 1000).arg(((i * 16) / 1000) * 16 % 1000).arg(i);
+    }
+    text += footer();
+    return text;
+}
@@ -0,0 +1,45 @@
+#ifndef SVGGENERATOR_H
+#define SVGGENERATOR_H
+
+#include <QString>
+
+// Synthetic documents for the benchmarks.  Each generator is deterministic so
+// that results from different runs and machines can be compared.
+
+// <g> elements nested depth levels deep with a transform and a rect at each level
+QString generateDeepGroups(int depth);
+
+// a flat list of count <path> elements with fills, strokes and short path data
+QString generateManyPaths(int count);
+
+// count <path> elements styled through a <style> sheet of numClasses class
+// rules (plus a few id, tag and descendant rules), the way design tools export
+QString generateStyledPaths(int count, int numClasses);
+
+// a <symbol> holding a path with roughly symbolBytes of path data and a
+// circle, placed count times with <use>
+QString generateManyUses(int count, int symbolBytes);
+
+// chainLength linear gradients each referencing the previous one through
+// xlink:href, every gradient carrying stopsPerGradient stops
+QString generateGradientChain(int chainLength, int stopsPerGradient);
+
+// the path data for a single path that is at least bytes characters long
+QString generateLongPathData(int bytes);
+
+// a points list of count coordinate pairs, mixing comma and space separators,
+// the compact "1-2" form and numbers with exponents
+QString generatePointList(int count);
+
+// a single <path> whose d attribute is at least bytes characters long
+QString generateLongPath(int bytes);
+
+// count elements in a tree of <g> elements with fanout children each and
+// <rect> leaves, indented the way editors save it (so every element is
+// surrounded by whitespace text nodes)
+QString generateTree(int count, int fanout);
+
+// count <image> elements (the referenced files do not exist)
+QString generateManyImages(int count);
+
+#endif // SVGGENERATOR_H
@@ -0,0 +1,13 @@
+# include() this from a project one directory below the top level to link libcarve
+QT += xml
+INCLUDEPATH += $$PWD/../src
+DEPENDPATH += $$PWD/../src
+CARVE_LIB_DIR = $$OUT_PWD/../libcarve
+win32 {
+    CONFIG(debug, debug|release): CARVE_LIB_DIR = $$CARVE_LIB_DIR/debug
+    else: CARVE_LIB_DIR = $$CARVE_LIB_DIR/release
+}
+LIBS += -L$$CARVE_LIB_DIR -lcarve
+unix: LIBS += -lz
+win32-msvc*: PRE_TARGETDEPS += $$CARVE_LIB_DIR/carve.lib
+else: PRE_TARGETDEPS += $$CARVE_LIB_DIR/libcarve.a
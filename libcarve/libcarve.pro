@@ -0,0 +1,83 @@
+# -------------------------------------------------
+# libcarve: the document model, parsers, style resolution and scene building,
+# with no dependency on any widget or on a display.  Building a scene still
+# needs a QApplication in Qt 4 (QGraphicsScene registers with it, and <text>
+# needs its font metrics), though QApplication(argc, argv, false) will do.
+# Linked by the application and the benchmarks.
+# -------------------------------------------------
+QT += xml
+TARGET = carve
+TEMPLATE = lib
+CONFIG += staticlib
+SRC = ../src
+INCLUDEPATH += $$SRC
+# zlib, for .svgz: the system's, or on Windows the copy built into QtCore
+win32: INCLUDEPATH += $$[QT_INSTALL_PREFIX]/src/3rdparty/zlib
+SOURCES += $$SRC/carvesvgdocument.cpp \
+    $$SRC/carvesvgnode.cpp \
+    $$SRC/carvescenebuilder.cpp \
+    $$SRC/domhelper.cpp \
+    $$SRC/carveparse.cpp \
+    $$SRC/carvecolor.cpp \
+    $$SRC/carvestyle.cpp \
+    $$SRC/carvestylesheet.cpp \
+    $$SRC/svghighlighter.cpp \
+    $$SRC/carvesvgelement.cpp \
+    $$SRC/carverectelement.cpp \
+    $$SRC/carvecircleelement.cpp \
+    $$SRC/carveellipseelement.cpp \
+    $$SRC/carvelineelement.cpp \
+    $$SRC/carvepolygonelement.cpp \
+    $$SRC/carvepolylineelement.cpp \
+    $$SRC/carvepathelement.cpp \
+    $$SRC/carvegelement.cpp \
+    $$SRC/carvetextelement.cpp \
+    $$SRC/carveaelement.cpp \
+    $$SRC/carveimageelement.cpp \
+    $$SRC/carveuseelement.cpp \
+    $$SRC/carveuseitem.cpp \
+    $$SRC/carvearena.cpp \
+    $$SRC/carveatoms.cpp \
+    $$SRC/carvedocumentstore.cpp \
+    $$SRC/carvefilewriter.cpp \
+    $$SRC/carvejournal.cpp \
+    $$SRC/carvegzipdevice.cpp \
+    $$SRC/carvepathcache.cpp \
+    $$SRC/carvepathitem.cpp \
+    $$SRC/carveimageitem.cpp \
+    $$SRC/profiler.cpp \
+    $$SRC/carvelog.cpp
+HEADERS += $$SRC/carvesvgdocument.h \
+    $$SRC/carvesvgnode.h \
+    $$SRC/carvescenebuilder.h \
+    $$SRC/domhelper.h \
+    $$SRC/carveparse.h \
+    $$SRC/carvecolor.h \
+    $$SRC/carvestyle.h \
+    $$SRC/carvestylesheet.h \
+    $$SRC/svghighlighter.h \
+    $$SRC/carvesvgelement.h \
+    $$SRC/carverectelement.h \
+    $$SRC/carvecircleelement.h \
+    $$SRC/carveellipseelement.h \
+    $$SRC/carvelineelement.h \
+    $$SRC/carvepolygonelement.h \
+    $$SRC/carvepolylineelement.h \
+    $$SRC/carvepathelement.h \
+    $$SRC/carvegelement.h \
+    $$SRC/carvetextelement.h \
+    $$SRC/carveaelement.h \
+    $$SRC/carveimageelement.h \
+    $$SRC/carveuseelement.h \
+    $$SRC/carveuseitem.h \
+    $$SRC/carvearena.h \
+    $$SRC/carveatoms.h \
+    $$SRC/carvedocumentstore.h \
+    $$SRC/carvefilewriter.h \
+    $$SRC/carvejournal.h \
+    $$SRC/carvegzipdevice.h \
+    $$SRC/carvepathcache.h \
+    $$SRC/carvepathitem.h \
+    $$SRC/carveimageitem.h \
+    $$SRC/profiler.h \
+    $$SRC/carvelog.h
@@ -18,25 +18,25 @@
 
 */
 #include "carveaelement.h"
+#include "carvesvgdocument.h"
+#include "carvescenebuilder.h"
 #include "domhelper.h"
-#include "carvegraphicsitems.h"
 
 #include <QDomNode>
 #include <QGraphicsRectItem>
 
-CarveAElement::CarveAElement(const QDomElement& node, int row, CarveSVGWindow* window, CarveSVGNode* parent) :
-	CarveSVGNode(node, row, window, svgA, parent)
+CarveAElement::CarveAElement(const QDomElement& node, int row, CarveSVGDocument* document, CarveSVGNode* parent) :
+	CarveSVGNode(node, row, document, svgA, parent)
 {
-    CarveGraphicsRectItem* a = new CarveGraphicsRectItem(window,0,0,0,0);
-    finishDecorating(a);
-    this->getFillOpacity();
-    this->getStrokeLineCap();
-    this->getStrokeLineJoin();
-    this->getStrokeOpacity();
-    this->getStrokeWidth();
-    a->setBrush(QBrush(QColor("transparent")));
-    a->setPen(QPen(QColor("transparent")));
 }
 
 CarveAElement::~CarveAElement() {
 }
+
+QGraphicsItem* CarveAElement::createItem() {
+    QGraphicsRectItem* a = this->document()->builder()->createRectItem(QRectF(0,0,0,0));
+    finishDecorating(a);
+    a->setBrush(QBrush(QColor("transparent")));
+    a->setPen(QPen(QColor("transparent")));
+    return a;
+}
@@ -25,8 +25,10 @@
 class CarveAElement : public CarveSVGNode
 {
 public:
-    CarveAElement(const QDomElement& node, int row, CarveSVGWindow* window, CarveSVGNode* parent = 0);
+    CarveAElement(const QDomElement& node, int row, CarveSVGDocument* document, CarveSVGNode* parent = 0);
     virtual ~CarveAElement();
+protected:
+    virtual QGraphicsItem* createItem();
 };
 
 #endif // CARVEAELEMENT_H
@@ -0,0 +1,91 @@
+#include "carvearena.h"
+
+#include <stdlib.h>
+
+namespace {
+
+// enough for doubles and pointers on every platform Carve builds on
+const size_t ALIGNMENT = 16;
+
+size_t aligned(size_t size) {
+    return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+char* allocateBlock(size_t size) {
+    void* block = malloc(size);
+    Q_CHECK_PTR(block);
+    return static_cast<char*>(block);
+}
+
+}
+
+CarveArena::CarveArena(int blockSize) :
+	blockSize_(int(aligned(blockSize))), current_(-1), pos_(NULL), end_(NULL),
+	largeBytes_(0), bytesUsed_(0)
+{
+    // a reserved QVector keeps its capacity when it is resized down, so the
+    // cleanup list is not reallocated for every generation
+    cleanups_.reserve(1024);
+}
+
+CarveArena::~CarveArena() {
+    reset();
+    for(int i = 0; i < blocks_.size(); ++i) {
+	free(blocks_.at(i));
+    }
+}
+
+void* CarveArena::allocate(size_t size) {
+    size = aligned(size);
+    bytesUsed_ += size;
+
+    if(size > size_t(blockSize_ / 4)) {
+	char* block = allocateBlock(size);
+	large_ << block;
+	largeBytes_ += size;
+	return block;
+    }
+
+    if(size_t(end_ - pos_) < size) {
+	// move on to the next block, reusing one kept from before the last reset if there is one
+	++current_;
+	if(current_ == blocks_.size()) {
+	    blocks_ << allocateBlock(blockSize_);
+	}
+	pos_ = blocks_.at(current_);
+	end_ = pos_ + blockSize_;
+    }
+
+    void* result = pos_;
+    pos_ += size;
+    return result;
+}
+
+void CarveArena::addCleanup(void* object, void (*cleanup)(void*)) {
+    Cleanup entry;
+    entry.object = object;
+    entry.cleanup = cleanup;
+    cleanups_ << entry;
+}
+
+void CarveArena::reset() {
+    // objects created later may refer to earlier ones, never the other way around
+    for(int i = cleanups_.size() - 1; i >= 0; --i) {
+	cleanups_.at(i).cleanup(cleanups_.at(i).object);
+    }
+    cleanups_.resize(0);
+
+    for(int i = 0; i < large_.size(); ++i) {
+	free(large_.at(i));
+    }
+    large_.resize(0);
+    largeBytes_ = 0;
+
+    current_ = -1;
+    pos_ = end_ = NULL;
+    bytesUsed_ = 0;
+}
+
+qint64 CarveArena::bytesReserved() const {
+    return qint64(blocks_.size()) * blockSize_ + largeBytes_;
+}
@@ -0,0 +1,67 @@
+#ifndef CARVEARENA_H
+#define CARVEARENA_H
+
+#include <QVector>
+#include <QtGlobal>
+#include <new>
+
+// Memory for objects that all die together, such as the nodes of one build
+// of a document's model.  Allocation bumps a pointer through large blocks;
+// reset() runs the destructors of everything created since the last reset
+// (newest first) and rewinds to the first block, so the next generation
+// reuses the same memory instead of going back to the allocator per object.
+class CarveArena
+{
+public:
+    explicit CarveArena(int blockSize = 64 * 1024);
+    ~CarveArena();
+
+    // size bytes, suitably aligned for any type, valid until reset()
+    void* allocate(size_t size);
+    // cleanup(object) is called at reset(), in reverse order of registration
+    void addCleanup(void* object, void (*cleanup)(void*));
+
+    template<class T> T* create() {
+	T* object = new(allocate(sizeof(T))) T();
+	addCleanup(object, &destroy<T>);
+	return object;
+    }
+    template<class T> T* create(const T& value) {
+	T* object = new(allocate(sizeof(T))) T(value);
+	addCleanup(object, &destroy<T>);
+	return object;
+    }
+
+    // destroys every object and makes all the memory available again
+    void reset();
+
+    // bytes handed out since the last reset, and the memory held for them
+    qint64 bytesUsed() const { return bytesUsed_; }
+    qint64 bytesReserved() const;
+
+private:
+    // unimplemented to prevent copying
+    CarveArena& operator=(const CarveArena&);
+    CarveArena(const CarveArena&);
+
+    template<class T> static void destroy(void* object) { static_cast<T*>(object)->~T(); }
+
+    struct Cleanup {
+	void* object;
+	void (*cleanup)(void*);
+    };
+
+    int blockSize_;
+    // the blocks are kept across resets; current_ is the one being filled
+    QVector<char*> blocks_;
+    int current_;
+    char* pos_;
+    char* end_;
+    // allocations too big to share a block get one of their own, freed at reset()
+    QVector<char*> large_;
+    qint64 largeBytes_;
+    QVector<Cleanup> cleanups_;
+    qint64 bytesUsed_;
+};
+
+#endif // CARVEARENA_H
@@ -0,0 +1,143 @@
+#include "carveatoms.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+
+namespace {
+
+// in the order of CarveAtom
+const char* const STATIC_ATOM_NAMES[NumStaticAtoms] = {
+    "",
+    "svg",
+    "g",
+    "rect",
+    "circle",
+    "ellipse",
+    "line",
+    "polyline",
+    "polygon",
+    "path",
+    "text",
+    "tspan",
+    "a",
+    "image",
+    "use",
+    "linearGradient",
+    "radialGradient",
+    "stop",
+    "defs",
+    "symbol",
+    "style",
+    "solidColor",
+    "title",
+    "desc",
+    "id",
+    "class",
+    "transform",
+    "x",
+    "y",
+    "width",
+    "height",
+    "rx",
+    "ry",
+    "cx",
+    "cy",
+    "r",
+    "fx",
+    "fy",
+    "x1",
+    "y1",
+    "x2",
+    "y2",
+    "points",
+    "d",
+    "fill",
+    "fill-opacity",
+    "fill-rule",
+    "stroke",
+    "stroke-opacity",
+    "stroke-width",
+    "stroke-linecap",
+    "stroke-linejoin",
+    "opacity",
+    "font-size",
+    "font-family",
+    "font-weight",
+    "offset",
+    "stop-color",
+    "stop-opacity",
+    "solid-color",
+    "viewBox",
+    "preserveAspectRatio",
+    "version",
+    "baseProfile",
+    "gradientUnits",
+    "gradientTransform",
+    "spreadMethod",
+    "xlink:href",
+    "xlink:title",
+    "type",
+    "#text",
+};
+
+// The static atoms never change after they are set up, so they are looked up
+// without locking; names interned later (unknown elements and attributes) go
+// into a second table behind a mutex, as documents may be read off the GUI thread.
+struct AtomTable {
+    QVector<QString> staticNames;
+    QHash<QString, int> staticAtoms;
+    // dynamic atom n is dynamicNames[n - NumStaticAtoms]
+    QVector<QString> dynamicNames;
+    QHash<QString, int> dynamicAtoms;
+    QMutex mutex;
+
+    AtomTable() {
+	staticNames.reserve(NumStaticAtoms);
+	for(int i = 0; i < NumStaticAtoms; ++i) {
+	    staticNames << QString::fromLatin1(STATIC_ATOM_NAMES[i]);
+	    if(i != AtomNone) { staticAtoms.insert(staticNames.last(), i); }
+	}
+    }
+};
+
+AtomTable& table() {
+    static AtomTable atomTable;
+    return atomTable;
+}
+
+}
+
+int CarveAtoms::intern(const QString& name) {
+    AtomTable& t = table();
+    int atom = t.staticAtoms.value(name, AtomNone);
+    if(atom != AtomNone || name.isEmpty()) { return atom; }
+
+    QMutexLocker locker(&t.mutex);
+    QHash<QString, int>::const_iterator it = t.dynamicAtoms.constFind(name);
+    if(it != t.dynamicAtoms.constEnd()) { return it.value(); }
+    atom = NumStaticAtoms + t.dynamicNames.size();
+    t.dynamicNames << name;
+    t.dynamicAtoms.insert(name, atom);
+    return atom;
+}
+
+int CarveAtoms::find(const QString& name) {
+    AtomTable& t = table();
+    int atom = t.staticAtoms.value(name, AtomNone);
+    if(atom != AtomNone) { return atom; }
+
+    QMutexLocker locker(&t.mutex);
+    return t.dynamicAtoms.value(name, AtomNone);
+}
+
+QString CarveAtoms::name(int atom) {
+    AtomTable& t = table();
+    if(atom < NumStaticAtoms) {
+	return atom >= 0 ? t.staticNames.at(atom) : QString();
+    }
+    QMutexLocker locker(&t.mutex);
+    int index = atom - NumStaticAtoms;
+    return index < t.dynamicNames.size() ? t.dynamicNames.at(index) : QString();
+}
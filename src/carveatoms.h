@@ -0,0 +1,41 @@
+#ifndef CARVEATOMS_H
+#define CARVEATOMS_H
+
+#include <QString>
+
+// Interned names of SVG elements and attributes.  The names Carve knows are
+// static atoms with fixed numbers, so code can switch on them and pass them
+// around as integers; any other name is given the next free number the first
+// time it is interned.  Atoms are only meaningful within one run of Carve.
+enum CarveAtom {
+    AtomNone,
+    // elements
+    AtomSvg, AtomG, AtomRect, AtomCircle, AtomEllipse, AtomLine, AtomPolyline, AtomPolygon,
+    AtomPath, AtomText, AtomTspan, AtomA, AtomImage, AtomUse, AtomLinearGradient,
+    AtomRadialGradient, AtomStop, AtomDefs, AtomSymbol, AtomStyle, AtomSolidColorElement,
+    AtomTitle, AtomDesc,
+    // attributes ("style" is shared with the element)
+    AtomId, AtomClass, AtomTransform, AtomX, AtomY, AtomWidth, AtomHeight, AtomRx, AtomRy, AtomCx,
+    AtomCy, AtomR, AtomFx, AtomFy, AtomX1, AtomY1, AtomX2, AtomY2, AtomPoints, AtomD, AtomFill,
+    AtomFillOpacity, AtomFillRule, AtomStroke, AtomStrokeOpacity, AtomStrokeWidth,
+    AtomStrokeLinecap, AtomStrokeLinejoin, AtomOpacity, AtomFontSize, AtomFontFamily,
+    AtomFontWeight, AtomOffset, AtomStopColor, AtomStopOpacity, AtomSolidColor, AtomViewBox,
+    AtomPreserveAspectRatio, AtomVersion, AtomBaseProfile, AtomGradientUnits, AtomGradientTransform,
+    AtomSpreadMethod, AtomXlinkHref, AtomXlinkTitle, AtomType,
+    // the text content of an element, as the Properties pane edits it
+    AtomTextContent,
+    NumStaticAtoms
+};
+
+class CarveAtoms
+{
+public:
+    // the atom of name, interning it if it has not been seen before
+    static int intern(const QString& name);
+    // the atom of name, or AtomNone if it has never been interned
+    static int find(const QString& name);
+    // the name of an atom (a shared copy, so passing it on allocates nothing)
+    static QString name(int atom);
+};
+
+#endif // CARVEATOMS_H
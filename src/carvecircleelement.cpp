@@ -19,49 +19,52 @@
 */
 #include "carvesvgnode.h"
 #include "carvecircleelement.h"
-#include "carvesvgwindow.h"
-#include "carvewindow.h"
-#include "carvescene.h"
+#include "carvesvgdocument.h"
+#include "carvescenebuilder.h"
 #include "domhelper.h"
-#include "carvegraphicsitems.h"
+#include "carveatoms.h"
 
 #include <QDomNode>
 #include <QGraphicsEllipseItem>
 #include <QBrush>
 #include <QPen>
 
-CarveCircleElement::CarveCircleElement(const QDomElement& element, int row, CarveSVGWindow* window, CarveSVGNode* parent) :
-	CarveSVGNode(element, row, window, svgCircle, parent)
+CarveCircleElement::CarveCircleElement(const QDomElement& element, int row, CarveSVGDocument* document, CarveSVGNode* parent) :
+	CarveSVGNode(element, row, document, svgCircle, parent)
 {
     bool bOk = false;
 
-    qreal cx = getFloatTrait(element, "cx",&bOk);
+    qreal cx = getFloatTrait(element, AtomCx,&bOk);
     if(!bOk) {
 	cx = 0.0;
     }
 
-    qreal cy = getFloatTrait(element, "cy",&bOk);
+    qreal cy = getFloatTrait(element, AtomCy,&bOk);
     if(!bOk) {
 	cy = 0.0;
     }
 
-    qreal radius = getFloatTrait(element, "r",&bOk);
+    qreal radius = getFloatTrait(element, AtomR,&bOk);
     if(!bOk) {
 	radius = 0.0;
     }
 
-    CarveGraphicsEllipseItem* item = new CarveGraphicsEllipseItem(window, cx-radius, cy-radius, radius*2, radius*2);
+    this->rect_ = QRectF(cx-radius, cy-radius, radius*2, radius*2);
+}
+
+CarveCircleElement::~CarveCircleElement() {
+}
+
+QRectF CarveCircleElement::geometryBounds() {
+    return strokedBounds(this->rect_);
+}
+
+QGraphicsItem* CarveCircleElement::createItem() {
+    QGraphicsEllipseItem* item = this->document()->builder()->createEllipseItem(this->rect_);
     finishDecorating(item);
 
     item->setData(0, qVariantFromValue(reinterpret_cast<void*>(this)));
-    this->getFillOpacity();
-    this->getStrokeLineCap();
-    this->getStrokeLineJoin();
-    this->getStrokeOpacity();
-    this->getStrokeWidth();
     item->setBrush(this->getFill());
     item->setPen(this->getStroke());
-}
-
-CarveCircleElement::~CarveCircleElement() {
+    return item;
 }
@@ -25,8 +25,14 @@
 class CarveCircleElement : public CarveSVGNode
 {
 public:
-    CarveCircleElement(const QDomElement& element, int row, CarveSVGWindow* window, CarveSVGNode* parent = 0);
+    CarveCircleElement(const QDomElement& element, int row, CarveSVGDocument* document, CarveSVGNode* parent = 0);
     virtual ~CarveCircleElement();
+protected:
+    virtual QGraphicsItem* createItem();
+    virtual QRectF geometryBounds();
+
+private:
+    QRectF rect_;
 };
 
 #endif // CARVECIRCLEELEMENT_H
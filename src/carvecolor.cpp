@@ -0,0 +1,437 @@
+#include "carvecolor.h"
+#include "carveparse.h"
+
+#include <QtGlobal>
+
+namespace {
+
+// ======================================================================
+// Named colors: a perfect hash over the SVG color keywords.  The bucket of
+// a name picks the seed that hashes it to its own slot in NAMED_COLORS
+// (generated offline, see hashName()).
+
+struct NamedColor {
+    const char* name;
+    QRgb rgba;
+};
+
+const int NAMED_COLOR_BUCKETS = 64;
+const int NAMED_COLOR_SLOTS = 256;
+// longest keyword is "lightgoldenrodyellow"
+const int MAX_NAMED_COLOR_LENGTH = 20;
+
+const quint32 NAMED_COLOR_SEEDS[NAMED_COLOR_BUCKETS] = {
+    0, 0, 0, 6, 1, 2, 1, 0,
+    2, 1, 2, 0, 2, 1, 2, 2,
+    4, 1, 3, 2, 2, 3, 1, 2,
+    4, 2, 1, 0, 2, 1, 1, 3,
+    3, 0, 1, 0, 4, 0, 1, 2,
+    1, 2, 1, 1, 1, 5, 1, 1,
+    5, 3, 5, 3, 8, 1, 1, 3,
+    0, 5, 1, 1, 1, 5, 1, 14
+};
+
+const NamedColor NAMED_COLORS[NAMED_COLOR_SLOTS] = {
+    { "mediumpurple", 0xff9370db },
+    { "aquamarine", 0xff7fffd4 },
+    { 0, 0 },
+    { "darkgrey", 0xffa9a9a9 },
+    { "whitesmoke", 0xfff5f5f5 },
+    { "lightgoldenrodyellow", 0xfffafad2 },
+    { "lightcoral", 0xfff08080 },
+    { 0, 0 },
+    { "linen", 0xfffaf0e6 },
+    { "mediumturquoise", 0xff48d1cc },
+    { "goldenrod", 0xffdaa520 },
+    { "coral", 0xffff7f50 },
+    { 0, 0 },
+    { "fuchsia", 0xffff00ff },
+    { "thistle", 0xffd8bfd8 },
+    { 0, 0 },
+    { "darkseagreen", 0xff8fbc8f },
+    { 0, 0 },
+    { 0, 0 },
+    { "lightsteelblue", 0xffb0c4de },
+    { "darkblue", 0xff00008b },
+    { 0, 0 },
+    { "darkred", 0xff8b0000 },
+    { 0, 0 },
+    { "blueviolet", 0xff8a2be2 },
+    { "purple", 0xff800080 },
+    { 0, 0 },
+    { "lightsalmon", 0xffffa07a },
+    { "wheat", 0xfff5deb3 },
+    { "lime", 0xff00ff00 },
+    { "palevioletred", 0xffdb7093 },
+    { 0, 0 },
+    { 0, 0 },
+    { "lemonchiffon", 0xfffffacd },
+    { "khaki", 0xfff0e68c },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { "slategray", 0xff708090 },
+    { "darkturquoise", 0xff00ced1 },
+    { 0, 0 },
+    { "greenyellow", 0xffadff2f },
+    { "darksalmon", 0xffe9967a },
+    { "dimgrey", 0xff696969 },
+    { 0, 0 },
+    { "chocolate", 0xffd2691e },
+    { 0, 0 },
+    { "rosybrown", 0xffbc8f8f },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { "firebrick", 0xffb22222 },
+    { "olivedrab", 0xff6b8e23 },
+    { "dodgerblue", 0xff1e90ff },
+    { 0, 0 },
+    { "saddlebrown", 0xff8b4513 },
+    { "olive", 0xff808000 },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { "mediumaquamarine", 0xff66cdaa },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { "skyblue", 0xff87ceeb },
+    { "lightskyblue", 0xff87cefa },
+    { "indianred", 0xffcd5c5c },
+    { "palegoldenrod", 0xffeee8aa },
+    { 0, 0 },
+    { 0, 0 },
+    { "mediumseagreen", 0xff3cb371 },
+    { "bisque", 0xffffe4c4 },
+    { 0, 0 },
+    { "white", 0xffffffff },
+    { 0, 0 },
+    { "lavender", 0xffe6e6fa },
+    { 0, 0 },
+    { "turquoise", 0xff40e0d0 },
+    { "plum", 0xffdda0dd },
+    { "sandybrown", 0xfff4a460 },
+    { "ghostwhite", 0xfff8f8ff },
+    { 0, 0 },
+    { 0, 0 },
+    { "slategrey", 0xff708090 },
+    { "teal", 0xff008080 },
+    { 0, 0 },
+    { "lightcyan", 0xffe0ffff },
+    { "grey", 0xff808080 },
+    { "lightyellow", 0xffffffe0 },
+    { 0, 0 },
+    { "yellowgreen", 0xff9acd32 },
+    { "violet", 0xffee82ee },
+    { "paleturquoise", 0xffafeeee },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { "navy", 0xff000080 },
+    { "springgreen", 0xff00ff7f },
+    { 0, 0 },
+    { "gray", 0xff808080 },
+    { "pink", 0xffffc0cb },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { "ivory", 0xfffffff0 },
+    { 0, 0 },
+    { 0, 0 },
+    { "mediumblue", 0xff0000cd },
+    { 0, 0 },
+    { "cornflowerblue", 0xff6495ed },
+    { "seashell", 0xfffff5ee },
+    { 0, 0 },
+    { "moccasin", 0xffffe4b5 },
+    { "blanchedalmond", 0xffffebcd },
+    { "magenta", 0xffff00ff },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { "deeppink", 0xffff1493 },
+    { "slateblue", 0xff6a5acd },
+    { "beige", 0xfff5f5dc },
+    { "darkorchid", 0xff9932cc },
+    { "hotpink", 0xffff69b4 },
+    { "gold", 0xffffd700 },
+    { "palegreen", 0xff98fb98 },
+    { 0, 0 },
+    { "blue", 0xff0000ff },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { "darkolivegreen", 0xff556b2f },
+    { 0, 0 },
+    { "lightpink", 0xffffb6c1 },
+    { "darkcyan", 0xff008b8b },
+    { "brown", 0xffa52a2a },
+    { "azure", 0xfff0ffff },
+    { "mistyrose", 0xffffe4e1 },
+    { 0, 0 },
+    { "darkslategray", 0xff2f4f4f },
+    { "orangered", 0xffff4500 },
+    { 0, 0 },
+    { "darkviolet", 0xff9400d3 },
+    { "gainsboro", 0xffdcdcdc },
+    { 0, 0 },
+    { "indigo", 0xff4b0082 },
+    { "darkgreen", 0xff006400 },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { "black", 0xff000000 },
+    { "crimson", 0xffdc143c },
+    { "peachpuff", 0xffffdab9 },
+    { "royalblue", 0xff4169e1 },
+    { "seagreen", 0xff2e8b57 },
+    { "mediumspringgreen", 0xff00fa9a },
+    { "steelblue", 0xff4682b4 },
+    { "papayawhip", 0xffffefd5 },
+    { "transparent", 0x00000000 },
+    { "cadetblue", 0xff5f9ea0 },
+    { 0, 0 },
+    { "cornsilk", 0xfffff8dc },
+    { "mintcream", 0xfff5fffa },
+    { "mediumslateblue", 0xff7b68ee },
+    { "red", 0xffff0000 },
+    { "burlywood", 0xffdeb887 },
+    { "mediumorchid", 0xffba55d3 },
+    { "navajowhite", 0xffffdead },
+    { "darkorange", 0xffff8c00 },
+    { 0, 0 },
+    { "midnightblue", 0xff191970 },
+    { 0, 0 },
+    { "lavenderblush", 0xfffff0f5 },
+    { 0, 0 },
+    { 0, 0 },
+    { "lightslategray", 0xff778899 },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { "orange", 0xffffa500 },
+    { "darkmagenta", 0xff8b008b },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { "darkslategrey", 0xff2f4f4f },
+    { "yellow", 0xffffff00 },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { "antiquewhite", 0xfffaebd7 },
+    { "oldlace", 0xfffdf5e6 },
+    { 0, 0 },
+    { "chartreuse", 0xff7fff00 },
+    { "darkslateblue", 0xff483d8b },
+    { 0, 0 },
+    { 0, 0 },
+    { "lightslategrey", 0xff778899 },
+    { 0, 0 },
+    { 0, 0 },
+    { "cyan", 0xff00ffff },
+    { "honeydew", 0xfff0fff0 },
+    { "peru", 0xffcd853f },
+    { "darkkhaki", 0xffbdb76b },
+    { "lightgray", 0xffd3d3d3 },
+    { "salmon", 0xfffa8072 },
+    { 0, 0 },
+    { 0, 0 },
+    { "mediumvioletred", 0xffc71585 },
+    { "floralwhite", 0xfffffaf0 },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { "lightseagreen", 0xff20b2aa },
+    { "tomato", 0xffff6347 },
+    { 0, 0 },
+    { "deepskyblue", 0xff00bfff },
+    { 0, 0 },
+    { "powderblue", 0xffb0e0e6 },
+    { 0, 0 },
+    { 0, 0 },
+    { 0, 0 },
+    { "lawngreen", 0xff7cfc00 },
+    { 0, 0 },
+    { "snow", 0xfffffafa },
+    { "tan", 0xffd2b48c },
+    { "aliceblue", 0xfff0f8ff },
+    { "sienna", 0xffa0522d },
+    { "green", 0xff008000 },
+    { 0, 0 },
+    { "dimgray", 0xff696969 },
+    { "lightgrey", 0xffd3d3d3 },
+    { "silver", 0xffc0c0c0 },
+    { "lightblue", 0xffadd8e6 },
+    { "forestgreen", 0xff228b22 },
+    { "darkgoldenrod", 0xffb8860b },
+    { "darkgray", 0xffa9a9a9 },
+    { 0, 0 },
+    { "limegreen", 0xff32cd32 },
+    { 0, 0 },
+    { "lightgreen", 0xff90ee90 },
+    { "maroon", 0xff800000 },
+    { 0, 0 },
+    { "aqua", 0xff00ffff },
+    { "orchid", 0xffda70d6 }
+};
+
+// FNV-1a of the lower-cased name
+inline quint32 hashName(const char* name, int length, quint32 seed) {
+    quint32 h = 2166136261u ^ seed;
+    for(int i = 0; i < length; ++i) {
+	h ^= quint8(name[i]);
+	h *= 16777619u;
+    }
+    return h;
+}
+
+bool lookupNamedColor(const QChar* pos, const QChar* end, QRgb* rgba) {
+    int length = end - pos;
+    if(length < 3 || length > MAX_NAMED_COLOR_LENGTH) { return false; }
+
+    char name[MAX_NAMED_COLOR_LENGTH];
+    for(int i = 0; i < length; ++i) {
+	ushort c = pos[i].unicode();
+	if(c >= 'A' && c <= 'Z') { c += 'a' - 'A'; }
+	else if(c < 'a' || c > 'z') { return false; }
+	name[i] = char(c);
+    }
+
+    quint32 seed = NAMED_COLOR_SEEDS[hashName(name, length, 0) % NAMED_COLOR_BUCKETS];
+    const NamedColor& entry = NAMED_COLORS[hashName(name, length, seed) % NAMED_COLOR_SLOTS];
+    if(!entry.name) { return false; }
+    for(int i = 0; i < length; ++i) {
+	if(entry.name[i] != name[i]) { return false; }
+    }
+    if(entry.name[length] != '\0') { return false; }
+
+    *rgba = entry.rgba;
+    return true;
+}
+
+// ======================================================================
+// #rgb, #rgba, #rrggbb, #rrggbbaa
+
+inline int hexValue(ushort c) {
+    if(c >= '0' && c <= '9') { return c - '0'; }
+    if(c >= 'a' && c <= 'f') { return c - 'a' + 10; }
+    if(c >= 'A' && c <= 'F') { return c - 'A' + 10; }
+    return -1;
+}
+
+bool parseHexColor(const QChar* pos, const QChar* end, QRgb* rgba) {
+    int length = end - pos;
+    if(length != 3 && length != 4 && length != 6 && length != 8) { return false; }
+
+    int digits[8];
+    for(int i = 0; i < length; ++i) {
+	digits[i] = hexValue(pos[i].unicode());
+	if(digits[i] < 0) { return false; }
+    }
+
+    if(length <= 4) {
+	int a = (length == 4) ? digits[3] * 17 : 255;
+	*rgba = qRgba(digits[0] * 17, digits[1] * 17, digits[2] * 17, a);
+    }
+    else {
+	int a = (length == 8) ? digits[6] * 16 + digits[7] : 255;
+	*rgba = qRgba(digits[0] * 16 + digits[1], digits[2] * 16 + digits[3], digits[4] * 16 + digits[5], a);
+    }
+    return true;
+}
+
+// ======================================================================
+// rgb(r, g, b), rgba(r, g, b, a): components are integers or percentages,
+// alpha is a number in [0,1] or a percentage
+
+inline int clampComponent(double v) {
+    return v <= 0 ? 0 : (v >= 255 ? 255 : qRound(v));
+}
+
+bool parseComponent(const QChar*& pos, const QChar* end, double scale, int* value) {
+    double v;
+    if(!parseNumber(pos, end, &v)) { return false; }
+    if(pos < end && pos->unicode() == '%') {
+	++pos;
+	v = v * 255.0 / 100.0;
+    }
+    else {
+	v *= scale;
+    }
+    *value = clampComponent(v);
+    return true;
+}
+
+bool parseFunctionalColor(const QChar* pos, const QChar* end, QRgb* rgba) {
+    // the caller has already checked for "rgb"
+    pos += 3;
+    bool bAlpha = false;
+    if(pos < end && (pos->unicode() == 'a' || pos->unicode() == 'A')) {
+	bAlpha = true;
+	++pos;
+    }
+    skipWhitespace(pos, end);
+    if(pos >= end || pos->unicode() != '(') { return false; }
+    ++pos;
+
+    int c[4] = { 0, 0, 0, 255 };
+    int count = bAlpha ? 4 : 3;
+    for(int i = 0; i < count; ++i) {
+	skipWhitespace(pos, end);
+	// alpha is a 0..1 number, scaled to 0..255
+	if(!parseComponent(pos, end, i == 3 ? 255.0 : 1.0, &c[i])) { return false; }
+	skipWhitespace(pos, end);
+	if(i < count - 1) {
+	    if(pos >= end || pos->unicode() != ',') { return false; }
+	    ++pos;
+	}
+    }
+    if(pos >= end || pos->unicode() != ')') { return false; }
+    ++pos;
+    if(pos != end) { return false; }
+
+    *rgba = qRgba(c[0], c[1], c[2], c[3]);
+    return true;
+}
+
+inline bool startsWithRgb(const QChar* pos, const QChar* end) {
+    return end - pos >= 3
+	&& (pos[0].unicode() | 0x20) == 'r'
+	&& (pos[1].unicode() | 0x20) == 'g'
+	&& (pos[2].unicode() | 0x20) == 'b';
+}
+
+}
+
+bool parseColor(const QString& text, QRgb* rgba) {
+    const QChar* pos = text.constData();
+    const QChar* end = pos + text.size();
+    skipWhitespace(pos, end);
+    while(end > pos && isSVGWhitespace(*(end - 1))) { --end; }
+    if(pos == end) { return false; }
+
+    // no shared state, so documents can be styled on several threads at once
+    if(pos->unicode() == '#') {
+	return parseHexColor(pos + 1, end, rgba);
+    }
+    // no color keyword starts with "rgb"
+    if(startsWithRgb(pos, end)) {
+	return parseFunctionalColor(pos, end, rgba);
+    }
+    return lookupNamedColor(pos, end, rgba);
+}
@@ -0,0 +1,13 @@
+#ifndef CARVECOLOR_H
+#define CARVECOLOR_H
+
+#include <QString>
+#include <QColor>
+
+// Parses an SVG/CSS color: #rgb, #rrggbb (and the #rgba/#rrggbbaa forms),
+// the 147 SVG color keywords plus "transparent", and rgb()/rgba() with integer
+// or percentage components.  Out-of-range components are clamped.
+// Unlike QColor(QString) it never prints warnings.
+bool parseColor(const QString& text, QRgb* rgba);
+
+#endif // CARVECOLOR_H
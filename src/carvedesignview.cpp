@@ -24,14 +24,12 @@
 #include "carvesvgdocument.h"
 #include "carvesvgnode.h"
 #include "carvesvgelement.h"
+#include "profiler.h"
+#include "carvelog.h"
 
 #include <QMenu>
 #include <QAction>
 
-#include <iostream>
-using std::cout;
-using std::endl;
-
 CarveDesignView::CarveDesignView(CarveSVGWindow* window) : QGraphicsView(),
     window_(window)
 {
@@ -51,10 +49,17 @@ void CarveDesignView::resizeEvent(QResizeEvent* event) {
 	svg->update(this->width(), this->height());
     }
     else {
-	cout << "Error!  Could not get the <svg> element from the CarveSVGDocument" << endl;
+	CARVE_ERROR(LogUI, "Could not get the <svg> element from the document");
     }
 
     // after this point, the scene should have the proper size so we can scale the view properly
 
     QGraphicsView::resizeEvent(event);
 }
+
+void CarveDesignView::paintEvent(QPaintEvent* event) {
+    CARVE_PROFILE("paint");
+    // items are only created for what is (or comes) into view
+    this->window_->model()->realizeRect(this->mapToScene(this->viewport()->rect()).boundingRect());
+    QGraphicsView::paintEvent(event);
+}
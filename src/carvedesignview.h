@@ -35,6 +35,7 @@ public:
     QAction* deleteNode;
 protected:
     void resizeEvent(QResizeEvent* event);
+    void paintEvent(QPaintEvent* event);
 private:
     CarveSVGWindow* window_;
     QMenu* contextMenu_;
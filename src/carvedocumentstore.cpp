@@ -0,0 +1,624 @@
+#include "carvedocumentstore.h"
+#include "profiler.h"
+
+#include <QtAlgorithms>
+
+namespace {
+
+inline bool isXMLSpace(ushort c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline bool isNameChar(ushort c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+	    || c == '_' || c == ':' || c == '-' || c == '.' || c >= 0x80;
+}
+
+bool startsWith(const QChar* pos, const QChar* end, const char* s) {
+    for(; *s; ++s, ++pos) {
+	if(pos >= end || pos->unicode() != ushort(*s)) { return false; }
+    }
+    return true;
+}
+
+// the first occurrence of s in [pos, end), or end
+const QChar* findString(const QChar* pos, const QChar* end, const char* s) {
+    for(; pos < end; ++pos) {
+	if(pos->unicode() == ushort(*s) && startsWith(pos, end, s)) { return pos; }
+    }
+    return end;
+}
+
+// resolves character and predefined entity references; attribute values also
+// have their whitespace normalized, as an XML parser does
+QString decode(const QChar* begin, const QChar* end, bool bAttribute) {
+    const QChar* pos = begin;
+    while(pos < end && pos->unicode() != '&' && !(bAttribute && isXMLSpace(pos->unicode()) && pos->unicode() != ' ')) { ++pos; }
+    if(pos == end) { return QString(begin, end - begin); }
+
+    QString result(begin, pos - begin);
+    result.reserve(end - begin);
+    while(pos < end) {
+	ushort c = pos->unicode();
+	if(c == '&') {
+	    const QChar* semicolon = pos + 1;
+	    while(semicolon < end && semicolon->unicode() != ';' && semicolon - pos < 12) { ++semicolon; }
+	    if(semicolon < end && semicolon->unicode() == ';') {
+		QString name(pos + 1, semicolon - pos - 1);
+		uint code = 0;
+		bool bOk = true;
+		if(name == "amp") { code = '&'; }
+		else if(name == "lt") { code = '<'; }
+		else if(name == "gt") { code = '>'; }
+		else if(name == "quot") { code = '"'; }
+		else if(name == "apos") { code = '\''; }
+		else if(name.startsWith("#x")) { code = name.mid(2).toUInt(&bOk, 16); }
+		else if(name.startsWith('#')) { code = name.mid(1).toUInt(&bOk, 10); }
+		else { bOk = false; }
+
+		if(bOk && code > 0 && code <= 0x10ffff) {
+		    if(code >= 0x10000) {
+			result += QChar(QChar::highSurrogate(code));
+			result += QChar(QChar::lowSurrogate(code));
+		    }
+		    else {
+			result += QChar(ushort(code));
+		    }
+		    pos = semicolon + 1;
+		    continue;
+		}
+	    }
+	    // entities declared in a DTD are not expanded
+	    result += *pos++;
+	}
+	else if(bAttribute && isXMLSpace(c)) {
+	    // a CR LF line break counts once
+	    if(!(c == '\r' && pos + 1 < end && pos[1].unicode() == '\n')) { result += QChar(' '); }
+	    ++pos;
+	}
+	else {
+	    result += *pos++;
+	}
+    }
+    return result;
+}
+
+QString escape(const QString& value, bool bAttribute) {
+    QString result;
+    result.reserve(value.size());
+    for(int i = 0; i < value.size(); ++i) {
+	ushort c = value.at(i).unicode();
+	if(c == '&') { result += "&amp;"; }
+	else if(c == '<') { result += "&lt;"; }
+	else if(c == '>' && !bAttribute) { result += "&gt;"; }
+	else if(c == '"' && bAttribute) { result += "&quot;"; }
+	else if(bAttribute && (c == '\t' || c == '\n' || c == '\r')) { result += QString("&#%1;").arg(c); }
+	else { result += value.at(i); }
+    }
+    return result;
+}
+
+}
+
+CarveDocumentStore::CarveDocumentStore() :
+	bModified_(false), bInternalSubset_(false)
+{
+}
+
+void CarveDocumentStore::clear() {
+    source_.clear();
+    lineStarts_.clear();
+    kinds_.clear();
+    flags_.clear();
+    names_.clear();
+    parents_.clear();
+    firstChildren_.clear();
+    lastChildren_.clear();
+    nextSiblings_.clear();
+    begins_.clear();
+    ends_.clear();
+    tailBegins_.clear();
+    endTagBegins_.clear();
+    endTagEnds_.clear();
+    firstAttrs_.clear();
+    attrCounts_.clear();
+    attributes_.clear();
+    values_.clear();
+    ids_.clear();
+    childElements_.clear();
+    bModified_ = false;
+    bInternalSubset_ = false;
+}
+
+int CarveDocumentStore::addNode(NodeKind kind, int parent, int begin, int end) {
+    int node = kinds_.size();
+    kinds_ << quint8(kind);
+    flags_ << 0;
+    names_ << AtomNone;
+    parents_ << parent;
+    firstChildren_ << -1;
+    lastChildren_ << -1;
+    nextSiblings_ << -1;
+    begins_ << begin;
+    ends_ << end;
+    tailBegins_ << end;
+    endTagBegins_ << end;
+    endTagEnds_ << end;
+    firstAttrs_ << attributes_.size();
+    attrCounts_ << 0;
+
+    if(parent >= 0) {
+	int last = lastChildren_.at(parent);
+	if(last >= 0) { nextSiblings_[last] = node; }
+	else { firstChildren_[parent] = node; }
+	lastChildren_[parent] = node;
+    }
+    return node;
+}
+
+bool CarveDocumentStore::fail(const QString& message, int pos, QString* errorMsg, int* errorLine, int* errorColumn) {
+    int line = qUpperBound(lineStarts_.begin(), lineStarts_.end(), pos) - lineStarts_.begin();
+    if(errorMsg) { *errorMsg = message; }
+    if(errorLine) { *errorLine = line; }
+    if(errorColumn) { *errorColumn = pos - lineStarts_.at(line - 1) + 1; }
+    clear();
+    return false;
+}
+
+bool CarveDocumentStore::setContent(const QString& text, QString* errorMsg, int* errorLine, int* errorColumn) {
+    CARVE_PROFILE("CarveDocumentStore::setContent");
+    clear();
+    source_ = text;
+    const QChar* data = source_.constData();
+    const QChar* end = data + source_.size();
+
+    lineStarts_ << 0;
+    for(const QChar* pos = data; pos < end; ++pos) {
+	if(pos->unicode() == '\n') { lineStarts_ << int(pos - data) + 1; }
+    }
+
+    addNode(DocumentNode, -1, 0, source_.size());
+    int current = document();
+    bool bHaveRoot = false;
+    const QChar* pos = data;
+
+    while(pos < end) {
+	int begin = int(pos - data);
+
+	if(pos->unicode() != '<') {
+	    const QChar* stop = pos;
+	    while(stop < end && stop->unicode() != '<') { ++stop; }
+	    if(current == document()) {
+		for(const QChar* c = pos; c < stop; ++c) {
+		    if(!isXMLSpace(c->unicode())) { return fail("Extra content at the document level", int(c - data), errorMsg, errorLine, errorColumn); }
+		}
+	    }
+	    addNode(TextNode, current, begin, int(stop - data));
+	    pos = stop;
+	    continue;
+	}
+
+	if(startsWith(pos, end, "<!--")) {
+	    const QChar* close = findString(pos + 4, end, "-->");
+	    if(close == end) { return fail("Unterminated comment", begin, errorMsg, errorLine, errorColumn); }
+	    pos = close + 3;
+	    addNode(CommentNode, current, begin, int(pos - data));
+	    continue;
+	}
+
+	if(startsWith(pos, end, "<![CDATA[")) {
+	    const QChar* close = findString(pos + 9, end, "]]>");
+	    if(close == end || current == document()) { return fail("Unexpected CDATA section", begin, errorMsg, errorLine, errorColumn); }
+	    pos = close + 3;
+	    addNode(CDataNode, current, begin, int(pos - data));
+	    continue;
+	}
+
+	if(startsWith(pos, end, "<?")) {
+	    const QChar* close = findString(pos + 2, end, "?>");
+	    if(close == end) { return fail("Unterminated processing instruction", begin, errorMsg, errorLine, errorColumn); }
+	    pos = close + 2;
+	    addNode(ProcessingInstructionNode, current, begin, int(pos - data));
+	    continue;
+	}
+
+	if(startsWith(pos, end, "<!")) {
+	    if(current != document() || bHaveRoot) { return fail("Unexpected declaration", begin, errorMsg, errorLine, errorColumn); }
+	    // skip the internal subset and any quoted strings
+	    int depth = 0;
+	    for(pos += 2; pos < end; ++pos) {
+		ushort c = pos->unicode();
+		if(c == '"' || c == '\'') {
+		    for(++pos; pos < end && pos->unicode() != c; ++pos) {}
+		    if(pos >= end) { break; }
+		}
+		else if(c == '[') {
+		    ++depth;
+		    bInternalSubset_ = true;
+		}
+		else if(c == ']') { --depth; }
+		else if(c == '>' && depth <= 0) { break; }
+	    }
+	    if(pos >= end) { return fail("Unterminated document type declaration", begin, errorMsg, errorLine, errorColumn); }
+	    ++pos;
+	    addNode(DoctypeNode, current, begin, int(pos - data));
+	    continue;
+	}
+
+	if(startsWith(pos, end, "</")) {
+	    pos += 2;
+	    const QChar* name = pos;
+	    while(pos < end && isNameChar(pos->unicode())) { ++pos; }
+	    int nameLength = int(pos - name);
+	    while(pos < end && isXMLSpace(pos->unicode())) { ++pos; }
+	    if(pos >= end || pos->unicode() != '>') { return fail("Malformed end tag", begin, errorMsg, errorLine, errorColumn); }
+	    ++pos;
+	    if(current == document() || CarveAtoms::name(names_.at(current)) != QString::fromRawData(name, nameLength)) {
+		return fail("Opening and ending tag mismatch", begin, errorMsg, errorLine, errorColumn);
+	    }
+	    endTagBegins_[current] = begin;
+	    endTagEnds_[current] = int(pos - data);
+	    current = parents_.at(current);
+	    continue;
+	}
+
+	// a start tag
+	++pos;
+	const QChar* name = pos;
+	while(pos < end && isNameChar(pos->unicode())) { ++pos; }
+	if(pos == name) { return fail("Invalid element name", begin, errorMsg, errorLine, errorColumn); }
+	if(current == document()) {
+	    if(bHaveRoot) { return fail("Extra content at the document level", begin, errorMsg, errorLine, errorColumn); }
+	    bHaveRoot = true;
+	}
+	int node = addNode(ElementNode, current, begin, -1);
+	names_[node] = CarveAtoms::intern(QString(name, int(pos - name)));
+
+	const QChar* attrBegin = pos;
+	for(;;) {
+	    attrBegin = pos;
+	    while(pos < end && isXMLSpace(pos->unicode())) { ++pos; }
+	    if(pos >= end) { return fail("Unexpected end of document", int(pos - data), errorMsg, errorLine, errorColumn); }
+	    if(pos->unicode() == '>' || startsWith(pos, end, "/>")) { break; }
+	    if(pos == attrBegin) { return fail("Expected whitespace before an attribute", int(pos - data), errorMsg, errorLine, errorColumn); }
+
+	    const QChar* attrName = pos;
+	    while(pos < end && isNameChar(pos->unicode())) { ++pos; }
+	    int attrNameLength = int(pos - attrName);
+	    while(pos < end && isXMLSpace(pos->unicode())) { ++pos; }
+	    if(attrNameLength == 0 || pos >= end || pos->unicode() != '=') { return fail("Malformed attribute", int(attrName - data), errorMsg, errorLine, errorColumn); }
+	    ++pos;
+	    while(pos < end && isXMLSpace(pos->unicode())) { ++pos; }
+	    if(pos >= end || (pos->unicode() != '"' && pos->unicode() != '\'')) { return fail("Unquoted attribute value", int(pos - data), errorMsg, errorLine, errorColumn); }
+	    ushort quote = pos->unicode();
+	    const QChar* value = ++pos;
+	    while(pos < end && pos->unicode() != quote && pos->unicode() != '<') { ++pos; }
+	    if(pos >= end || pos->unicode() != quote) { return fail("Unterminated attribute value", int(value - data), errorMsg, errorLine, errorColumn); }
+	    ++pos;
+
+	    Attribute attribute;
+	    attribute.name = CarveAtoms::intern(QString(attrName, attrNameLength));
+	    attribute.value = decode(value, pos - 1, true);
+	    attribute.begin = int(attrBegin - data);
+	    attribute.end = int(pos - data);
+	    if(findAttribute(node, attribute.name) >= 0) { return fail("Duplicate attribute", int(attrName - data), errorMsg, errorLine, errorColumn); }
+	    attributes_ << attribute;
+	    ++attrCounts_[node];
+	}
+
+	tailBegins_[node] = int(attrBegin - data);
+	if(pos->unicode() == '/') {
+	    pos += 2;
+	    endTagBegins_[node] = endTagEnds_[node] = int(pos - data);
+	}
+	else {
+	    ++pos;
+	    current = node;
+	}
+	ends_[node] = int(pos - data);
+	indexId(node);
+    }
+
+    if(current != document()) { return fail("Unexpected end of document: element not closed", source_.size(), errorMsg, errorLine, errorColumn); }
+    if(!bHaveRoot) { return fail("No document element", source_.size(), errorMsg, errorLine, errorColumn); }
+    return true;
+}
+
+void CarveDocumentStore::indexId(int node) {
+    int index = findAttribute(node, AtomId);
+    if(index < 0) { return; }
+    const QString& id = attributes_.at(index).value;
+    if(!id.isEmpty() && !ids_.contains(id)) { ids_.insert(id, node); }
+}
+
+int CarveDocumentStore::documentElement() const {
+    return kinds_.isEmpty() ? -1 : firstChildElement(document());
+}
+
+int CarveDocumentStore::firstChildElement(int node) const {
+    int child = firstChildren_.at(node);
+    while(child >= 0 && kinds_.at(child) != ElementNode) { child = nextSiblings_.at(child); }
+    return child;
+}
+
+int CarveDocumentStore::nextSiblingElement(int node) const {
+    int sibling = nextSiblings_.at(node);
+    while(sibling >= 0 && kinds_.at(sibling) != ElementNode) { sibling = nextSiblings_.at(sibling); }
+    return sibling;
+}
+
+int CarveDocumentStore::childElement(int node, int row) const {
+    QHash<int, QVector<int> >::const_iterator it = childElements_.constFind(node);
+    if(it == childElements_.constEnd()) {
+	QVector<int> children;
+	for(int child = firstChildElement(node); child >= 0; child = nextSiblingElement(child)) {
+	    children << child;
+	}
+	it = childElements_.insert(node, children);
+    }
+    return row >= 0 && row < it->size() ? it->at(row) : -1;
+}
+
+int CarveDocumentStore::findAttribute(int node, int name) const {
+    int first = firstAttrs_.at(node);
+    int last = first + attrCounts_.at(node);
+    for(int i = first; i < last; ++i) {
+	if(attributes_.at(i).name == name) { return i; }
+    }
+    return -1;
+}
+
+int CarveDocumentStore::attributeCount(int node) const {
+    int count = 0;
+    int first = firstAttrs_.at(node);
+    int last = first + attrCounts_.at(node);
+    for(int i = first; i < last; ++i) {
+	if(attributes_.at(i).name != AtomNone) { ++count; }
+    }
+    return count;
+}
+
+QString CarveDocumentStore::attribute(int node, int name, bool* bOk) const {
+    int index = (name == AtomNone) ? -1 : findAttribute(node, name);
+    if(bOk) { *bOk = (index >= 0); }
+    return index >= 0 ? attributes_.at(index).value : QString();
+}
+
+QString CarveDocumentStore::attribute(int node, const QString& name, bool* bOk) const {
+    // every name in the document was interned while parsing
+    return attribute(node, CarveAtoms::find(name), bOk);
+}
+
+void CarveDocumentStore::setAttribute(int node, int name, const QString& value) {
+    int index = findAttribute(node, name);
+    if(index >= 0) {
+	Attribute& attribute = attributes_[index];
+	if(attribute.value == value) { return; }
+	attribute.value = value;
+	attribute.begin = attribute.end = -1;
+    }
+    else {
+	// keep the element's attributes contiguous: unless they are the last run,
+	// move them to the end (the old run is left unused)
+	int first = firstAttrs_.at(node);
+	int count = attrCounts_.at(node);
+	if(first + count != attributes_.size()) {
+	    firstAttrs_[node] = attributes_.size();
+	    for(int i = 0; i < count; ++i) { attributes_ << Attribute(attributes_.at(first + i)); }
+	}
+	Attribute attribute;
+	attribute.name = name;
+	attribute.value = value;
+	attribute.begin = attribute.end = -1;
+	attributes_ << attribute;
+	++attrCounts_[node];
+    }
+
+    markChanged(node, AttributesChanged);
+    if(name == AtomId) {
+	ids_.clear();
+	indexIds(document());
+    }
+}
+
+void CarveDocumentStore::removeAttribute(int node, int name) {
+    int index = findAttribute(node, name);
+    if(index < 0) { return; }
+    attributes_[index].name = AtomNone;
+    markChanged(node, AttributesChanged);
+    if(name == AtomId) {
+	ids_.clear();
+	indexIds(document());
+    }
+}
+
+QString CarveDocumentStore::nodeValue(int node) const {
+    const QChar* data = source_.constData();
+    int begin = begins_.at(node);
+    int end = ends_.at(node);
+    switch(kinds_.at(node)) {
+	case TextNode:
+	    if(flags_.at(node) & ValueChanged) { return values_.value(node); }
+	    return decode(data + begin, data + end, false);
+	case CDataNode:
+	    return QString(data + begin + 9, end - begin - 12);
+	case CommentNode:
+	    return QString(data + begin + 4, end - begin - 7);
+	case ProcessingInstructionNode: {
+	    // the data after the target
+	    const QChar* pos = data + begin + 2;
+	    while(pos < data + end - 2 && !isXMLSpace(pos->unicode())) { ++pos; }
+	    while(pos < data + end - 2 && isXMLSpace(pos->unicode())) { ++pos; }
+	    return QString(pos, int(data + end - 2 - pos));
+	}
+	default:
+	    return QString();
+    }
+}
+
+void CarveDocumentStore::setNodeValue(int node, const QString& value) {
+    if(kinds_.at(node) != TextNode) { return; }
+    values_.insert(node, value);
+    markChanged(node, ValueChanged);
+}
+
+void CarveDocumentStore::setText(int node, const QString& value) {
+    if(kinds_.at(node) != ElementNode) { return; }
+    for(int child = firstChildren_.at(node); child >= 0; child = nextSiblings_.at(child)) {
+	parents_[child] = -1;
+    }
+    firstChildren_[node] = lastChildren_[node] = -1;
+    childElements_.remove(node);
+    markChanged(node, ChildrenChanged);
+
+    if(!value.isEmpty()) {
+	int text = addNode(TextNode, node, -1, -1);
+	values_.insert(text, value);
+	flags_[text] |= ValueChanged;
+    }
+    ids_.clear();
+    indexIds(document());
+}
+
+void CarveDocumentStore::removeNode(int node) {
+    int parent = parents_.at(node);
+    if(parent < 0) { return; }
+
+    // the siblings before the node and before that
+    int previous = -1, beforePrevious = -1;
+    for(int child = firstChildren_.at(parent); child != node; child = nextSiblings_.at(child)) {
+	beforePrevious = previous;
+	previous = child;
+    }
+
+    // the whitespace that indented the node goes with it
+    int first = node;
+    if(previous >= 0 && kinds_.at(previous) == TextNode && !(flags_.at(previous) & ValueChanged)
+	    && source_.midRef(begins_.at(previous), ends_.at(previous) - begins_.at(previous)).toString().trimmed().isEmpty()) {
+	first = previous;
+	previous = beforePrevious;
+    }
+
+    int next = nextSiblings_.at(node);
+    if(previous >= 0) { nextSiblings_[previous] = next; }
+    else { firstChildren_[parent] = next; }
+    if(lastChildren_.at(parent) == node) { lastChildren_[parent] = previous; }
+    for(int removed = first; removed != next; removed = nextSiblings_.at(removed)) {
+	parents_[removed] = -1;
+    }
+    nextSiblings_[node] = -1;
+    childElements_.remove(parent);
+
+    markChanged(parent, ChildrenChanged);
+    ids_.clear();
+    indexIds(document());
+}
+
+void CarveDocumentStore::markChanged(int node, int flag) {
+    flags_[node] |= flag;
+    bModified_ = true;
+    for(int ancestor = parents_.at(node); ancestor >= 0 && !(flags_.at(ancestor) & ChildrenChanged); ancestor = parents_.at(ancestor)) {
+	flags_[ancestor] |= ChildrenChanged;
+    }
+}
+
+void CarveDocumentStore::indexIds(int node) {
+    for(int child = firstChildren_.at(node); child >= 0; child = nextSiblings_.at(child)) {
+	if(kinds_.at(child) == ElementNode) {
+	    indexId(child);
+	    indexIds(child);
+	}
+    }
+}
+
+void CarveDocumentStore::collectText(int node, QString& out) const {
+    for(int child = firstChildren_.at(node); child >= 0; child = nextSiblings_.at(child)) {
+	int kind = kinds_.at(child);
+	if(kind == TextNode || kind == CDataNode) { out += nodeValue(child); }
+	else if(kind == ElementNode) { collectText(child, out); }
+    }
+}
+
+QString CarveDocumentStore::text(int node) const {
+    QString out;
+    collectText(node, out);
+    return out;
+}
+
+int CarveDocumentStore::lineNumber(int node) const {
+    return qUpperBound(lineStarts_.begin(), lineStarts_.end(), begins_.at(node)) - lineStarts_.begin();
+}
+
+void CarveDocumentStore::writeNode(int node, QString& out) const {
+    int kind = kinds_.at(node);
+    if(flags_.at(node) == 0) {
+	// untouched: the whole subtree is one slice of the source
+	int end = (kind == ElementNode) ? endTagEnds_.at(node) : ends_.at(node);
+	out += source_.midRef(begins_.at(node), end - begins_.at(node));
+	return;
+    }
+
+    if(kind == ElementNode) {
+	if(!(flags_.at(node) & AttributesChanged)) {
+	    out += source_.midRef(begins_.at(node), tailBegins_.at(node) - begins_.at(node));
+	}
+	else {
+	    out += QChar('<');
+	    out += tagName(node);
+	    int first = firstAttrs_.at(node);
+	    int last = first + attrCounts_.at(node);
+	    for(int i = first; i < last; ++i) {
+		const Attribute& attribute = attributes_.at(i);
+		if(attribute.name == AtomNone) { continue; }
+		if(attribute.begin >= 0) {
+		    out += source_.midRef(attribute.begin, attribute.end - attribute.begin);
+		}
+		else {
+		    out += QChar(' ');
+		    out += CarveAtoms::name(attribute.name);
+		    out += "=\"";
+		    out += escape(attribute.value, true);
+		    out += QChar('"');
+		}
+	    }
+	}
+	bool bSelfClosing = endTagBegins_.at(node) == endTagEnds_.at(node);
+	if(bSelfClosing && firstChildren_.at(node) >= 0) {
+	    // an empty element that has been given content
+	    out += source_.midRef(tailBegins_.at(node), ends_.at(node) - 2 - tailBegins_.at(node));
+	    out += QChar('>');
+	    for(int child = firstChildren_.at(node); child >= 0; child = nextSiblings_.at(child)) {
+		writeNode(child, out);
+	    }
+	    out += "</";
+	    out += tagName(node);
+	    out += QChar('>');
+	    return;
+	}
+	out += source_.midRef(tailBegins_.at(node), ends_.at(node) - tailBegins_.at(node));
+    }
+    else if(kind == TextNode && (flags_.at(node) & ValueChanged)) {
+	out += escape(values_.value(node), false);
+    }
+    else if(kind != DocumentNode) {
+	out += source_.midRef(begins_.at(node), ends_.at(node) - begins_.at(node));
+    }
+
+    for(int child = firstChildren_.at(node); child >= 0; child = nextSiblings_.at(child)) {
+	writeNode(child, out);
+    }
+    if(kind == ElementNode) {
+	out += source_.midRef(endTagBegins_.at(node), endTagEnds_.at(node) - endTagBegins_.at(node));
+    }
+}
+
+QString CarveDocumentStore::toString() const {
+    CARVE_PROFILE("CarveDocumentStore::toString");
+    if(kinds_.isEmpty()) { return QString(); }
+    if(!bModified_) { return source_; }
+
+    QString out;
+    out.reserve(source_.size());
+    writeNode(document(), out);
+    return out;
+}
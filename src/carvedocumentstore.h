@@ -0,0 +1,159 @@
+#ifndef CARVEDOCUMENTSTORE_H
+#define CARVEDOCUMENTSTORE_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+
+#include "carveatoms.h"
+
+// A read-mostly SVG document, parsed straight from its text.
+//
+// Nodes are ints indexing parallel arrays (kind, name, links to the parent,
+// first child and next sibling, source spans), and the attributes of an
+// element are a contiguous run of (name atom, value) records, so walking the
+// tree or reading an attribute touches a few small arrays instead of a web of
+// heap objects, and attribute lookup compares integers.  Ids are indexed as
+// the document is parsed.
+//
+// Every node remembers the span of the source text it came from, so an
+// unmodified document serializes back to exactly the text it was parsed
+// from.  Changes mark the path up to the document, and serializing copies
+// each untouched subtree as one slice of the source; only changed start tags
+// and text are written out anew, so the output differs from the source
+// exactly where the document was edited.
+//
+// The accessors mirror the QDomElement calls the model uses today, so code can
+// move over from QDom one function at a time.
+class CarveDocumentStore
+{
+public:
+    enum NodeKind {
+	DocumentNode,
+	ElementNode,
+	TextNode,
+	CDataNode,
+	CommentNode,
+	ProcessingInstructionNode,
+	DoctypeNode
+    };
+
+    CarveDocumentStore();
+
+    // replaces the contents; on failure the store is empty and the error is reported as QDomDocument does
+    bool setContent(const QString& text, QString* errorMsg = NULL, int* errorLine = NULL, int* errorColumn = NULL);
+    void clear();
+    // the text the store was parsed from
+    const QString& sourceText() const { return source_; }
+    // the whole document as text, byte for byte the source unless something was changed
+    QString toString() const;
+    // whether anything was changed since setContent()
+    bool isModified() const { return bModified_; }
+    // whether the document type declaration has an internal subset, whose
+    // entities the store leaves unexpanded in attribute values and text
+    bool hasInternalSubset() const { return bInternalSubset_; }
+
+    int nodeCount() const { return kinds_.size(); }
+    // the node that holds the prolog, the root element and anything after it (always 0)
+    int document() const { return 0; }
+    int documentElement() const;
+
+    // tree structure; -1 stands for no node
+    NodeKind kind(int node) const { return NodeKind(kinds_.at(node)); }
+    bool isElement(int node) const { return kinds_.at(node) == ElementNode; }
+    int parent(int node) const { return parents_.at(node); }
+    int firstChild(int node) const { return firstChildren_.at(node); }
+    int nextSibling(int node) const { return nextSiblings_.at(node); }
+    int firstChildElement(int node) const;
+    int nextSiblingElement(int node) const;
+    // the row-th element child of node, or -1; the element children of a node
+    // are indexed on first use, so this does not walk the siblings before it
+    int childElement(int node, int row) const;
+
+    // elements
+    int nameAtom(int node) const { return names_.at(node); }
+    QString tagName(int node) const { return CarveAtoms::name(names_.at(node)); }
+    int attributeCount(int node) const;
+    bool hasAttribute(int node, int name) const { return findAttribute(node, name) >= 0; }
+    QString attribute(int node, int name, bool* bOk = NULL) const;
+    QString attribute(int node, const QString& name, bool* bOk = NULL) const;
+    void setAttribute(int node, int name, const QString& value);
+    void removeAttribute(int node, int name);
+    // the text of all text and CDATA nodes below node, in document order
+    QString text(int node) const;
+
+    // text, CDATA, comments and processing instructions
+    QString nodeValue(int node) const;
+    // replaces the content of a text node
+    void setNodeValue(int node, const QString& value);
+    // replaces the children of an element with a single text node
+    void setText(int node, const QString& value);
+    // unlinks node (and the indentation before it) from the tree
+    void removeNode(int node);
+
+    // the first element (in document order) with this id, or -1
+    int elementById(const QString& id) const { return ids_.value(id, -1); }
+    // 1-based, like QDomNode::lineNumber()
+    int lineNumber(int node) const;
+
+private:
+    // attributes: the run [firstAttrs_[n], firstAttrs_[n] + attrCounts_[n]) of these arrays
+    struct Attribute {
+	int name;          // AtomNone once removed
+	QString value;     // with entities and whitespace resolved
+	int begin;         // source span of the attribute with its leading whitespace;
+	int end;           // begin == -1 once the attribute has been changed or added
+    };
+
+    enum NodeFlag {
+	// the start tag has to be written out from the attributes
+	AttributesChanged = 1,
+	// the text node's value replaces its source
+	ValueChanged = 2,
+	// something below the node changed, so it cannot be copied as a whole
+	ChildrenChanged = 4
+    };
+
+    int addNode(NodeKind kind, int parent, int begin, int end);
+    int findAttribute(int node, int name) const;
+    void indexId(int node);
+    void indexIds(int node);
+    void markChanged(int node, int flag);
+    void writeNode(int node, QString& out) const;
+    void collectText(int node, QString& out) const;
+    bool fail(const QString& message, int pos, QString* errorMsg, int* errorLine, int* errorColumn);
+
+    QString source_;
+    // sorted offsets at which the lines of source_ start
+    QVector<int> lineStarts_;
+
+    // one entry per node
+    QVector<quint8> kinds_;
+    QVector<quint8> flags_;
+    QVector<int> names_;
+    QVector<int> parents_;
+    QVector<int> firstChildren_;
+    QVector<int> lastChildren_;
+    QVector<int> nextSiblings_;
+    // the node's markup (the start tag, for elements)
+    QVector<int> begins_;
+    QVector<int> ends_;
+    // elements: where the end of the start tag begins (after the last attribute),
+    // and the end tag (empty when the element closes itself)
+    QVector<int> tailBegins_;
+    QVector<int> endTagBegins_;
+    QVector<int> endTagEnds_;
+    QVector<int> firstAttrs_;
+    QVector<int> attrCounts_;
+
+    QVector<Attribute> attributes_;
+    // changed text node values
+    QHash<int, QString> values_;
+    QHash<QString, int> ids_;
+    // element children by row, for the nodes childElement() has been asked about
+    mutable QHash<int, QVector<int> > childElements_;
+    bool bModified_;
+    bool bInternalSubset_;
+};
+
+#endif // CARVEDOCUMENTSTORE_H
@@ -19,49 +19,48 @@
 */
 #include "carvesvgnode.h"
 #include "carveellipseelement.h"
-#include "carvesvgwindow.h"
-#include "carvewindow.h"
-#include "carvescene.h"
+#include "carvesvgdocument.h"
+#include "carvescenebuilder.h"
 #include "domhelper.h"
-#include "carvegraphicsitems.h"
+#include "carveatoms.h"
 
 #include <QDomNode>
 #include <QGraphicsEllipseItem>
 #include <QBrush>
 #include <QPen>
 
-#include <iostream>
-using std::cout;
-using std::endl;
-
-CarveEllipseElement::CarveEllipseElement(const QDomElement& element, int row, CarveSVGWindow* window, CarveSVGNode* parent) :
-	CarveSVGNode(element, row, window, svgEllipse, parent)
+CarveEllipseElement::CarveEllipseElement(const QDomElement& element, int row, CarveSVGDocument* document, CarveSVGNode* parent) :
+	CarveSVGNode(element, row, document, svgEllipse, parent)
 {
     bool bOk = false;
 
-    qreal cx = getFloatTrait(element, "cx",&bOk);
+    qreal cx = getFloatTrait(element, AtomCx,&bOk);
     if(!bOk) { cx = 0.0; }
 
-    qreal cy = getFloatTrait(element, "cy",&bOk);
+    qreal cy = getFloatTrait(element, AtomCy,&bOk);
     if(!bOk) { cy = 0.0; }
 
-    qreal rx = getFloatTrait(element, "rx",&bOk);
+    qreal rx = getFloatTrait(element, AtomRx,&bOk);
     if(!bOk) { rx = 0.0; }
 
-    qreal ry = getFloatTrait(element, "ry",&bOk);
+    qreal ry = getFloatTrait(element, AtomRy,&bOk);
     if(!bOk) { ry = 0.0; }
 
-    CarveGraphicsEllipseItem* item = new CarveGraphicsEllipseItem(window, cx-rx, cy-ry, rx*2, ry*2);
+    this->rect_ = QRectF(cx-rx, cy-ry, rx*2, ry*2);
+}
+
+CarveEllipseElement::~CarveEllipseElement() {
+}
+
+QRectF CarveEllipseElement::geometryBounds() {
+    return strokedBounds(this->rect_);
+}
+
+QGraphicsItem* CarveEllipseElement::createItem() {
+    QGraphicsEllipseItem* item = this->document()->builder()->createEllipseItem(this->rect_);
     finishDecorating(item);
     item->setData(0, qVariantFromValue(reinterpret_cast<void*>(this)));
-    this->getFillOpacity();
-    this->getStrokeLineCap();
-    this->getStrokeLineJoin();
-    this->getStrokeOpacity();
-    this->getStrokeWidth();
     item->setBrush(this->getFill());
     item->setPen(this->getStroke());
-}
-
-CarveEllipseElement::~CarveEllipseElement() {
+    return item;
 }
@@ -25,8 +25,14 @@
 class CarveEllipseElement : public CarveSVGNode
 {
 public:
-    CarveEllipseElement(const QDomElement& element, int row, CarveSVGWindow* window, CarveSVGNode* parent = 0);
+    CarveEllipseElement(const QDomElement& element, int row, CarveSVGDocument* document, CarveSVGNode* parent = 0);
     virtual ~CarveEllipseElement();
+protected:
+    virtual QGraphicsItem* createItem();
+    virtual QRectF geometryBounds();
+
+private:
+    QRectF rect_;
 };
 
 #endif // CARVEELLIPSEELEMENT_H
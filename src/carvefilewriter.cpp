@@ -0,0 +1,245 @@
+#include "carvefilewriter.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QTemporaryFile>
+#include <QTextCodec>
+#include <QMutexLocker>
+#include <QScopedPointer>
+
+#include "carvegzipdevice.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <stdio.h>
+#endif
+
+namespace {
+
+// characters encoded at a time while saving
+const int ENCODE_CHUNK_SIZE = 256 * 1024;
+
+// makes the contents of a flushed file durable before it is renamed into place
+bool syncFile(QFile* file) {
+#ifdef Q_OS_WIN
+    // the file engine's handle is not a C runtime descriptor, so the file is
+    // flushed through a handle of our own (FlushFileBuffers writes out all of
+    // the file's cached data, whichever handle wrote it)
+    HANDLE handle = CreateFileW(reinterpret_cast<const wchar_t*>(QDir::toNativeSeparators(file->fileName()).utf16()),
+				GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+				OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(handle == INVALID_HANDLE_VALUE) { return false; }
+    bool bOk = FlushFileBuffers(handle) != 0;
+    CloseHandle(handle);
+    return bOk;
+#else
+    return ::fsync(file->handle()) == 0;
+#endif
+}
+
+bool replaceFile(const QString& from, const QString& to) {
+#ifdef Q_OS_WIN
+    return MoveFileExW(reinterpret_cast<const wchar_t*>(QDir::toNativeSeparators(from).utf16()),
+		       reinterpret_cast<const wchar_t*>(QDir::toNativeSeparators(to).utf16()),
+		       // makes the rename durable when it returns (the data was flushed by syncFile())
+		       MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    // rename() replaces the destination atomically
+    return ::rename(QFile::encodeName(from).constData(), QFile::encodeName(to).constData()) == 0;
+#endif
+}
+
+// makes the rename itself durable
+void syncDirectory(const QString& path) {
+#ifndef Q_OS_WIN
+    int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY);
+    if(fd >= 0) {
+	::fsync(fd);
+	::close(fd);
+    }
+#else
+    Q_UNUSED(path);
+#endif
+}
+
+}
+
+CarveFileWriter::CarveFileWriter(QObject* parent) :
+	QThread(parent), nextId_(0), bStop_(false)
+{
+}
+
+CarveFileWriter::~CarveFileWriter() {
+    {
+	QMutexLocker locker(&mutex_);
+	bStop_ = true;
+	queued_.wakeAll();
+    }
+    wait();
+}
+
+int CarveFileWriter::write(const QString& fileName, const QString& text) {
+    int id;
+    {
+	QMutexLocker locker(&mutex_);
+	id = nextId_++;
+	pending_.insert(id);
+
+	bool bFolded = false;
+	for(int i = 0; i < queue_.size() && !bFolded; ++i) {
+	    Job& job = queue_[i];
+	    if(job.fileName == fileName) {
+		job.text = text;
+		job.ids << id;
+		bFolded = true;
+	    }
+	}
+	if(!bFolded) {
+	    Job job;
+	    job.ids << id;
+	    job.fileName = fileName;
+	    job.text = text;
+	    queue_ << job;
+	}
+	queued_.wakeOne();
+    }
+
+    if(!isRunning()) { start(QThread::LowPriority); }
+    return id;
+}
+
+bool CarveFileWriter::waitFor(int id, QString* error) {
+    QMutexLocker locker(&mutex_);
+    while(pending_.contains(id)) { done_.wait(&mutex_); }
+    QHash<int, QString>::iterator it = failures_.find(id);
+    if(it == failures_.end()) { return true; }
+    if(error) { *error = it.value(); }
+    failures_.erase(it);
+    return false;
+}
+
+void CarveFileWriter::waitForIdle() {
+    QMutexLocker locker(&mutex_);
+    while(!pending_.isEmpty()) { done_.wait(&mutex_); }
+}
+
+void CarveFileWriter::run() {
+    for(;;) {
+	Job job;
+	{
+	    QMutexLocker locker(&mutex_);
+	    while(queue_.isEmpty() && !bStop_) { queued_.wait(&mutex_); }
+	    if(queue_.isEmpty()) { return; }
+	    job = queue_.takeFirst();
+	}
+
+	QString error;
+	bool bOk = saveText(job.fileName, job.text, &error);
+
+	{
+	    QMutexLocker locker(&mutex_);
+	    for(int i = 0; i < job.ids.size(); ++i) {
+		pending_.remove(job.ids.at(i));
+		if(!bOk) { failures_.insert(job.ids.at(i), error); }
+	    }
+	    done_.wakeAll();
+	}
+	for(int i = 0; i < job.ids.size(); ++i) {
+	    emit written(job.ids.at(i), job.fileName, bOk, error);
+	}
+    }
+}
+
+QString CarveFileWriter::target(const QString& fileName) {
+    // a link is saved through, not replaced by a file
+    QFileInfo info(fileName);
+    return info.isSymLink() ? info.symLinkTarget() : info.absoluteFilePath();
+}
+
+QTemporaryFile* CarveFileWriter::createTemporary(const QString& target, QString* error) {
+    QFileInfo info(target);
+    QTemporaryFile* file = new QTemporaryFile(info.absoluteDir().filePath("." + info.fileName() + ".XXXXXX"));
+    if(!file->open()) {
+	if(error) { *error = file->errorString(); }
+	delete file;
+	return NULL;
+    }
+    return file;
+}
+
+bool CarveFileWriter::commit(QTemporaryFile* file, const QString& target, QString* error) {
+    if(!file->flush() || !syncFile(file)) {
+	if(error) { *error = file->errorString(); }
+	return false;
+    }
+    // temporary files are private to their owner
+    file->setPermissions(QFile::exists(target) ? QFile::permissions(target)
+			 : QFile::ReadOwner | QFile::WriteOwner | QFile::ReadGroup | QFile::ReadOther);
+    QString tempName = file->fileName();
+    file->close();
+
+    if(!replaceFile(tempName, target)) {
+	if(error) { *error = tr("Cannot replace %1").arg(target); }
+	return false;
+    }
+    file->setAutoRemove(false);
+    syncDirectory(QFileInfo(target).absolutePath());
+    return true;
+}
+
+bool CarveFileWriter::writeAtomically(const QString& fileName, const QByteArray& data, QString* error) {
+    QString path = target(fileName);
+    QScopedPointer<QTemporaryFile> file(createTemporary(path, error));
+    if(!file) { return false; }
+    if(file->write(data) != data.size()) {
+	if(error) { *error = file->errorString(); }
+	return false;
+    }
+    return commit(file.data(), path, error);
+}
+
+bool CarveFileWriter::saveText(const QString& fileName, const QString& text, QString* error) {
+    QString path = target(fileName);
+    QScopedPointer<QTemporaryFile> file(createTemporary(path, error));
+    if(!file) { return false; }
+
+    CarveGzipDevice gzip(file.data());
+    QIODevice* out = file.data();
+    if(CarveGzipDevice::isCompressedName(fileName)) {
+	if(!gzip.open(QIODevice::WriteOnly)) {
+	    if(error) { *error = gzip.errorString(); }
+	    return false;
+	}
+	out = &gzip;
+    }
+
+    // encoded as a QTextStream on a QFile::Text file did before saving moved
+    // here, a chunk at a time so the whole encoded text never exists at once
+    QScopedPointer<QTextEncoder> encoder(QTextCodec::codecForLocale()->makeEncoder());
+    for(int pos = 0; pos < text.size(); pos += ENCODE_CHUNK_SIZE) {
+	int length = qMin(ENCODE_CHUNK_SIZE, text.size() - pos);
+#ifdef Q_OS_WIN
+	QString chunk = text.mid(pos, length);
+	chunk.replace('\n', "\r\n");
+	QByteArray bytes = encoder->fromUnicode(chunk);
+#else
+	QByteArray bytes = encoder->fromUnicode(text.constData() + pos, length);
+#endif
+	if(out->write(bytes) != bytes.size()) {
+	    if(error) { *error = out->errorString(); }
+	    return false;
+	}
+    }
+    if(out == &gzip) {
+	gzip.close();
+	if(gzip.hasError()) {
+	    if(error) { *error = gzip.errorString(); }
+	    return false;
+	}
+    }
+    return commit(file.data(), path, error);
+}
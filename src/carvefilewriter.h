@@ -0,0 +1,78 @@
+#ifndef CARVEFILEWRITER_H
+#define CARVEFILEWRITER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QByteArray>
+
+class QTemporaryFile;
+
+// Saves documents on a worker thread.  The text is encoded (and for .svgz,
+// compressed) chunk by chunk into a temporary file next to the destination,
+// synced to disk and then renamed over it, so a crash or a full disk at any
+// point leaves either the old contents or the new ones, never a truncated file.
+//
+// Writes are done in the order they were queued.  A write that is still
+// waiting when a newer one for the same file arrives is folded into it, and
+// both ids complete with its result.
+class CarveFileWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    CarveFileWriter(QObject* parent = 0);
+    // finishes everything still queued
+    ~CarveFileWriter();
+
+    // queues text to be written to fileName and returns the id written() will report
+    int write(const QString& fileName, const QString& text);
+    // blocks until the write with this id is done and returns whether it succeeded
+    bool waitFor(int id, QString* error = NULL);
+    // blocks until nothing is queued or being written
+    void waitForIdle();
+
+    // writes text to fileName as save does, on the calling thread
+    static bool saveText(const QString& fileName, const QString& text, QString* error = NULL);
+    // writes data to fileName through a synced temporary file, on the calling thread
+    static bool writeAtomically(const QString& fileName, const QByteArray& data, QString* error = NULL);
+
+signals:
+    // emitted from the worker thread once a write is done
+    void written(int id, const QString& fileName, bool bOk, const QString& error);
+
+protected:
+    void run();
+
+private:
+    // the file a write to fileName ends up in
+    static QString target(const QString& fileName);
+    // an open temporary file beside target, or NULL
+    static QTemporaryFile* createTemporary(const QString& target, QString* error);
+    // syncs the temporary file and renames it over target
+    static bool commit(QTemporaryFile* file, const QString& target, QString* error);
+
+private:
+    struct Job {
+	QList<int> ids;
+	QString fileName;
+	QString text;
+    };
+
+    QMutex mutex_;
+    QWaitCondition queued_;
+    QWaitCondition done_;
+    QList<Job> queue_;
+    // ids queued or being written
+    QSet<int> pending_;
+    // the errors of failed writes, until waitFor() collects them
+    QHash<int, QString> failures_;
+    int nextId_;
+    bool bStop_;
+};
+
+#endif // CARVEFILEWRITER_H
@@ -18,26 +18,32 @@
 
 */
 #include "carvegelement.h"
+#include "carvesvgdocument.h"
+#include "carvescenebuilder.h"
 #include "domhelper.h"
-#include "carvegraphicsitems.h"
 
 #include <QDomNode>
 #include <QGraphicsRectItem>
 
-CarveGElement::CarveGElement(const QDomElement& node, int row, CarveSVGWindow* window, CarveSVGNode* parent) :
-	CarveSVGNode(node, row, window, svgG, parent)
+CarveGElement::CarveGElement(const QDomElement& node, int row, CarveSVGDocument* document, CarveSVGNode* parent) :
+	CarveSVGNode(node, row, document, svgG, parent)
 {
-    // this rect is expanded as child items are added inside the children's finishDecorating()
-    CarveGraphicsRectItem* g = new CarveGraphicsRectItem(window, -1, -1, -1, -1);
-    finishDecorating(g);
-    this->getFillOpacity();
-    this->getStrokeLineCap();
-    this->getStrokeLineJoin();
-    this->getStrokeOpacity();
-    this->getStrokeWidth();
-    g->setBrush(QBrush(QColor("transparent")));
-    g->setPen(QPen(QColor("transparent")));
 }
 
 CarveGElement::~CarveGElement() {
 }
+
+QGraphicsItem* CarveGElement::createItem() {
+    // the rect covers the children, whether or not their items exist yet
+    QRectF bounds;
+    int numChildNodes = this->numChildren();
+    for(int i = 0; i < numChildNodes; ++i) {
+	CarveSVGNode* theChild = this->child(i);
+	if(theChild) { bounds |= theChild->subtreeBounds(); }
+    }
+    QGraphicsRectItem* g = this->document()->builder()->createRectItem(bounds);
+    finishDecorating(g);
+    g->setBrush(QBrush(QColor("transparent")));
+    g->setPen(QPen(QColor("transparent")));
+    return g;
+}
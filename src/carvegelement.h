@@ -25,8 +25,10 @@
 class CarveGElement : public CarveSVGNode
 {
 public:
-    CarveGElement(const QDomElement& node, int row, CarveSVGWindow* window, CarveSVGNode* parent = 0);
+    CarveGElement(const QDomElement& node, int row, CarveSVGDocument* document, CarveSVGNode* parent = 0);
     virtual ~CarveGElement();
+protected:
+    virtual QGraphicsItem* createItem();
 };
 
 #endif // CARVEGELEMENT_H
@@ -25,10 +25,6 @@
 #include <QVariant>
 #include <QGraphicsSceneContextMenuEvent>
 
-#include <iostream>
-using std::cout;
-using std::endl;
-
 const char* CGI_DELETE = "Delete";
 
 // TODO: figure out why selecting nodes already selects the appropriate node in the dom browser
@@ -124,3 +120,40 @@ void CarveGraphicsImageItem::contextMenuEvent(QGraphicsSceneContextMenuEvent *ev
 	window_->mainwindow()->deleteNode(elem);
     }
 }
+
+void CarveGraphicsUseItem::contextMenuEvent(QGraphicsSceneContextMenuEvent *event) {
+    CarveDesignView* view = this->window_->view();
+    QAction* theAction = view->contextMenu()->exec(event->screenPos());
+    if(theAction == view->deleteNode) {
+	CarveSVGNode* elem = reinterpret_cast<CarveSVGNode*>(this->data(0).value<void*>());
+	window_->mainwindow()->deleteNode(elem);
+    }
+}
+
+QGraphicsScene* CarveGraphicsItemBuilder::scene() {
+    return window_->scene();
+}
+
+QGraphicsRectItem* CarveGraphicsItemBuilder::createRectItem(const QRectF& rect) {
+    return new CarveGraphicsRectItem(window_, rect);
+}
+
+QGraphicsEllipseItem* CarveGraphicsItemBuilder::createEllipseItem(const QRectF& rect) {
+    return new CarveGraphicsEllipseItem(window_, rect);
+}
+
+QGraphicsLineItem* CarveGraphicsItemBuilder::createLineItem(const QLineF& line) {
+    return new CarveGraphicsLineItem(window_, line);
+}
+
+CarvePathItem* CarveGraphicsItemBuilder::createPathItem(const QPainterPath& path) {
+    return new CarveGraphicsPathItem(window_, path);
+}
+
+QGraphicsItem* CarveGraphicsItemBuilder::createImageItem(const QImage& image) {
+    return new CarveGraphicsImageItem(window_, QPixmap::fromImage(image));
+}
+
+CarveUseItem* CarveGraphicsItemBuilder::createUseItem(const QExplicitlySharedDataPointer<CarveUseGeometry>& geometry) {
+    return new CarveGraphicsUseItem(window_, geometry);
+}
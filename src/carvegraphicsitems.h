@@ -27,6 +27,10 @@
 #include <QGraphicsPolygonItem>
 #include <QGraphicsPixmapItem>
 
+#include "carvescenebuilder.h"
+#include "carveuseitem.h"
+#include "carvepathitem.h"
+
 class CarveSVGWindow;
 
 // These are lightweight classes that wrap the QGraphicsItem subclasses
@@ -68,10 +72,10 @@ private:
     CarveSVGWindow* window_;
 };
 
-class CarveGraphicsPathItem : public QGraphicsPathItem {
+class CarveGraphicsPathItem : public CarvePathItem {
 public:
-    CarveGraphicsPathItem(CarveSVGWindow* window, QGraphicsItem * parent = 0) : QGraphicsPathItem(parent), window_(window) {}
-    CarveGraphicsPathItem(CarveSVGWindow* window, const QPainterPath & path, QGraphicsItem * parent = 0) : QGraphicsPathItem(path,parent), window_(window) {}
+    CarveGraphicsPathItem(CarveSVGWindow* window, QGraphicsItem * parent = 0) : CarvePathItem(parent), window_(window) {}
+    CarveGraphicsPathItem(CarveSVGWindow* window, const QPainterPath & path, QGraphicsItem * parent = 0) : CarvePathItem(path,parent), window_(window) {}
 protected:
     virtual QVariant itemChange(GraphicsItemChange change, const QVariant& value);
     virtual void contextMenuEvent(QGraphicsSceneContextMenuEvent* event);
@@ -104,4 +108,33 @@ private:
     CarveSVGWindow* window_;
 };
 
+class CarveGraphicsUseItem : public CarveUseItem {
+public:
+    CarveGraphicsUseItem(CarveSVGWindow* window, const QExplicitlySharedDataPointer<CarveUseGeometry>& geometry, QGraphicsItem* parent = 0) :
+	    CarveUseItem(geometry, parent), window_(window) {}
+protected:
+    virtual void contextMenuEvent(QGraphicsSceneContextMenuEvent* event);
+private:
+    CarveSVGWindow* window_;
+};
+
+// Creates the items above for the nodes of a window's document
+class CarveGraphicsItemBuilder : public CarveSceneBuilder {
+public:
+    CarveGraphicsItemBuilder(CarveSVGWindow* window) : window_(window) {}
+
+    // the window replaces its scene itself before each rebuild (see CarveSVGWindow::isValidXML())
+    virtual QGraphicsScene* scene();
+    virtual void reset() {}
+
+    virtual QGraphicsRectItem* createRectItem(const QRectF& rect);
+    virtual QGraphicsEllipseItem* createEllipseItem(const QRectF& rect);
+    virtual QGraphicsLineItem* createLineItem(const QLineF& line);
+    virtual CarvePathItem* createPathItem(const QPainterPath& path);
+    virtual QGraphicsItem* createImageItem(const QImage& image);
+    virtual CarveUseItem* createUseItem(const QExplicitlySharedDataPointer<CarveUseGeometry>& geometry);
+private:
+    CarveSVGWindow* window_;
+};
+
 #endif // CARVEGRAPHICSITEMS_H
@@ -0,0 +1,160 @@
+#include "carvegzipdevice.h"
+
+#include <zlib.h>
+
+namespace {
+
+// the size of the compressed chunks read from or written to the device
+const int CHUNK_SIZE = 64 * 1024;
+// window bits for deflate: 15, plus 16 for a gzip header and trailer;
+// inflate takes 32 instead to accept zlib streams too
+const int GZIP_WINDOW_BITS = 15 + 16;
+const int AUTO_WINDOW_BITS = 15 + 32;
+
+}
+
+CarveGzipDevice::CarveGzipDevice(QIODevice* device, QObject* parent) :
+	QIODevice(parent), device_(device), stream_(NULL), bEnd_(false), bError_(false)
+{
+}
+
+CarveGzipDevice::~CarveGzipDevice() {
+    close();
+}
+
+bool CarveGzipDevice::isGzipped(QIODevice* device) {
+    QByteArray magic = device->peek(2);
+    return magic.size() == 2 && uchar(magic.at(0)) == 0x1f && uchar(magic.at(1)) == 0x8b;
+}
+
+bool CarveGzipDevice::isCompressedName(const QString& fileName) {
+    return fileName.endsWith(".svgz", Qt::CaseInsensitive) || fileName.endsWith(".gz", Qt::CaseInsensitive);
+}
+
+bool CarveGzipDevice::fail(const QString& message) {
+    bError_ = true;
+    setErrorString(message);
+    return false;
+}
+
+bool CarveGzipDevice::open(OpenMode mode) {
+    bool bRead = mode & ReadOnly;
+    bool bWrite = mode & WriteOnly;
+    if(bRead == bWrite || !device_ || !device_->isOpen()) { return fail(tr("Unsupported open mode")); }
+
+    stream_ = new z_stream;
+    stream_->zalloc = Z_NULL;
+    stream_->zfree = Z_NULL;
+    stream_->opaque = Z_NULL;
+    stream_->next_in = Z_NULL;
+    stream_->avail_in = 0;
+    int ret = bRead ? inflateInit2(stream_, AUTO_WINDOW_BITS)
+		    : deflateInit2(stream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED, GZIP_WINDOW_BITS, 8, Z_DEFAULT_STRATEGY);
+    if(ret != Z_OK) {
+	delete stream_;
+	stream_ = NULL;
+	return fail(tr("Cannot initialize zlib"));
+    }
+    buffer_.resize(CHUNK_SIZE);
+    bEnd_ = bError_ = false;
+    return QIODevice::open(mode);
+}
+
+void CarveGzipDevice::close() {
+    if(!stream_) { return; }
+    if(openMode() & WriteOnly) {
+	// the rest of the compressed data and the gzip trailer
+	stream_->next_in = Z_NULL;
+	stream_->avail_in = 0;
+	int ret = Z_OK;
+	while(ret == Z_OK && !bError_) {
+	    stream_->next_out = reinterpret_cast<Bytef*>(buffer_.data());
+	    stream_->avail_out = buffer_.size();
+	    ret = deflate(stream_, Z_FINISH);
+	    if(ret != Z_OK && ret != Z_STREAM_END) { fail(tr("Compression failed")); }
+	    else { flushOutput(); }
+	}
+	deflateEnd(stream_);
+    }
+    else {
+	inflateEnd(stream_);
+    }
+    delete stream_;
+    stream_ = NULL;
+    QIODevice::close();
+}
+
+qint64 CarveGzipDevice::readData(char* data, qint64 maxSize) {
+    if(bError_) { return -1; }
+    if(bEnd_) { return 0; }
+
+    stream_->next_out = reinterpret_cast<Bytef*>(data);
+    stream_->avail_out = uInt(qMin(maxSize, qint64(1 << 30)));
+    uInt wanted = stream_->avail_out;
+    while(stream_->avail_out > 0) {
+	if(stream_->avail_in == 0) {
+	    qint64 n = device_->read(buffer_.data(), buffer_.size());
+	    if(n < 0) {
+		fail(device_->errorString());
+		return -1;
+	    }
+	    if(n == 0) {
+		fail(tr("Unexpected end of compressed data"));
+		break;
+	    }
+	    stream_->next_in = reinterpret_cast<Bytef*>(buffer_.data());
+	    stream_->avail_in = uInt(n);
+	}
+
+	int ret = inflate(stream_, Z_NO_FLUSH);
+	if(ret == Z_STREAM_END) {
+	    // gzip files may hold several members one after the other
+	    if(stream_->avail_in > 0 || !device_->atEnd()) {
+		inflateReset(stream_);
+		continue;
+	    }
+	    bEnd_ = true;
+	    break;
+	}
+	if(ret != Z_OK && ret != Z_BUF_ERROR) {
+	    fail(tr("Corrupt compressed data"));
+	    break;
+	}
+    }
+
+    qint64 produced = wanted - stream_->avail_out;
+    if(produced == 0 && bError_) { return -1; }
+    return produced;
+}
+
+bool CarveGzipDevice::flushOutput() {
+    qint64 produced = buffer_.size() - stream_->avail_out;
+    if(produced > 0 && device_->write(buffer_.constData(), produced) != produced) {
+	return fail(device_->errorString());
+    }
+    return true;
+}
+
+qint64 CarveGzipDevice::writeData(const char* data, qint64 size) {
+    if(bError_) { return -1; }
+
+    const char* pos = data;
+    qint64 left = size;
+    while(left > 0) {
+	uInt chunk = uInt(qMin(left, qint64(1 << 30)));
+	stream_->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(pos));
+	stream_->avail_in = chunk;
+	do {
+	    stream_->next_out = reinterpret_cast<Bytef*>(buffer_.data());
+	    stream_->avail_out = buffer_.size();
+	    if(deflate(stream_, Z_NO_FLUSH) == Z_STREAM_ERROR) {
+		fail(tr("Compression failed"));
+		return -1;
+	    }
+	    if(!flushOutput()) { return -1; }
+	} while(stream_->avail_out == 0);
+	pos += chunk;
+	left -= chunk;
+    }
+    return size;
+}
@@ -0,0 +1,49 @@
+#ifndef CARVEGZIPDEVICE_H
+#define CARVEGZIPDEVICE_H
+
+#include <QIODevice>
+#include <QByteArray>
+
+struct z_stream_s;
+
+// Streams gzip data (.svgz) through another device: reading inflates what is
+// read from it, writing deflates into it.  Only a chunk of compressed data is
+// ever buffered, so a QTextStream on top decodes a compressed file without
+// the whole of it being inflated into memory first.
+//
+// The underlying device has to be open already, and a gzip device is either
+// read or written, not both.  Closing a written device finishes the stream.
+class CarveGzipDevice : public QIODevice
+{
+public:
+    CarveGzipDevice(QIODevice* device, QObject* parent = 0);
+    ~CarveGzipDevice();
+
+    bool open(OpenMode mode);
+    void close();
+    bool isSequential() const { return true; }
+    // whether inflating or deflating failed (errorString() says why)
+    bool hasError() const { return bError_; }
+
+    // whether the data at the device's current position starts a gzip stream (the device is not advanced)
+    static bool isGzipped(QIODevice* device);
+    // whether a file should be written compressed, judging by its name
+    static bool isCompressedName(const QString& fileName);
+
+protected:
+    qint64 readData(char* data, qint64 maxSize);
+    qint64 writeData(const char* data, qint64 size);
+
+private:
+    bool fail(const QString& message);
+    bool flushOutput();
+
+    QIODevice* device_;
+    z_stream_s* stream_;
+    // compressed data read from or to be written to the device
+    QByteArray buffer_;
+    bool bEnd_;
+    bool bError_;
+};
+
+#endif // CARVEGZIPDEVICE_H
@@ -18,61 +18,67 @@
 
 */
 #include "carveimageelement.h"
-
+#include "carvesvgdocument.h"
+#include "carvescenebuilder.h"
 #include "carvesvgnode.h"
-#include "carvesvgwindow.h"
-#include "carvewindow.h"
-#include "carvescene.h"
 #include "domhelper.h"
-#include "carvegraphicsitems.h"
-
-#include <iostream>
-using std::cout;
-using std::endl;
+#include "carvelog.h"
+#include "carveatoms.h"
 
-#include <QPixmap>
+#include <QImage>
+#include <QGraphicsItem>
 
-CarveImageElement::CarveImageElement(const QDomElement& element, int row, CarveSVGWindow* window, CarveSVGNode* parent) :
-	CarveSVGNode(element, row, window, svgImage, parent)
+CarveImageElement::CarveImageElement(const QDomElement& element, int row, CarveSVGDocument* document, CarveSVGNode* parent) :
+	CarveSVGNode(element, row, document, svgImage, parent)
 {
     bool bOk = false;
 
-    qreal x = getFloatTrait(element, "x", &bOk);
+    qreal x = getFloatTrait(element, AtomX, &bOk);
     if(!bOk) { x = 0.0; }
 
-    qreal y = getFloatTrait(element, "y", &bOk);
+    qreal y = getFloatTrait(element, AtomY, &bOk);
     if(!bOk) { y = 0.0; }
 
-    qreal w = getFloatTrait(element, "width", &bOk);
+    qreal w = getFloatTrait(element, AtomWidth, &bOk);
     if(!bOk) { w = 0; }
     else if(w < 0) {
 	w = 0;
-	cout << "Error!  Width of image is negative" << endl;
+	CARVE_WARNING(LogModel, "Width of <image> is negative");
     }
 
-    qreal h = getFloatTrait(element, "height", &bOk);
+    qreal h = getFloatTrait(element, AtomHeight, &bOk);
     if(!bOk) { h = 0; }
     else if(h < 0) {
 	h = 0;
-	cout << "Error!  Height of image is negative" << endl;
+	CARVE_WARNING(LogModel, "Height of <image> is negative");
     }
 
-    QPixmap pix;
+    this->rect_ = QRectF(x, y, w, h);
+}
+
+CarveImageElement::~CarveImageElement() {
+}
+
+QRectF CarveImageElement::geometryBounds() {
+    return this->rect_;
+}
+
+// the image file is only loaded once the element comes into view
+QGraphicsItem* CarveImageElement::createItem() {
+    QImage image;
 
-    QString href = getTrait(element, "xlink:href", &bOk);
+    QString href = getTrait(this->domElem(), AtomXlinkHref);
     if(!href.isEmpty()) {
-	Qt::AspectRatioMode arm = getAspectRatio(element);
+	Qt::AspectRatioMode arm = getAspectRatio(this->domElem());
 
 	// just try to fetch the image...
-        pix = QPixmap(href).scaled((int)w,(int)h,arm);
+        image = QImage(href).scaled((int)this->rect_.width(),(int)this->rect_.height(),arm);
     }
 
-    CarveGraphicsImageItem* item = new CarveGraphicsImageItem(window, pix);
+    QGraphicsItem* item = this->document()->builder()->createImageItem(image);
     finishDecorating(item);
-    item->setPos(x,y);
+    item->setPos(this->rect_.topLeft());
 
     item->setData(0, qVariantFromValue(reinterpret_cast<void*>(this)));
-}
-
-CarveImageElement::~CarveImageElement() {
+    return item;
 }
@@ -25,8 +25,14 @@
 class CarveImageElement : public CarveSVGNode
 {
 public:
-    CarveImageElement(const QDomElement& element, int row, CarveSVGWindow* window, CarveSVGNode* parent = 0);
+    CarveImageElement(const QDomElement& element, int row, CarveSVGDocument* document, CarveSVGNode* parent = 0);
     virtual ~CarveImageElement();
+protected:
+    virtual QGraphicsItem* createItem();
+    virtual QRectF geometryBounds();
+
+private:
+    QRectF rect_;
 };
 
 #endif // CARVEIMAGEELEMENT_H
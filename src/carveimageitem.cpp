@@ -0,0 +1,14 @@
+#include "carveimageitem.h"
+
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+void CarveImageItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*) {
+    painter->drawImage(QPointF(0, 0), image_);
+
+    if(option->state & QStyle::State_Selected) {
+	painter->setBrush(Qt::NoBrush);
+	painter->setPen(QPen(option->palette.windowText(), 0, Qt::DashLine));
+	painter->drawRect(boundingRect());
+    }
+}
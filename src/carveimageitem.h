@@ -0,0 +1,24 @@
+#ifndef CARVEIMAGEITEM_H
+#define CARVEIMAGEITEM_H
+
+#include <QGraphicsItem>
+#include <QImage>
+
+// An <image> drawn straight from a QImage.  Unlike a QPixmap, a QImage needs
+// no window system, so the library can render images in a process without a
+// display; the editor's builder converts to a pixmap instead.
+class CarveImageItem : public QGraphicsItem
+{
+public:
+    CarveImageItem(const QImage& image, QGraphicsItem* parent = 0) : QGraphicsItem(parent), image_(image) {}
+
+    const QImage& image() const { return image_; }
+
+    QRectF boundingRect() const { return QRectF(QPointF(0, 0), image_.size()); }
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = 0);
+
+private:
+    QImage image_;
+};
+
+#endif // CARVEIMAGEITEM_H
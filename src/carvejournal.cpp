@@ -0,0 +1,378 @@
+#include "carvejournal.h"
+#include "carvefilewriter.h"
+#include "carvegzipdevice.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QStringList>
+#include <QRegExp>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDataStream>
+#include <QTextStream>
+#include <QMutexLocker>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const quint32 JOURNAL_MAGIC = 0x434a4e4c; // "CJNL"
+const quint16 JOURNAL_VERSION = 1;
+
+enum RecordType { HeaderRecord = 'H', SnapshotRecord = 'S', ChangeRecord = 'C' };
+
+// a record is its length, a checksum and the payload
+QByteArray frame(const QByteArray& payload) {
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_4_5);
+    out << quint32(payload.size()) << qChecksum(payload.constData(), payload.size());
+    bytes += payload;
+    return bytes;
+}
+
+QByteArray headerRecord(const QString& fileName, const QString& baseText) {
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_4_5);
+    QFileInfo info(fileName);
+    // replay only trusts the file if it is still the one the edits were made to
+    qint64 size = fileName.isEmpty() ? -1 : info.size();
+    qint64 modified = fileName.isEmpty() ? -1 : qint64(info.lastModified().toTime_t());
+    out << JOURNAL_MAGIC << JOURNAL_VERSION << quint8(HeaderRecord) << fileName << size << modified << baseText;
+    return frame(payload);
+}
+
+QByteArray snapshotRecord(const QString& text) {
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_4_5);
+    out << quint8(SnapshotRecord) << text;
+    return frame(payload);
+}
+
+#ifdef Q_OS_WIN
+typedef HANDLE LockHandle;
+const LockHandle NO_LOCK = INVALID_HANDLE_VALUE;
+#else
+typedef int LockHandle;
+const LockHandle NO_LOCK = -1;
+#endif
+
+// the lock of this process's session, held until it exits
+LockHandle sessionLock = NO_LOCK;
+
+QString lockPath(const QString& directory, qint64 pid) {
+    return QDir(directory).filePath(QString("%1.lock").arg(pid));
+}
+
+// takes the lock at path, creating the file if need be; with bCreate false a
+// missing file is not created.  Without bWait it fails at once if the lock is held.
+LockHandle takeLock(const QString& path, bool bCreate, bool bWait) {
+#ifdef Q_OS_WIN
+    Q_UNUSED(bWait);
+    // an open handle that shares nothing is the lock
+    HANDLE handle = CreateFileW(reinterpret_cast<const wchar_t*>(QDir::toNativeSeparators(path).utf16()),
+				GENERIC_READ | GENERIC_WRITE, 0, NULL, bCreate ? OPEN_ALWAYS : OPEN_EXISTING,
+				FILE_ATTRIBUTE_NORMAL, NULL);
+    return handle;
+#else
+    QByteArray name = QFile::encodeName(path);
+    for(;;) {
+	int fd = ::open(name.constData(), bCreate ? O_RDWR | O_CREAT : O_RDWR, 0600);
+	if(fd < 0) { return NO_LOCK; }
+	if(::flock(fd, bWait ? LOCK_EX : LOCK_EX | LOCK_NB) != 0) {
+	    ::close(fd);
+	    return NO_LOCK;
+	}
+	// removeStaleLocks() may have deleted the file between the open and the lock
+	struct stat opened, current;
+	if(::fstat(fd, &opened) == 0 && ::stat(name.constData(), &current) == 0
+	   && opened.st_dev == current.st_dev && opened.st_ino == current.st_ino) {
+	    return fd;
+	}
+	::close(fd);
+	if(!bCreate) { return NO_LOCK; }
+    }
+#endif
+}
+
+void releaseLock(LockHandle handle) {
+#ifdef Q_OS_WIN
+    CloseHandle(handle);
+#else
+    ::close(handle);
+#endif
+}
+
+// the pid a journal or lock file is named after, or -1
+qint64 ownerPid(const QString& path) {
+    QString name = QFileInfo(path).fileName();
+    bool bOk = false;
+    qint64 pid = name.left(name.indexOf(QRegExp("[-.]"))).toLongLong(&bOk);
+    return bOk ? pid : -1;
+}
+
+QByteArray changeRecord(int position, int removed, const QString& inserted) {
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_4_5);
+    out << quint8(ChangeRecord) << qint32(position) << qint32(removed) << inserted;
+    return frame(payload);
+}
+
+}
+
+CarveJournal::CarveJournal(const QString& path, QObject* parent) :
+	QThread(parent), path_(path), bStop_(false), changeBytes_(0)
+{
+}
+
+CarveJournal::~CarveJournal() {
+    {
+	QMutexLocker locker(&mutex_);
+	bStop_ = true;
+	queued_.wakeAll();
+    }
+    wait();
+}
+
+void CarveJournal::enqueue(const Op& op) {
+    {
+	QMutexLocker locker(&mutex_);
+	// changes that have not been written yet are covered by a new start
+	if(op.type != ChangeOp) { ops_.clear(); }
+	ops_ << op;
+	queued_.wakeOne();
+    }
+    if(!isRunning()) { start(QThread::LowPriority); }
+}
+
+void CarveJournal::reset(const QString& fileName, const QString& text) {
+    fileName_ = fileName;
+    changeBytes_ = 0;
+    Op op;
+    op.type = ResetOp;
+    op.fileName = fileName;
+    op.text = text;
+    op.bSnapshot = false;
+    op.position = op.removed = 0;
+    enqueue(op);
+}
+
+void CarveJournal::compact(const QString& text) {
+    changeBytes_ = 0;
+    Op op;
+    op.type = ResetOp;
+    op.fileName = fileName_;
+    op.text = text;
+    op.bSnapshot = true;
+    op.position = op.removed = 0;
+    enqueue(op);
+}
+
+void CarveJournal::recordChange(int position, int removed, const QString& inserted) {
+    changeBytes_ += 2 * inserted.size() + 16;
+    Op op;
+    op.type = ChangeOp;
+    op.text = inserted;
+    op.bSnapshot = false;
+    op.position = position;
+    op.removed = removed;
+    enqueue(op);
+}
+
+void CarveJournal::discard() {
+    changeBytes_ = 0;
+    Op op;
+    op.type = DiscardOp;
+    op.bSnapshot = false;
+    op.position = op.removed = 0;
+    enqueue(op);
+}
+
+void CarveJournal::run() {
+    QFile file(path_);
+    for(;;) {
+	QList<Op> ops;
+	{
+	    QMutexLocker locker(&mutex_);
+	    while(ops_.isEmpty() && !bStop_) { queued_.wait(&mutex_); }
+	    if(ops_.isEmpty()) { break; }
+	    ops = ops_;
+	    ops_.clear();
+	}
+
+	for(int i = 0; i < ops.size(); ++i) {
+	    const Op& op = ops.at(i);
+	    if(op.type == ResetOp) {
+		file.close();
+		QByteArray bytes;
+		if(op.bSnapshot) { bytes = headerRecord(op.fileName, QString()) + snapshotRecord(op.text); }
+		else { bytes = headerRecord(op.fileName, op.text); }
+		QString error;
+		if(!CarveFileWriter::writeAtomically(path_, bytes, &error)) {
+		    emit failed(error);
+		}
+		else if(!file.open(QFile::WriteOnly | QFile::Append)) {
+		    emit failed(file.errorString());
+		}
+	    }
+	    else if(op.type == ChangeOp) {
+		if(file.isOpen()) { file.write(changeRecord(op.position, op.removed, op.text)); }
+	    }
+	    else {
+		file.close();
+		QFile::remove(path_);
+	    }
+	}
+	// in the kernel's hands: a crash of Carve no longer loses it
+	if(file.isOpen()) { file.flush(); }
+    }
+}
+
+bool CarveJournal::replay(const QString& path, QString* fileName, QString* text, QString* error) {
+    QFile file(path);
+    if(!file.open(QFile::ReadOnly)) {
+	if(error) { *error = file.errorString(); }
+	return false;
+    }
+    QByteArray bytes = file.readAll();
+
+    bool bHeader = false, bBase = false, bEdited = false;
+    qint64 baseSize = -1, baseModified = -1;
+    QString baseText;
+    int pos = 0;
+    while(pos + 6 <= bytes.size()) {
+	QDataStream frameIn(bytes.mid(pos, 6));
+	frameIn.setVersion(QDataStream::Qt_4_5);
+	quint32 length;
+	quint16 checksum;
+	frameIn >> length >> checksum;
+	if(pos + 6 + qint64(length) > bytes.size()) { break; }
+	QByteArray payload = bytes.mid(pos + 6, length);
+	// torn by a crash while it was written
+	if(qChecksum(payload.constData(), payload.size()) != checksum) { break; }
+	pos += 6 + length;
+
+	QDataStream in(payload);
+	in.setVersion(QDataStream::Qt_4_5);
+	if(!bHeader) {
+	    quint32 magic;
+	    quint16 version;
+	    quint8 type;
+	    in >> magic >> version >> type;
+	    if(magic != JOURNAL_MAGIC || version != JOURNAL_VERSION || type != HeaderRecord) { break; }
+	    in >> *fileName >> baseSize >> baseModified >> baseText;
+	    if(!baseText.isNull()) {
+		*text = baseText;
+		bBase = true;
+	    }
+	    bHeader = true;
+	    continue;
+	}
+
+	quint8 type;
+	in >> type;
+	if(type == SnapshotRecord) {
+	    in >> *text;
+	    bBase = bEdited = true;
+	}
+	else if(type == ChangeRecord) {
+	    if(!bBase) {
+		// the edits apply to the file as it was loaded
+		QFileInfo info(*fileName);
+		if(fileName->isEmpty() || info.size() != baseSize || qint64(info.lastModified().toTime_t()) != baseModified) {
+		    if(error) { *error = tr("%1 has changed since the edits were made").arg(*fileName); }
+		    return false;
+		}
+		QFile base(*fileName);
+		if(!base.open(QFile::ReadOnly)) {
+		    if(error) { *error = base.errorString(); }
+		    return false;
+		}
+		// read as CarveSVGWindow::load() reads it
+		CarveGzipDevice gzip(&base);
+		bool bCompressed = CarveGzipDevice::isGzipped(&base);
+		if(bCompressed) { gzip.open(QIODevice::ReadOnly | QIODevice::Text); }
+		else { base.setTextModeEnabled(true); }
+		QTextStream baseIn(bCompressed ? static_cast<QIODevice*>(&gzip) : &base);
+		*text = baseIn.readAll();
+		if(gzip.hasError()) {
+		    if(error) { *error = gzip.errorString(); }
+		    return false;
+		}
+		bBase = true;
+	    }
+	    qint32 position, removed;
+	    QString inserted;
+	    in >> position >> removed >> inserted;
+	    if(position < 0 || removed < 0 || position + removed > text->size()) { break; }
+	    text->replace(position, removed, inserted);
+	    bEdited = true;
+	}
+	else {
+	    break;
+	}
+    }
+
+    if(!bHeader) {
+	if(error) { *error = tr("%1 is not a journal").arg(path); }
+	return false;
+    }
+    // nothing was recorded beyond the header: there is nothing to recover
+    if(!bEdited) {
+	if(error) { error->clear(); }
+	return false;
+    }
+    return true;
+}
+
+bool CarveJournal::lockSession(const QString& directory) {
+    if(sessionLock != NO_LOCK) { return true; }
+    QDir().mkpath(directory);
+    sessionLock = takeLock(lockPath(directory, QCoreApplication::applicationPid()), true, true);
+    return sessionLock != NO_LOCK;
+}
+
+bool CarveJournal::isAbandoned(const QString& path) {
+    qint64 pid = ownerPid(path);
+    if(pid < 0) { return true; }
+    if(pid == QCoreApplication::applicationPid()) { return false; }
+    QString lock = lockPath(QFileInfo(path).absolutePath(), pid);
+    // no lock file: its owner is gone (or never took one)
+    if(!QFile::exists(lock)) { return true; }
+    LockHandle handle = takeLock(lock, false, false);
+    if(handle == NO_LOCK) { return !QFile::exists(lock); }
+    releaseLock(handle);
+    return true;
+}
+
+void CarveJournal::removeStaleLocks(const QString& directory) {
+    QDir dir(directory);
+    QStringList locks = dir.entryList(QStringList() << "*.lock", QDir::Files);
+    for(int i = 0; i < locks.size(); ++i) {
+	QString path = dir.filePath(locks.at(i));
+	if(ownerPid(path) == QCoreApplication::applicationPid()) { continue; }
+	LockHandle handle = takeLock(path, false, false);
+	if(handle == NO_LOCK) { continue; }
+#ifdef Q_OS_WIN
+	// a file cannot be deleted while it is open; an owner that opens it in
+	// between keeps it open unshared, and the removal fails harmlessly
+	releaseLock(handle);
+	QFile::remove(path);
+#else
+	// removed while it is locked, so takeLock() in a starting owner notices
+	QFile::remove(path);
+	releaseLock(handle);
+#endif
+    }
+}
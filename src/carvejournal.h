@@ -0,0 +1,92 @@
+#ifndef CARVEJOURNAL_H
+#define CARVEJOURNAL_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QList>
+#include <QString>
+
+// An append-only record of the edits made to one document since it was last
+// saved, kept so the work survives a crash of Carve.
+//
+// A journal starts with a header naming the document's file and the text the
+// edits start from (the file as it was on disk, or for a new document its
+// initial text); after that it only grows by the changes the editor reports,
+// each a small framed record.  The owner compacts it (replaces the records by
+// a snapshot of the whole text) once the changes outweigh the text.  Records
+// are written on a worker thread, so recording a keystroke costs no I/O on
+// the GUI thread.
+//
+// A record torn by a crash fails its checksum, and replay() stops before it.
+//
+// Journals are named "<pid>-<n>.journal".  While a process runs it holds a
+// lock on "<pid>.lock" in the same directory, so another instance can tell
+// the journals of a live session from those a crash left behind.
+class CarveJournal : public QThread
+{
+    Q_OBJECT
+
+public:
+    CarveJournal(const QString& path, QObject* parent = 0);
+    // writes whatever is still queued; the file is left for recovery unless discard() was called
+    ~CarveJournal();
+
+    const QString& path() const { return path_; }
+
+    // starts over: the edits that follow apply to fileName as it is on disk
+    // now, or to text if it is given (a document that was never saved)
+    void reset(const QString& fileName, const QString& text = QString());
+    // text was inserted at position, replacing removed characters
+    void recordChange(int position, int removed, const QString& inserted);
+    // replaces the records with a snapshot of the whole text
+    void compact(const QString& text);
+    // the size of the changes recorded since the last reset() or compact()
+    qint64 changeBytes() const { return changeBytes_; }
+    // deletes the journal: the document was saved or its changes thrown away
+    void discard();
+
+    // the file name and text a journal left behind describes (the file name
+    // is empty for a document that was never saved); if no edits were
+    // recorded there is nothing to recover, and it fails without an error
+    static bool replay(const QString& path, QString* fileName, QString* text, QString* error = NULL);
+
+    // locks this process's lock file in directory until it exits (once; later calls do nothing)
+    static bool lockSession(const QString& directory);
+    // whether the process that wrote the journal at path is gone (false for this process's own)
+    static bool isAbandoned(const QString& path);
+    // deletes the lock files in directory that no running process holds
+    static void removeStaleLocks(const QString& directory);
+
+signals:
+    // emitted from the worker thread
+    void failed(const QString& error);
+
+protected:
+    void run();
+
+private:
+    enum OpType { ResetOp, ChangeOp, DiscardOp };
+    struct Op {
+	OpType type;
+	QString fileName;
+	QString text;
+	// the text is a snapshot of edited text, not the text edits start from
+	bool bSnapshot;
+	int position;
+	int removed;
+    };
+
+    void enqueue(const Op& op);
+
+    QString path_;
+    QMutex mutex_;
+    QWaitCondition queued_;
+    QList<Op> ops_;
+    bool bStop_;
+    // only touched on the owner's thread
+    qint64 changeBytes_;
+    QString fileName_;
+};
+
+#endif // CARVEJOURNAL_H
@@ -18,11 +18,11 @@
 
 */
 #include "carvelineelement.h"
+#include "carvesvgdocument.h"
+#include "carvescenebuilder.h"
 #include "carvesvgnode.h"
-#include "carvesvgwindow.h"
-#include "carvescene.h"
 #include "domhelper.h"
-#include "carvegraphicsitems.h"
+#include "carveatoms.h"
 
 #include <QDomNode>
 #include <QGraphicsLineItem>
@@ -30,44 +30,46 @@
 #include <QPen>
 #include <QGraphicsScene>
 
-#include <iostream>
-using std::cout;
-using std::endl;
-
-CarveLineElement::CarveLineElement(const QDomElement& node, int row, CarveSVGWindow* window, CarveSVGNode* parent) :
-    CarveSVGNode(node, row, window, svgLine, parent)
+CarveLineElement::CarveLineElement(const QDomElement& node, int row, CarveSVGDocument* document, CarveSVGNode* parent) :
+    CarveSVGNode(node, row, document, svgLine, parent)
 {
     bool bOk = false;
 
-    qreal x1 = getFloatTrait(node, "x1",&bOk);
+    qreal x1 = getFloatTrait(node, AtomX1,&bOk);
     if(!bOk) {
 	x1 = 0.0;
     }
 
-    qreal y1 = getFloatTrait(node, "y1",&bOk);
+    qreal y1 = getFloatTrait(node, AtomY1,&bOk);
     if(!bOk) {
 	y1 = 0.0;
     }
 
-    qreal x2 = getFloatTrait(node, "x2",&bOk);
+    qreal x2 = getFloatTrait(node, AtomX2,&bOk);
     if(!bOk) {
 	x2 = 0.0;
     }
 
-    qreal y2 = getFloatTrait(node, "y2",&bOk);
+    qreal y2 = getFloatTrait(node, AtomY2,&bOk);
     if(!bOk) {
 	y2 = 0.0;
     }
 
-    CarveGraphicsLineItem* item = new CarveGraphicsLineItem(window, x1, y1, x2, y2);
-    finishDecorating(item);
-    item->setData(0, qVariantFromValue(reinterpret_cast<void*>(this)));
-    this->getStrokeLineCap();
-    this->getStrokeLineJoin();
-    this->getStrokeOpacity();
-    this->getStrokeWidth();
-    item->setPen(this->getStroke(&bOk));
+    this->line_ = QLineF(x1, y1, x2, y2);
 }
 
 CarveLineElement::~CarveLineElement() {
 }
+
+QRectF CarveLineElement::geometryBounds() {
+    return strokedBounds(QRectF(this->line_.p1(), this->line_.p2()));
+}
+
+QGraphicsItem* CarveLineElement::createItem() {
+    bool bOk = false;
+    QGraphicsLineItem* item = this->document()->builder()->createLineItem(this->line_);
+    finishDecorating(item);
+    item->setData(0, qVariantFromValue(reinterpret_cast<void*>(this)));
+    item->setPen(this->getStroke(&bOk));
+    return item;
+}
@@ -25,8 +25,14 @@
 class CarveLineElement : public CarveSVGNode
 {
 public:
-    CarveLineElement(const QDomElement& node, int row, CarveSVGWindow* window, CarveSVGNode* parent = 0);
+    CarveLineElement(const QDomElement& node, int row, CarveSVGDocument* document, CarveSVGNode* parent = 0);
     virtual ~CarveLineElement();
+protected:
+    virtual QGraphicsItem* createItem();
+    virtual QRectF geometryBounds();
+
+private:
+    QLineF line_;
 };
 
 #endif // CARVELINEELEMENT_H
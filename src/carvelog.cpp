@@ -0,0 +1,71 @@
+#include "carvelog.h"
+
+#include <QtGlobal>
+#include <QByteArray>
+
+// keep a broken document from flooding the Diagnostics pane
+const int MAX_COLLECTED_MESSAGES = 200;
+
+CarveLogLevel CarveLog::minLevel_ = LogWarning;
+int CarveLog::categories_ = LogAll;
+QStringList* CarveLog::collector_ = 0;
+
+void CarveLog::write(CarveLogCategory category, CarveLogLevel level, const QString& message) {
+    if(level >= LogWarning && collector_) {
+        if(collector_->size() < MAX_COLLECTED_MESSAGES && !collector_->contains(message)) {
+            collector_->append(message);
+        }
+    }
+
+    if(level < minLevel_ || !(categories_ & category)) {
+        return;
+    }
+
+    const char* name = "";
+    switch(category) {
+        case LogParse: name = "parse"; break;
+        case LogStyle: name = "style"; break;
+        case LogModel: name = "model"; break;
+        case LogUI: name = "ui"; break;
+        default: break;
+    }
+
+    if(level >= LogWarning) {
+        qWarning("[%s] %s", name, qPrintable(message));
+    }
+    else {
+        qDebug("[%s] %s", name, qPrintable(message));
+    }
+}
+
+void CarveLog::init() {
+    QByteArray level = qgetenv("CARVE_LOG_LEVEL").toLower();
+    if(level == "debug") { minLevel_ = LogDebug; }
+    else if(level == "info") { minLevel_ = LogInfo; }
+    else if(level == "warning") { minLevel_ = LogWarning; }
+    else if(level == "error") { minLevel_ = LogError; }
+
+    QByteArray categories = qgetenv("CARVE_LOG_CATEGORIES").toLower();
+    if(!categories.isEmpty()) {
+        categories_ = 0;
+        QList<QByteArray> names = categories.split(',');
+        for(int i = 0; i < names.size(); ++i) {
+            QByteArray name = names.at(i).trimmed();
+            if(name == "parse") { categories_ |= LogParse; }
+            else if(name == "style") { categories_ |= LogStyle; }
+            else if(name == "model") { categories_ |= LogModel; }
+            else if(name == "ui") { categories_ |= LogUI; }
+            else if(name == "all") { categories_ |= LogAll; }
+        }
+    }
+}
+
+CarveLogCollector::CarveLogCollector(QStringList* messages) :
+        previous_(CarveLog::collector_)
+{
+    CarveLog::collector_ = messages;
+}
+
+CarveLogCollector::~CarveLogCollector() {
+    CarveLog::collector_ = previous_;
+}
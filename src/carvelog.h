@@ -0,0 +1,82 @@
+#ifndef CARVELOG_H
+#define CARVELOG_H
+
+#include <QString>
+#include <QStringList>
+
+// Category-based logging.  Messages below CARVE_LOG_MIN_LEVEL are compiled out
+// entirely (the message expression is never evaluated), the rest are filtered at
+// runtime by level and category before any formatting happens.
+//
+// Warnings and errors are also handed to the innermost CarveLogCollector, which
+// is how a CarveSVGDocument gathers the problems found while building its model.
+
+enum CarveLogCategory {
+    LogParse = 0x01,    // path, transform, color and number parsing
+    LogStyle = 0x02,    // style properties and paint servers
+    LogModel = 0x04,    // the document and its nodes
+    LogUI = 0x08,       // windows, panes and views
+    LogAll = 0xff
+};
+
+enum CarveLogLevel {
+    LogDebug = 0,
+    LogInfo = 1,
+    LogWarning = 2,
+    LogError = 3
+};
+
+#ifndef CARVE_LOG_MIN_LEVEL
+#  ifdef QT_NO_DEBUG
+#    define CARVE_LOG_MIN_LEVEL 2
+#  else
+#    define CARVE_LOG_MIN_LEVEL 0
+#  endif
+#endif
+
+class CarveLog
+{
+public:
+    static bool wants(CarveLogCategory category, CarveLogLevel level) {
+        return (level >= minLevel_ && (categories_ & category)) || (level >= LogWarning && collector_);
+    }
+    static void write(CarveLogCategory category, CarveLogLevel level, const QString& message);
+
+    // reads CARVE_LOG_LEVEL (debug|info|warning|error) and
+    // CARVE_LOG_CATEGORIES (comma-separated parse,style,model,ui) from the environment
+    static void init();
+    static void setMinLevel(CarveLogLevel level) { minLevel_ = level; }
+    static void setCategories(int categories) { categories_ = categories; }
+
+private:
+    friend class CarveLogCollector;
+    static CarveLogLevel minLevel_;
+    static int categories_;
+    static QStringList* collector_;
+};
+
+// While alive, warnings and errors are appended to the given list
+// (up to a limit, duplicates are dropped)
+class CarveLogCollector
+{
+public:
+    explicit CarveLogCollector(QStringList* messages);
+    ~CarveLogCollector();
+
+private:
+    QStringList* previous_;
+};
+
+#define CARVE_LOG(category, level, message) \
+    do { \
+        if((level) >= CARVE_LOG_MIN_LEVEL && CarveLog::wants(category, level)) { \
+            CarveLog::write(category, level, message); \
+        } \
+    } while(0)
+
+#define CARVE_DEBUG(category, message) CARVE_LOG(category, LogDebug, message)
+#define CARVE_INFO(category, message) CARVE_LOG(category, LogInfo, message)
+#define CARVE_WARNING(category, message) CARVE_LOG(category, LogWarning, message)
+#define CARVE_ERROR(category, message) CARVE_LOG(category, LogError, message)
+
+#endif // CARVELOG_H
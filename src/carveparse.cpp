@@ -0,0 +1,144 @@
+#include "carveparse.h"
+
+#include <QString>
+
+namespace {
+
+// powers of ten that are exactly representable as doubles
+const double EXACT_POWERS_OF_TEN[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+const int MAX_EXACT_POWER = 22;
+// mantissas below 2^53 convert to double exactly
+const quint64 MAX_EXACT_MANTISSA = Q_UINT64_C(9007199254740992);
+
+inline bool isDigit(const QChar* pos) {
+    ushort u = pos->unicode();
+    return u >= '0' && u <= '9';
+}
+
+// skips the separator after a number of a list; false if it was a comma that ends the list
+inline bool skipListSeparator(const QChar*& pos, const QChar* end) {
+    skipWhitespace(pos, end);
+    if(pos < end && pos->unicode() == ',') {
+	++pos;
+	skipWhitespace(pos, end);
+	return pos < end;
+    }
+    return true;
+}
+
+}
+
+bool parseNumber(const QChar*& pos, const QChar* end, double* value) {
+    const QChar* p = pos;
+    bool bNegative = false;
+    if(p < end && (p->unicode() == '-' || p->unicode() == '+')) {
+	bNegative = (p->unicode() == '-');
+	++p;
+    }
+
+    quint64 mantissa = 0;
+    int numDigits = 0;      // significant digits accumulated into mantissa
+    int exponent = 0;       // decimal exponent applied to mantissa
+    bool bAnyDigits = false;
+    bool bOverflow = false;
+
+    while(p < end && isDigit(p)) {
+	bAnyDigits = true;
+	if(numDigits < 19) {
+	    mantissa = mantissa * 10 + (p->unicode() - '0');
+	    if(mantissa) { ++numDigits; }
+	}
+	else {
+	    ++exponent;
+	    bOverflow = true;
+	}
+	++p;
+    }
+    if(p < end && p->unicode() == '.') {
+	const QChar* dot = p;
+	++p;
+	bool bFraction = false;
+	while(p < end && isDigit(p)) {
+	    bFraction = true;
+	    if(numDigits < 19) {
+		mantissa = mantissa * 10 + (p->unicode() - '0');
+		if(mantissa) { ++numDigits; }
+		--exponent;
+	    }
+	    else {
+		bOverflow = true;
+	    }
+	    ++p;
+	}
+	// "5." is a number, "." on its own is not
+	if(!bFraction && !bAnyDigits) {
+	    p = dot;
+	}
+	bAnyDigits = bAnyDigits || bFraction;
+    }
+    if(!bAnyDigits) {
+	return false;
+    }
+
+    // the exponent only belongs to the number if digits follow it
+    if(p < end && (p->unicode() == 'e' || p->unicode() == 'E')) {
+	const QChar* e = p + 1;
+	bool bNegativeExp = false;
+	if(e < end && (e->unicode() == '-' || e->unicode() == '+')) {
+	    bNegativeExp = (e->unicode() == '-');
+	    ++e;
+	}
+	if(e < end && isDigit(e)) {
+	    int exp = 0;
+	    while(e < end && isDigit(e)) {
+		if(exp < 100000) { exp = exp * 10 + (e->unicode() - '0'); }
+		++e;
+	    }
+	    exponent += bNegativeExp ? -exp : exp;
+	    p = e;
+	}
+    }
+
+    double result;
+    if(!bOverflow && mantissa < MAX_EXACT_MANTISSA && exponent >= -MAX_EXACT_POWER && exponent <= MAX_EXACT_POWER) {
+	// one correctly rounded operation on exact operands gives the correctly rounded result
+	result = double(mantissa);
+	if(exponent < 0) { result /= EXACT_POWERS_OF_TEN[-exponent]; }
+	else { result *= EXACT_POWERS_OF_TEN[exponent]; }
+	if(bNegative) { result = -result; }
+    }
+    else {
+	// rare: long mantissas or large exponents go through the full conversion
+	result = QString::fromRawData(pos, p - pos).toDouble();
+    }
+
+    *value = result;
+    pos = p;
+    return true;
+}
+
+bool parseNumberList(const QChar* pos, const QChar* end, QVector<double>* numbers) {
+    numbers->clear();
+    skipWhitespace(pos, end);
+    while(pos < end) {
+	double value;
+	if(!parseNumber(pos, end, &value) || !skipListSeparator(pos, end)) { return false; }
+	numbers->append(value);
+    }
+    return true;
+}
+
+bool parsePointList(const QChar* pos, const QChar* end, QPolygonF* points) {
+    points->clear();
+    skipWhitespace(pos, end);
+    while(pos < end) {
+	double x, y;
+	if(!parseNumber(pos, end, &x) || !skipListSeparator(pos, end)) { return false; }
+	if(pos == end || !parseNumber(pos, end, &y) || !skipListSeparator(pos, end)) { return false; }
+	points->append(QPointF(x, y));
+    }
+    return true;
+}
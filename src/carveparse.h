@@ -0,0 +1,43 @@
+#ifndef CARVEPARSE_H
+#define CARVEPARSE_H
+
+#include <QChar>
+#include <QVector>
+#include <QPolygonF>
+
+// Low-level scanners for SVG attribute micro-syntaxes.  They work on a
+// [pos, end) range of characters and advance pos past whatever they consume,
+// so callers can parse an attribute in a single pass without building strings.
+
+inline bool isSVGWhitespace(QChar c) {
+    ushort u = c.unicode();
+    return u == ' ' || u == '\t' || u == '\n' || u == '\r';
+}
+
+inline void skipWhitespace(const QChar*& pos, const QChar* end) {
+    while(pos < end && isSVGWhitespace(*pos)) { ++pos; }
+}
+
+// skips whitespace, at most one comma, and whitespace
+inline void skipCommaWhitespace(const QChar*& pos, const QChar* end) {
+    skipWhitespace(pos, end);
+    if(pos < end && pos->unicode() == ',') {
+	++pos;
+	skipWhitespace(pos, end);
+    }
+}
+
+// parses an SVG number ([+-] digits [. digits] [(e|E) [+-] digits], or a leading '.')
+// returns false and leaves pos unchanged if there is no number at pos;
+// the result is correctly rounded
+bool parseNumber(const QChar*& pos, const QChar* end, double* value);
+
+// parses all of [pos, end) as a list of numbers separated by whitespace and/or
+// a comma (viewBox) into numbers; no separator is needed before a number that
+// starts with a sign or a point ("1-2", "0.5.5").  Returns false if anything
+// else is found, a trailing comma included.
+bool parseNumberList(const QChar* pos, const QChar* end, QVector<double>* numbers);
+// the same for a list of coordinate pairs (points), which fails on an odd number of numbers
+bool parsePointList(const QChar* pos, const QChar* end, QPolygonF* points);
+
+#endif // CARVEPARSE_H
@@ -0,0 +1,54 @@
+#include "carvepathcache.h"
+#include "domhelper.h"
+
+CarvePathCache::CarvePathCache(int maxCost) :
+	cache_(maxCost), hits_(0), misses_(0)
+{
+}
+
+double CarvePathCache::hitRate() const {
+    int lookups = hits_ + misses_;
+    return lookups > 0 ? double(hits_) / lookups : 0.0;
+}
+
+QPainterPath CarvePathCache::geometry(const QDomElement& element, CarveAtom tag,
+				      QExplicitlySharedDataPointer<CarvePathLevels>* levels) {
+    Key key;
+    key.tag = tag;
+    key.fillRule = getTrait(element, AtomFillRule) == "evenodd" ? Qt::OddEvenFill : Qt::WindingFill;
+    key.text = getTrait(element, tag == AtomPath ? AtomD : AtomPoints);
+    key.hash = qHash(key.text) ^ uint(tag) ^ (uint(key.fillRule) << 16);
+
+    Entry* cached = cache_.object(key);
+    if(cached) {
+	++hits_;
+	if(levels) { *levels = cached->levels; }
+	return cached->path;
+    }
+    ++misses_;
+
+    Entry* entry = new Entry;
+    if(tag == AtomPath) {
+	// a <path> without d is drawn as a closed move to the origin, as getPathTrait() builds it
+	entry->path = parsePath(key.text);
+    }
+    else {
+	bool bOk = false;
+	QPolygonF points(parsePoints(key.text, &bOk));
+	if(bOk) {
+	    entry->path.addPolygon(points);
+	    if(tag == AtomPolygon) { entry->path.closeSubpath(); }
+	    if(points.size() >= CarvePathLevels::MIN_POINTS) {
+		entry->levels = new CarvePathLevels(points, tag == AtomPolygon, key.fillRule);
+	    }
+	}
+    }
+    // set here so the elements' copies share the cached data instead of detaching
+    entry->path.setFillRule(key.fillRule);
+
+    QPainterPath path = entry->path;
+    if(levels) { *levels = entry->levels; }
+    int cost = entry->path.elementCount() + (entry->levels ? entry->levels->elementCount() : 0);
+    cache_.insert(key, entry, qMax(1, cost));
+    return path;
+}
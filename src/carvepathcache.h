@@ -0,0 +1,75 @@
+#ifndef CARVEPATHCACHE_H
+#define CARVEPATHCACHE_H
+
+#include <QCache>
+#include <QString>
+#include <QPainterPath>
+#include <QDomElement>
+#include <QExplicitlySharedDataPointer>
+
+#include "carveatoms.h"
+#include "carvepathitem.h"
+
+// The outlines of a document's path, polyline and polygon elements, keyed
+// by (a hash of) the d or points text they were built from.  A document keeps
+// its cache across setContent(), so a rebuild after an edit elsewhere finds
+// every unchanged outline here instead of parsing it again.  Long polylines
+// and polygons also keep their display levels (see CarvePathLevels) here.
+//
+// Once the cached outlines hold more than maxCost() path elements, the least
+// recently used ones are dropped.
+class CarvePathCache
+{
+public:
+    CarvePathCache(int maxCost = DEFAULT_MAX_COST);
+
+    // the outline of element, which is a <path>, <polyline> or <polygon> (tag), with its fill
+    // rule set; levels, if given, is set to the outline's display levels (null for a <path>
+    // or a short outline)
+    QPainterPath geometry(const QDomElement& element, CarveAtom tag,
+			  QExplicitlySharedDataPointer<CarvePathLevels>* levels = NULL);
+
+    void clear() { cache_.clear(); }
+    int maxCost() const { return cache_.maxCost(); }
+    void setMaxCost(int cost) { cache_.setMaxCost(cost); }
+    int count() const { return cache_.count(); }
+
+    // lookups answered from the cache and lookups that had to parse, since the last resetCounters()
+    int hits() const { return hits_; }
+    int misses() const { return misses_; }
+    // the share of lookups that were hits, 0 if there were none
+    double hitRate() const;
+    void resetCounters() { hits_ = misses_ = 0; }
+
+    // about 24 MB of path elements (display levels included)
+    static const int DEFAULT_MAX_COST = 1 << 20;
+
+    struct Key {
+	int tag;
+	Qt::FillRule fillRule;
+	uint hash;
+	QString text;
+
+	bool operator==(const Key& other) const {
+	    return hash == other.hash && tag == other.tag && fillRule == other.fillRule && text == other.text;
+	}
+    };
+
+private:
+    // unimplemented to prevent copying
+    CarvePathCache& operator=(const CarvePathCache&);
+    CarvePathCache(const CarvePathCache&);
+
+    struct Entry {
+	QPainterPath path;
+	QExplicitlySharedDataPointer<CarvePathLevels> levels;
+    };
+
+    QCache<Key, Entry> cache_;
+    int hits_;
+    int misses_;
+};
+
+inline uint qHash(const CarvePathCache::Key& key) { return key.hash; }
+
+#endif // CARVEPATHCACHE_H
@@ -18,8 +18,10 @@
 
 */
 #include "carvepathelement.h"
+#include "carvesvgdocument.h"
+#include "carvescenebuilder.h"
 #include "domhelper.h"
-#include "carvegraphicsitems.h"
+#include "carveatoms.h"
 
 #include <QGraphicsPathItem>
 #include <QPainterPath>
@@ -28,35 +30,25 @@
 #include <QPen>
 #include <QtGlobal>
 
-#include <iostream>
-using std::cout;
-using std::endl;
-
-CarvePathElement::CarvePathElement(const QDomElement& element, int row, CarveSVGWindow* window, CarveSVGNode* parent) :
-	CarveSVGNode(element, row, window, svgPath, parent)
+CarvePathElement::CarvePathElement(const QDomElement& element, int row, CarveSVGDocument* document, CarveSVGNode* parent) :
+	CarveSVGNode(element, row, document, svgPath, parent)
 {
-    bool bOk = false;
+    this->path_ = document->pathCache()->geometry(element, AtomPath);
+}
 
-    QPainterPath path(getPathTrait(element, "d", &bOk));
+CarvePathElement::~CarvePathElement() {
+}
 
-    if(getTrait(element, "fill-rule", &bOk) == "evenodd") {
-	path.setFillRule(Qt::OddEvenFill);
-    }
-    else {
-	path.setFillRule(Qt::WindingFill);
-    }
+QRectF CarvePathElement::geometryBounds() {
+    return strokedBounds(this->path_.boundingRect());
+}
 
-    CarveGraphicsPathItem* item = new CarveGraphicsPathItem(window,path);
+QGraphicsItem* CarvePathElement::createItem() {
+    bool bOk = false;
+    QGraphicsPathItem* item = this->document()->builder()->createPathItem(this->path_);
     finishDecorating(item);
     item->setData(0, qVariantFromValue(reinterpret_cast<void*>(this)));
-    this->getFillOpacity();
-    this->getStrokeLineCap();
-    this->getStrokeLineJoin();
-    this->getStrokeOpacity();
-    this->getStrokeWidth();
     item->setBrush(this->getFill(&bOk));
     item->setPen(this->getStroke(&bOk));
-}
-
-CarvePathElement::~CarvePathElement() {
+    return item;
 }
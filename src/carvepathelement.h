@@ -25,8 +25,14 @@
 class CarvePathElement : public CarveSVGNode
 {
 public:
-    CarvePathElement(const QDomElement& node, int row, CarveSVGWindow* window, CarveSVGNode* parent = 0);
+    CarvePathElement(const QDomElement& node, int row, CarveSVGDocument* document, CarveSVGNode* parent = 0);
     virtual ~CarvePathElement();
+protected:
+    virtual QGraphicsItem* createItem();
+    virtual QRectF geometryBounds();
+
+private:
+    QPainterPath path_;
 };
 
 #endif // CARVEPATHELEMENT_H
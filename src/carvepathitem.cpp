@@ -0,0 +1,145 @@
+#include "carvepathitem.h"
+
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+namespace {
+
+// a level is drawn while its tolerance is within this many device pixels
+const qreal TOLERANCE_PIXELS = 0.5;
+// the tolerance is not halved more often than this (it is then far below any zoom)
+const int MAX_HALVINGS = 64;
+
+// vertices first..last of the outline, ranked at most limit
+struct Span {
+    int first;
+    int last;
+    qreal limit;
+};
+
+// the squared distance from p to the segment from a to b
+qreal squaredSegmentDistance(const QPointF& p, const QPointF& a, const QPointF& b) {
+    qreal dx = b.x() - a.x(), dy = b.y() - a.y();
+    qreal length2 = dx * dx + dy * dy;
+    qreal t = 0;
+    if(length2 > 0) {
+	t = ((p.x() - a.x()) * dx + (p.y() - a.y()) * dy) / length2;
+	t = qBound(qreal(0), t, qreal(1));
+    }
+    qreal ex = a.x() + t * dx - p.x(), ey = a.y() + t * dy - p.y();
+    return ex * ex + ey * ey;
+}
+
+// Douglas-Peucker without a tolerance: each vertex gets the squared distance
+// at which it stops being kept.  A vertex never outranks the one whose split
+// introduced it, so the vertices kept at any tolerance form a consistent outline.
+QVector<qreal> rankVertices(const QPolygonF& points) {
+    const int n = points.size();
+    QVector<qreal> rank(n, 0);
+    rank[0] = rank[n - 1] = std::numeric_limits<qreal>::max();
+
+    QVector<Span> stack;
+    Span all = { 0, n - 1, std::numeric_limits<qreal>::max() };
+    stack << all;
+    while(!stack.isEmpty()) {
+	Span span = stack.last();
+	stack.pop_back();
+	if(span.last - span.first < 2) { continue; }
+
+	int farthest = span.first + 1;
+	qreal maxDistance = -1;
+	for(int i = span.first + 1; i < span.last; ++i) {
+	    qreal d = squaredSegmentDistance(points.at(i), points.at(span.first), points.at(span.last));
+	    if(d > maxDistance) {
+		maxDistance = d;
+		farthest = i;
+	    }
+	}
+	qreal limit = qMin(maxDistance, span.limit);
+	rank[farthest] = limit;
+	Span left = { span.first, farthest, limit };
+	Span right = { farthest, span.last, limit };
+	stack << left << right;
+    }
+    return rank;
+}
+
+}
+
+CarvePathLevels::CarvePathLevels(const QPolygonF& points, bool bClosed, Qt::FillRule fillRule) {
+    const int n = points.size();
+    if(n < MIN_POINTS) { return; }
+
+    QVector<qreal> rank = rankVertices(points);
+    QVector<qreal> sorted(rank);
+    std::sort(sorted.begin(), sorted.end(), std::greater<qreal>());
+
+    // halve the tolerance from the size of the whole outline down, keeping a
+    // level each time the vertex count has at least doubled
+    QRectF bounds = points.boundingRect();
+    qreal tolerance = qMax(bounds.width(), bounds.height());
+    int lastCount = 0;
+    for(int halvings = 0; halvings < MAX_HALVINGS && tolerance > 0; ++halvings) {
+	qreal tolerance2 = tolerance * tolerance;
+	// the vertices ranked at least tolerance2
+	int count = std::upper_bound(sorted.begin(), sorted.end(), tolerance2, std::greater<qreal>()) - sorted.begin();
+	if(count > n / 2) { break; }
+	if(count >= 2 && count >= 2 * lastCount) {
+	    Level level;
+	    level.tolerance = tolerance;
+	    bool bFirst = true;
+	    for(int i = 0; i < n; ++i) {
+		if(rank.at(i) < tolerance2) { continue; }
+		if(bFirst) { level.path.moveTo(points.at(i)); }
+		else { level.path.lineTo(points.at(i)); }
+		bFirst = false;
+	    }
+	    if(bClosed) { level.path.closeSubpath(); }
+	    level.path.setFillRule(fillRule);
+	    levels_ << level;
+	    lastCount = count;
+	}
+	tolerance /= 2;
+    }
+}
+
+int CarvePathLevels::elementCount() const {
+    int count = 0;
+    for(int i = 0; i < levels_.size(); ++i) {
+	count += levels_.at(i).path.elementCount();
+    }
+    return count;
+}
+
+const QPainterPath* CarvePathLevels::pathForScale(qreal scale) const {
+    if(scale <= 0) { return levels_.isEmpty() ? NULL : &levels_.first().path; }
+    qreal allowed = TOLERANCE_PIXELS / scale;
+    for(int i = 0; i < levels_.size(); ++i) {
+	if(levels_.at(i).tolerance <= allowed) { return &levels_.at(i).path; }
+    }
+    return NULL;
+}
+
+void CarvePathItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) {
+    const QPainterPath* level = NULL;
+    if(levels_) {
+	level = levels_->pathForScale(QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform()));
+    }
+    if(!level) {
+	QGraphicsPathItem::paint(painter, option, widget);
+	return;
+    }
+
+    painter->setPen(pen());
+    painter->setBrush(brush());
+    painter->drawPath(*level);
+
+    if(option->state & QStyle::State_Selected) {
+	painter->setBrush(Qt::NoBrush);
+	painter->setPen(QPen(option->palette.windowText(), 0, Qt::DashLine));
+	painter->drawRect(boundingRect());
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef CARVEPATHITEM_H
+#define CARVEPATHITEM_H
+
+#include <QGraphicsPathItem>
+#include <QSharedData>
+#include <QExplicitlySharedDataPointer>
+#include <QVector>
+#include <QPolygonF>
+#include <QPainterPath>
+
+// Coarser copies of a long polyline or polygon outline, for display only.
+// Each vertex is ranked by Douglas-Peucker (how far the outline would stray
+// if it were dropped) once, and each level keeps the vertices that matter at
+// its tolerance; a level is only kept if it has at most half the vertices of
+// the next finer one, so all of them together are no bigger than the outline.
+class CarvePathLevels : public QSharedData
+{
+public:
+    // the levels of the outline through points (closed for a polygon)
+    CarvePathLevels(const QPolygonF& points, bool bClosed, Qt::FillRule fillRule);
+
+    bool isEmpty() const { return levels_.isEmpty(); }
+    int levelCount() const { return levels_.size(); }
+    // the number of path elements held by all levels
+    int elementCount() const;
+    // the coarsest level that strays less than half a device pixel from the
+    // outline where a user unit covers scale pixels; NULL if only the full outline will do
+    const QPainterPath* pathForScale(qreal scale) const;
+
+    // outlines with fewer points are drawn as they are
+    static const int MIN_POINTS = 1024;
+
+private:
+    struct Level {
+	// in user units
+	qreal tolerance;
+	QPainterPath path;
+    };
+    // coarsest first
+    QVector<Level> levels_;
+};
+
+// A path item that draws its outline at the level of detail the view's scale
+// calls for, if it has levels; the path itself (for bounds, selection and
+// hit testing) is always the full outline.
+class CarvePathItem : public QGraphicsPathItem
+{
+public:
+    CarvePathItem(QGraphicsItem* parent = 0) : QGraphicsPathItem(parent) {}
+    CarvePathItem(const QPainterPath& path, QGraphicsItem* parent = 0) : QGraphicsPathItem(path, parent) {}
+
+    void setLevels(const QExplicitlySharedDataPointer<CarvePathLevels>& levels) { levels_ = levels; }
+
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = 0);
+
+private:
+    QExplicitlySharedDataPointer<CarvePathLevels> levels_;
+};
+
+#endif // CARVEPATHITEM_H
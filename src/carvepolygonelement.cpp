@@ -18,11 +18,11 @@
 
 */
 #include "carvepolygonelement.h"
+#include "carvesvgdocument.h"
+#include "carvescenebuilder.h"
 #include "carvesvgnode.h"
-#include "carvesvgwindow.h"
-#include "carvescene.h"
 #include "domhelper.h"
-#include "carvegraphicsitems.h"
+#include "carveatoms.h"
 
 #include <QDomNode>
 #include <QGraphicsPathItem>
@@ -31,64 +31,26 @@
 #include <QPen>
 #include <QGraphicsScene>
 
-#include <iostream>
-using std::cout;
-using std::endl;
-
-CarvePolygonElement::CarvePolygonElement(const QDomElement& element, int row, CarveSVGWindow* window, CarveSVGNode* parent) :
-	CarveSVGNode(element, row, window, svgPolygon, parent)
+CarvePolygonElement::CarvePolygonElement(const QDomElement& element, int row, CarveSVGDocument* document, CarveSVGNode* parent) :
+	CarveSVGNode(element, row, document, svgPolygon, parent)
 {
-    bool bOk = false;
-    bool bInvalidCoords = false;
-    QPainterPath polygon;
-    QStringList coords(getListTrait(element, "points", &bOk));
-    // must parse ok, must have an even number of coordinates
-    if(bOk && coords.size() > 0 && coords.size() % 2 == 0) {
-	for(int i = 0; i < coords.size() && !bInvalidCoords; i += 2) {
-	    bool xok, yok;
-	    double x = coords.at(i).toDouble(&xok);
-	    double y = coords.at(i+1).toDouble(&yok);
-
-	    if(xok && yok) {
-                if(i == 0) {
-                    polygon.moveTo(x,y);
-                }
-                else {
-                    polygon.lineTo(x,y);
-                }
-	    }
-	    else {
-		bInvalidCoords = true;
-	    }
-	}
+    this->path_ = document->pathCache()->geometry(element, AtomPolygon, &this->levels_);
+}
 
-	if(bInvalidCoords) {
-	    // clear any points we accumulated
-	    polygon = QPainterPath();
-	}
-        else {
-            polygon.closeSubpath();
-        }
-    }
+CarvePolygonElement::~CarvePolygonElement() {
+}
 
-    if(getTrait(element, "fill-rule", &bOk) == "evenodd") {
-	polygon.setFillRule(Qt::OddEvenFill);
-    }
-    else {
-	polygon.setFillRule(Qt::WindingFill);
-    }
+QRectF CarvePolygonElement::geometryBounds() {
+    return strokedBounds(this->path_.boundingRect());
+}
 
-    CarveGraphicsPathItem* item = new CarveGraphicsPathItem(window,polygon);
+QGraphicsItem* CarvePolygonElement::createItem() {
+    bool bOk = false;
+    CarvePathItem* item = this->document()->builder()->createPathItem(this->path_);
+    item->setLevels(this->levels_);
     finishDecorating(item);
     item->setData(0, qVariantFromValue(reinterpret_cast<void*>(this)));
-    this->getFillOpacity();
-    this->getStrokeLineCap();
-    this->getStrokeLineJoin();
-    this->getStrokeOpacity();
-    this->getStrokeWidth();
     item->setBrush(this->getFill(&bOk));
     item->setPen(this->getStroke(&bOk));
-}
-
-CarvePolygonElement::~CarvePolygonElement() {
+    return item;
 }
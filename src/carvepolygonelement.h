@@ -21,12 +21,21 @@
 #define CARVEPOLYGONELEMENT_H
 
 #include "carvesvgnode.h"
+#include "carvepathitem.h"
 
 class CarvePolygonElement : public CarveSVGNode
 {
 public:
-    CarvePolygonElement(const QDomElement& node, int row, CarveSVGWindow* window, CarveSVGNode* parent = 0);
+    CarvePolygonElement(const QDomElement& node, int row, CarveSVGDocument* document, CarveSVGNode* parent = 0);
     virtual ~CarvePolygonElement();
+protected:
+    virtual QGraphicsItem* createItem();
+    virtual QRectF geometryBounds();
+
+private:
+    QPainterPath path_;
+    // coarser outlines for display at low zoom, if it is long
+    QExplicitlySharedDataPointer<CarvePathLevels> levels_;
 };
 
 #endif // CARVEPOLYGONELEMENT_H
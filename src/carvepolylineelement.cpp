@@ -18,11 +18,11 @@
 
 */
 #include "carvepolylineelement.h"
+#include "carvesvgdocument.h"
+#include "carvescenebuilder.h"
 #include "carvesvgnode.h"
-#include "carvesvgwindow.h"
-#include "carvescene.h"
 #include "domhelper.h"
-#include "carvegraphicsitems.h"
+#include "carveatoms.h"
 
 #include <QDomNode>
 #include <QGraphicsPathItem>
@@ -30,68 +30,26 @@
 #include <QPen>
 #include <QGraphicsScene>
 
-#include <iostream>
-using std::cout;
-using std::endl;
-
-CarvePolylineElement::CarvePolylineElement(const QDomElement& element, int row, CarveSVGWindow* window, CarveSVGNode* parent) :
-	CarveSVGNode(element, row, window, svgPolyline, parent)
+CarvePolylineElement::CarvePolylineElement(const QDomElement& element, int row, CarveSVGDocument* document, CarveSVGNode* parent) :
+	CarveSVGNode(element, row, document, svgPolyline, parent)
 {
-    bool bOk = false;
-    bool bInvalidCoords = false;
-    QPainterPath path;
-    QColor fill, stroke;
-    double startx = 0, starty = 0;
-    QStringList coords(getListTrait(element, "points", &bOk));
-    // must parse ok, must have an even number of coordinates
-    if(bOk && coords.size() > 0 && coords.size() % 2 == 0) {
-	for(int i = 0; i < coords.size() && !bInvalidCoords; i += 2) {
-	    bool xok, yok;
-	    double x = coords.at(i).toDouble(&xok);
-	    double y = coords.at(i+1).toDouble(&yok);
-
-	    if(xok && yok) {
-		if(i == 0) {
-		    startx = x;
-		    starty = y;
-		    path.moveTo(x,y);
-		}
-		else {
-		    path.lineTo(x,y);
-		}
-	    }
-	    else {
-		bInvalidCoords = true;
-	    }
-	}
+    this->path_ = document->pathCache()->geometry(element, AtomPolyline, &this->levels_);
+}
 
-	if(!bInvalidCoords) {
-	    path.moveTo(startx, starty);
-	}
-	else {
-	    // clear any points we accumulated
-	    path = QPainterPath();
-	}
-    }
+CarvePolylineElement::~CarvePolylineElement() {
+}
 
-    if(getTrait(element, "fill-rule", &bOk) == "evenodd") {
-	path.setFillRule(Qt::OddEvenFill);
-    }
-    else {
-	path.setFillRule(Qt::WindingFill);
-    }
+QRectF CarvePolylineElement::geometryBounds() {
+    return strokedBounds(this->path_.boundingRect());
+}
 
-    CarveGraphicsPathItem* item = new CarveGraphicsPathItem(window,path);
+QGraphicsItem* CarvePolylineElement::createItem() {
+    bool bOk = false;
+    CarvePathItem* item = this->document()->builder()->createPathItem(this->path_);
+    item->setLevels(this->levels_);
     finishDecorating(item);
     item->setData(0, qVariantFromValue(reinterpret_cast<void*>(this)));
-    this->getFillOpacity();
-    this->getStrokeLineCap();
-    this->getStrokeLineJoin();
-    this->getStrokeOpacity();
-    this->getStrokeWidth();
     item->setBrush(this->getFill(&bOk));
     item->setPen(this->getStroke(&bOk));
-}
-
-CarvePolylineElement::~CarvePolylineElement() {
+    return item;
 }
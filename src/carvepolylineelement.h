@@ -21,12 +21,21 @@
 #define CARVEPOLYLINEELEMENT_H
 
 #include "carvesvgnode.h"
+#include "carvepathitem.h"
 
 class CarvePolylineElement : public CarveSVGNode
 {
 public:
-    CarvePolylineElement(const QDomElement& node, int row, CarveSVGWindow* window, CarveSVGNode* parent = 0);
+    CarvePolylineElement(const QDomElement& node, int row, CarveSVGDocument* document, CarveSVGNode* parent = 0);
     virtual ~CarvePolylineElement();
+protected:
+    virtual QGraphicsItem* createItem();
+    virtual QRectF geometryBounds();
+
+private:
+    QPainterPath path_;
+    // coarser outlines for display at low zoom, if it is long
+    QExplicitlySharedDataPointer<CarvePathLevels> levels_;
 };
 
 #endif // CARVEPOLYLINEELEMENT_H
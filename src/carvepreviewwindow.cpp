@@ -23,10 +23,6 @@
 #include <QGridLayout>
 #include <QGraphicsSvgItem>
 
-#include <iostream>
-using std::cout;
-using std::endl;
-
 CarvePreviewWindow::CarvePreviewWindow(QWidget* parent, const QString& filename) :
         QDialog(parent, Qt::Window | Qt::Dialog | Qt::Popup), view(0)
 {
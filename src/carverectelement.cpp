@@ -19,10 +19,10 @@
 */
 #include "carvesvgnode.h"
 #include "carverectelement.h"
-#include "carvesvgwindow.h"
-#include "carvescene.h"
+#include "carvesvgdocument.h"
+#include "carvescenebuilder.h"
 #include "domhelper.h"
-#include "carvegraphicsitems.h"
+#include "carveatoms.h"
 
 #include <QDomNode>
 #include <QGraphicsRectItem>
@@ -30,46 +30,47 @@
 #include <QPen>
 #include <QGraphicsScene>
 
-#include <iostream>
-using std::cout;
-using std::endl;
-
-CarveRectElement::CarveRectElement(const QDomElement& node, int row, CarveSVGWindow* window, CarveSVGNode* parent) :
-    CarveSVGNode(node, row, window, svgRect, parent)
+CarveRectElement::CarveRectElement(const QDomElement& node, int row, CarveSVGDocument* document, CarveSVGNode* parent) :
+    CarveSVGNode(node, row, document, svgRect, parent)
 {
     bool bOk = false;
 
-    qreal x = getFloatTrait(node, "x",&bOk);
+    qreal x = getFloatTrait(node, AtomX,&bOk);
     if(!bOk) {
 	x = 0.0;
     }
 
-    qreal y = getFloatTrait(node, "y",&bOk);
+    qreal y = getFloatTrait(node, AtomY,&bOk);
     if(!bOk) {
 	y = 0.0;
     }
 
-    qreal width = getFloatTrait(node, "width",&bOk);
+    qreal width = getFloatTrait(node, AtomWidth,&bOk);
     if(!bOk) {
 	width = 0.0;
     }
 
-    qreal height = getFloatTrait(node, "height",&bOk);
+    qreal height = getFloatTrait(node, AtomHeight,&bOk);
     if(!bOk) {
 	height = 0.0;
     }
 
-    CarveGraphicsRectItem* item = new CarveGraphicsRectItem(window, x, y, width, height);
+    this->rect_ = QRectF(x, y, width, height);
+}
+
+CarveRectElement::~CarveRectElement() {
+}
+
+QRectF CarveRectElement::geometryBounds() {
+    return strokedBounds(this->rect_);
+}
+
+QGraphicsItem* CarveRectElement::createItem() {
+    bool bOk = false;
+    QGraphicsRectItem* item = this->document()->builder()->createRectItem(this->rect_);
     finishDecorating(item);
     item->setData(0, qVariantFromValue(reinterpret_cast<void*>(this)));
-    this->getFillOpacity();
-    this->getStrokeLineCap();
-    this->getStrokeLineJoin();
-    this->getStrokeOpacity();
-    this->getStrokeWidth();
     item->setBrush(this->getFill(&bOk));
     item->setPen(this->getStroke(&bOk));
-}
-
-CarveRectElement::~CarveRectElement() {
+    return item;
 }
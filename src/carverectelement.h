@@ -25,8 +25,14 @@
 class CarveRectElement : public CarveSVGNode
 {
 public:
-    CarveRectElement(const QDomElement& node, int row, CarveSVGWindow* window, CarveSVGNode* parent = 0);
+    CarveRectElement(const QDomElement& node, int row, CarveSVGDocument* document, CarveSVGNode* parent = 0);
     virtual ~CarveRectElement();
+protected:
+    virtual QGraphicsItem* createItem();
+    virtual QRectF geometryBounds();
+
+private:
+    QRectF rect_;
 };
 
 #endif // CARVERECTELEMENT_H
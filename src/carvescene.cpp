@@ -4,10 +4,6 @@
 
 #include <QGraphicsItem>
 
-#include <iostream>
-using std::cout;
-using std::endl;
-
 CarveScene::CarveScene(CarveWindow* window) :
 	QGraphicsScene(),
 	mainwindow_(window)
@@ -15,8 +11,11 @@ CarveScene::CarveScene(CarveWindow* window) :
     setBackgroundBrush(QBrush(QColor(224,224,224)));
 
     connect(this, SIGNAL(selectionChanged()), this, SLOT(selectNode()));
-    connect(mainwindow_, SIGNAL(nodeSelected(CarveSVGNode*)), this, SLOT(nodeSelected(CarveSVGNode*)));
-    connect(mainwindow_, SIGNAL(nodeDeleted(CarveSVGNode*)), this, SLOT(nodeDeleted(CarveSVGNode*)));
+    // there is no main window when documents are built headless (e.g. by the benchmarks)
+    if(mainwindow_) {
+	connect(mainwindow_, SIGNAL(nodeSelected(CarveSVGNode*)), this, SLOT(nodeSelected(CarveSVGNode*)));
+	connect(mainwindow_, SIGNAL(nodeDeleted(CarveSVGNode*)), this, SLOT(nodeDeleted(CarveSVGNode*)));
+    }
 }
 
 void CarveScene::selectNode() {
@@ -26,13 +25,14 @@ void CarveScene::selectNode() {
 	if(!item) { return; }
 	CarveSVGNode* node = reinterpret_cast<CarveSVGNode*>(item->data(0).value<void*>());
 	if(!node) { return; }
-	mainwindow_->selectNode(node);
+	if(mainwindow_) { mainwindow_->selectNode(node); }
     }
 }
 
 // this slot catches the nodeSelected() signal coming from main window
 void CarveScene::nodeSelected(CarveSVGNode* node) {
-    if(!node || !node->gfxItem()) {
+    // a node picked in the DOM Browser may be outside the part of the scene built so far
+    if(!node || !node->realize()) {
 	this->clearSelection();
 	return;
     }
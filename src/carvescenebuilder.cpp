@@ -0,0 +1,56 @@
+#include "carvescenebuilder.h"
+#include "carveuseitem.h"
+#include "carvepathitem.h"
+#include "carveimageitem.h"
+
+#include <QGraphicsScene>
+#include <QGraphicsRectItem>
+#include <QGraphicsEllipseItem>
+#include <QGraphicsLineItem>
+#include <QGraphicsPathItem>
+
+CarveSceneBuilder::CarveSceneBuilder() :
+	scene_(NULL)
+{
+}
+
+CarveSceneBuilder::~CarveSceneBuilder() {
+    delete scene_;
+}
+
+QGraphicsScene* CarveSceneBuilder::scene() {
+    if(!scene_) {
+	scene_ = new QGraphicsScene();
+    }
+    return scene_;
+}
+
+void CarveSceneBuilder::reset() {
+    if(scene_) {
+	scene_->clear();
+    }
+}
+
+QGraphicsRectItem* CarveSceneBuilder::createRectItem(const QRectF& rect) {
+    return new QGraphicsRectItem(rect);
+}
+
+QGraphicsEllipseItem* CarveSceneBuilder::createEllipseItem(const QRectF& rect) {
+    return new QGraphicsEllipseItem(rect);
+}
+
+QGraphicsLineItem* CarveSceneBuilder::createLineItem(const QLineF& line) {
+    return new QGraphicsLineItem(line);
+}
+
+CarvePathItem* CarveSceneBuilder::createPathItem(const QPainterPath& path) {
+    return new CarvePathItem(path);
+}
+
+QGraphicsItem* CarveSceneBuilder::createImageItem(const QImage& image) {
+    return new CarveImageItem(image);
+}
+
+CarveUseItem* CarveSceneBuilder::createUseItem(const QExplicitlySharedDataPointer<CarveUseGeometry>& geometry) {
+    return new CarveUseItem(geometry);
+}
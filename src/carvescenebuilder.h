@@ -0,0 +1,52 @@
+#ifndef CARVESCENEBUILDER_H
+#define CARVESCENEBUILDER_H
+
+#include <QRectF>
+#include <QLineF>
+#include <QPainterPath>
+#include <QImage>
+#include <QExplicitlySharedDataPointer>
+
+class QGraphicsScene;
+class QGraphicsItem;
+class QGraphicsRectItem;
+class QGraphicsEllipseItem;
+class QGraphicsLineItem;
+class CarvePathItem;
+class CarveUseItem;
+class CarveUseGeometry;
+
+// The nodes of a CarveSVGDocument ask the document's scene builder for their
+// graphics items instead of creating them directly, so that the model does not
+// depend on the editor.  This default implementation creates plain items in a
+// scene of its own, which is all a headless user (renderer, benchmarks) needs
+// (given a QApplication, which Qt 4 requires for any QGraphicsScene); the
+// editor substitutes items that know about their window.
+class CarveSceneBuilder
+{
+public:
+    CarveSceneBuilder();
+    virtual ~CarveSceneBuilder();
+
+    // the scene the <svg> element's canvas is added to
+    virtual QGraphicsScene* scene();
+    // called before the document's model is thrown away and rebuilt
+    virtual void reset();
+
+    virtual QGraphicsRectItem* createRectItem(const QRectF& rect);
+    virtual QGraphicsEllipseItem* createEllipseItem(const QRectF& rect);
+    virtual QGraphicsLineItem* createLineItem(const QLineF& line);
+    virtual CarvePathItem* createPathItem(const QPainterPath& path);
+    // a CarveImageItem here; the image is only made a pixmap by a builder for the screen
+    virtual QGraphicsItem* createImageItem(const QImage& image);
+    virtual CarveUseItem* createUseItem(const QExplicitlySharedDataPointer<CarveUseGeometry>& geometry);
+
+private:
+    // unimplemented to prevent copying
+    CarveSceneBuilder& operator=(const CarveSceneBuilder&);
+    CarveSceneBuilder(const CarveSceneBuilder&);
+
+    QGraphicsScene* scene_;
+};
+
+#endif // CARVESCENEBUILDER_H
@@ -0,0 +1,191 @@
+#include "carvestyle.h"
+#include "carveparse.h"
+
+namespace {
+
+const char* const PROPERTY_NAMES[NumStyleProperties] = {
+    "fill",
+    "fill-opacity",
+    "fill-rule",
+    "stroke",
+    "stroke-opacity",
+    "stroke-width",
+    "stroke-linecap",
+    "stroke-linejoin",
+    "opacity",
+    "font-size",
+    "font-family",
+    "stop-color",
+    "stop-opacity",
+    "solid-color",
+    "display",
+    "visibility"
+};
+
+inline int bitCount(quint32 v) {
+    v = v - ((v >> 1) & 0x55555555u);
+    v = (v & 0x33333333u) + ((v >> 2) & 0x33333333u);
+    return (((v + (v >> 4)) & 0x0f0f0f0fu) * 0x01010101u) >> 24;
+}
+
+// skips whitespace and /* comments */
+void skipWhitespaceAndComments(const QChar*& pos, const QChar* end) {
+    for(;;) {
+	skipWhitespace(pos, end);
+	if(end - pos >= 2 && pos[0].unicode() == '/' && pos[1].unicode() == '*') {
+	    pos += 2;
+	    while(end - pos >= 2 && !(pos[0].unicode() == '*' && pos[1].unicode() == '/')) { ++pos; }
+	    pos = (end - pos >= 2) ? pos + 2 : end;
+	}
+	else {
+	    return;
+	}
+    }
+}
+
+// Reads up to (but not including) the next top-level stop character or ';'.
+// Quoted strings and parentheses are taken as a whole, comments are dropped,
+// runs of whitespace collapse to one space and the ends are trimmed.
+QString readUntil(const QChar*& pos, const QChar* end, ushort stop) {
+    QString result;
+    bool bPendingSpace = false;
+    int parens = 0;
+    skipWhitespaceAndComments(pos, end);
+    while(pos < end) {
+	ushort c = pos->unicode();
+	if(parens == 0 && (c == stop || c == ';')) { break; }
+
+	if(c == '/' && pos + 1 < end && pos[1].unicode() == '*') {
+	    skipWhitespaceAndComments(pos, end);
+	    bPendingSpace = true;
+	    continue;
+	}
+	if(isSVGWhitespace(*pos)) {
+	    bPendingSpace = true;
+	    ++pos;
+	    continue;
+	}
+	if(bPendingSpace && !result.isEmpty()) { result += QChar(' '); }
+	bPendingSpace = false;
+
+	if(c == '"' || c == '\'') {
+	    const QChar* start = pos++;
+	    while(pos < end && pos->unicode() != c) {
+		if(pos->unicode() == '\\' && pos + 1 < end) { ++pos; }
+		++pos;
+	    }
+	    if(pos < end) { ++pos; }
+	    result += QString(start, pos - start);
+	    continue;
+	}
+	if(c == '(') { ++parens; }
+	else if(c == ')' && parens > 0) { --parens; }
+	result += *pos;
+	++pos;
+    }
+    return result;
+}
+
+}
+
+CarveStyleProperty CarveStyleBlock::propertyFromName(const QString& name) {
+    for(int p = 0; p < NumStyleProperties; ++p) {
+	const char* n = PROPERTY_NAMES[p];
+	int i = 0;
+	for(; i < name.size() && n[i]; ++i) {
+	    ushort c = name.at(i).unicode();
+	    if(c >= 'A' && c <= 'Z') { c += 'a' - 'A'; }
+	    if(c != ushort(n[i])) { break; }
+	}
+	if(i == name.size() && !n[i]) { return CarveStyleProperty(p); }
+    }
+    return NumStyleProperties;
+}
+
+CarveStyleBlock* CarveStyleBlock::parse(const QString& text) {
+    CarveStyleBlock* block = NULL;
+    const QChar* pos = text.constData();
+    const QChar* end = pos + text.size();
+
+    while(pos < end) {
+	QString name = readUntil(pos, end, ':');
+	if(pos >= end || pos->unicode() != ':') {
+	    // a declaration without a value: skip past the ';'
+	    if(pos < end) { ++pos; }
+	    continue;
+	}
+	++pos;
+	QString value = readUntil(pos, end, ';');
+	if(pos < end) { ++pos; }
+
+	bool bImportant = false;
+	int bang = value.lastIndexOf('!');
+	if(bang >= 0 && value.mid(bang + 1).trimmed().compare("important", Qt::CaseInsensitive) == 0) {
+	    bImportant = true;
+	    value = value.left(bang).trimmed();
+	}
+
+	CarveStyleProperty property = propertyFromName(name);
+	if(property == NumStyleProperties || value.isEmpty()) { continue; }
+
+	if(!block) { block = new CarveStyleBlock(); }
+	// a later declaration wins, unless only the earlier one is !important
+	if(block->isImportant(property) && !bImportant) { continue; }
+	block->set(property, value, bImportant);
+    }
+    return block;
+}
+
+int CarveStyleBlock::indexOf(CarveStyleProperty property) const {
+    return bitCount(present_ & ((1u << property) - 1));
+}
+
+void CarveStyleBlock::set(CarveStyleProperty property, const QString& value, bool bImportant) {
+    Entry entry;
+    entry.value = value;
+
+    // only a complete plain number counts as numeric
+    const QChar* pos = value.constData();
+    const QChar* end = pos + value.size();
+    entry.bNumber = parseNumber(pos, end, &entry.number) && pos == end;
+    if(!entry.bNumber) { entry.number = 0; }
+    store(property, entry, bImportant);
+}
+
+void CarveStyleBlock::store(CarveStyleProperty property, const Entry& entry, bool bImportant) {
+    int index = indexOf(property);
+    if(has(property)) {
+	entries_[index] = entry;
+    }
+    else {
+	entries_.insert(index, entry);
+	present_ |= (1u << property);
+    }
+    if(bImportant) { important_ |= (1u << property); }
+    else { important_ &= ~(1u << property); }
+}
+
+void CarveStyleBlock::apply(const CarveStyleBlock& other) {
+    for(int p = 0; p < NumStyleProperties; ++p) {
+	CarveStyleProperty property = CarveStyleProperty(p);
+	if(!other.has(property)) { continue; }
+	bool bImportant = other.isImportant(property);
+	if(isImportant(property) && !bImportant) { continue; }
+	store(property, other.entries_.at(other.indexOf(property)), bImportant);
+    }
+}
+
+QString CarveStyleBlock::value(CarveStyleProperty property) const {
+    if(!has(property)) { return QString(); }
+    return entries_.at(indexOf(property)).value;
+}
+
+double CarveStyleBlock::number(CarveStyleProperty property, bool* bOk) const {
+    if(!has(property)) {
+	if(bOk) { *bOk = false; }
+	return 0;
+    }
+    const Entry& entry = entries_.at(indexOf(property));
+    if(bOk) { *bOk = entry.bNumber; }
+    return entry.number;
+}
@@ -0,0 +1,73 @@
+#ifndef CARVESTYLE_H
+#define CARVESTYLE_H
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+// the presentation properties Carve understands in a style attribute
+enum CarveStyleProperty {
+    StyleFill,
+    StyleFillOpacity,
+    StyleFillRule,
+    StyleStroke,
+    StyleStrokeOpacity,
+    StyleStrokeWidth,
+    StyleStrokeLineCap,
+    StyleStrokeLineJoin,
+    StyleOpacity,
+    StyleFontSize,
+    StyleFontFamily,
+    StyleStopColor,
+    StyleStopOpacity,
+    StyleSolidColor,
+    StyleDisplay,
+    StyleVisibility,
+    NumStyleProperties
+};
+
+// The declarations of one style attribute, parsed once.  Only the properties
+// that are present are stored; a presence mask turns a lookup into an index
+// into that dense array.  Each value is kept as the string parsed for this
+// block (blocks cascaded from it share it implicitly), and numeric values
+// are converted up front.
+class CarveStyleBlock
+{
+public:
+    CarveStyleBlock() : present_(0), important_(0) {}
+
+    // returns NULL if the text declares none of the properties above
+    static CarveStyleBlock* parse(const QString& text);
+
+    // cascades other on top of this block: its declarations replace ours
+    // unless only ours are !important
+    void apply(const CarveStyleBlock& other);
+    bool isEmpty() const { return present_ == 0; }
+
+    bool has(CarveStyleProperty property) const { return present_ & (1u << property); }
+    bool isImportant(CarveStyleProperty property) const { return important_ & (1u << property); }
+    // empty if the property is not present
+    QString value(CarveStyleProperty property) const;
+    // the value as a plain number; bOk is false if it is absent or not a number
+    double number(CarveStyleProperty property, bool* bOk = NULL) const;
+
+    // property name (case-insensitive) to enum, NumStyleProperties if unknown
+    static CarveStyleProperty propertyFromName(const QString& name);
+
+private:
+    struct Entry {
+	QString value;
+	double number;
+	bool bNumber;
+    };
+
+    int indexOf(CarveStyleProperty property) const;
+    void set(CarveStyleProperty property, const QString& value, bool bImportant);
+    void store(CarveStyleProperty property, const Entry& entry, bool bImportant);
+
+    quint32 present_;
+    quint32 important_;
+    QVector<Entry> entries_;
+};
+
+#endif // CARVESTYLE_H
@@ -0,0 +1,358 @@
+#include "carvestylesheet.h"
+#include "carvestyle.h"
+#include "carveparse.h"
+#include "carvelog.h"
+#include "profiler.h"
+#include "carveatoms.h"
+
+#include <QtAlgorithms>
+
+namespace {
+
+bool isIdentChar(const QChar& c) {
+    ushort u = c.unicode();
+    return (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') || (u >= '0' && u <= '9')
+	    || u == '-' || u == '_' || u >= 0x80;
+}
+
+QString readIdent(const QChar*& pos, const QChar* end) {
+    const QChar* start = pos;
+    while(pos < end && isIdentChar(*pos)) { ++pos; }
+    return QString(start, pos - start);
+}
+
+// skips whitespace and /* comments */
+void skipWhitespaceAndComments(const QChar*& pos, const QChar* end) {
+    for(;;) {
+	skipWhitespace(pos, end);
+	if(end - pos >= 2 && pos[0].unicode() == '/' && pos[1].unicode() == '*') {
+	    pos += 2;
+	    while(end - pos >= 2 && !(pos[0].unicode() == '*' && pos[1].unicode() == '/')) { ++pos; }
+	    pos = (end - pos >= 2) ? pos + 2 : end;
+	}
+	else {
+	    return;
+	}
+    }
+}
+
+// Reads up to (but not including) the '}' that closes a block whose '{' was
+// just consumed, skipping over quoted strings and nested blocks.
+QString readBlock(const QChar*& pos, const QChar* end) {
+    const QChar* start = pos;
+    int depth = 0;
+    while(pos < end) {
+	ushort c = pos->unicode();
+	if(c == '"' || c == '\'') {
+	    for(++pos; pos < end && pos->unicode() != c; ++pos) {
+		if(pos->unicode() == '\\' && pos + 1 < end) { ++pos; }
+	    }
+	}
+	else if(c == '{') { ++depth; }
+	else if(c == '}') {
+	    if(depth == 0) { break; }
+	    --depth;
+	}
+	if(pos < end) { ++pos; }
+    }
+    QString block(start, pos - start);
+    if(pos < end) { ++pos; }
+    return block;
+}
+
+// @-rules (@media, @font-face, @import...) are not supported: skip the statement or block
+void skipAtRule(const QChar*& pos, const QChar* end) {
+    while(pos < end) {
+	ushort c = pos->unicode();
+	++pos;
+	if(c == ';') { return; }
+	if(c == '{') {
+	    readBlock(pos, end);
+	    return;
+	}
+    }
+}
+
+// whether the whitespace-separated list classAttr contains name
+bool hasClass(const QString& classAttr, const QString& name) {
+    int from = 0;
+    for(;;) {
+	int index = classAttr.indexOf(name, from);
+	if(index < 0) { return false; }
+	int after = index + name.size();
+	if((index == 0 || isSVGWhitespace(classAttr.at(index - 1)))
+		&& (after == classAttr.size() || isSVGWhitespace(classAttr.at(after)))) {
+	    return true;
+	}
+	from = index + 1;
+    }
+}
+
+}
+
+CarveStyleSheet::CarveStyleSheet() {
+}
+
+CarveStyleSheet::~CarveStyleSheet() {
+    clear();
+}
+
+void CarveStyleSheet::clear() {
+    qDeleteAll(blocks_);
+    blocks_.clear();
+    qDeleteAll(computed_);
+    computed_.clear();
+    rules_.clear();
+    idRules_.clear();
+    classRules_.clear();
+    tagRules_.clear();
+    universalRules_.clear();
+}
+
+void CarveStyleSheet::addStyleSheet(const QString& css) {
+    CARVE_PROFILE("addStyleSheet");
+    const QChar* pos = css.constData();
+    const QChar* end = pos + css.size();
+
+    for(;;) {
+	skipWhitespaceAndComments(pos, end);
+	if(pos >= end) { break; }
+
+	if(pos->unicode() == '@') {
+	    skipAtRule(pos, end);
+	    continue;
+	}
+
+	// the selector group, with any comments removed
+	QString selectors;
+	while(pos < end && pos->unicode() != '{') {
+	    if(end - pos >= 2 && pos[0].unicode() == '/' && pos[1].unicode() == '*') {
+		skipWhitespaceAndComments(pos, end);
+		selectors += QChar(' ');
+		continue;
+	    }
+	    selectors += *pos;
+	    ++pos;
+	}
+	if(pos >= end) {
+	    CARVE_WARNING(LogStyle, QString("Style rule '%1' has no declaration block").arg(selectors.trimmed()));
+	    break;
+	}
+	++pos;
+	QString declarations = readBlock(pos, end);
+
+	// a group with a selector we do not understand is dropped as a whole, as in CSS
+	QVector<Rule> group;
+	QStringList parts = selectors.split(',');
+	bool bOk = true;
+	for(int i = 0; i < parts.size() && bOk; ++i) {
+	    Rule rule;
+	    bOk = parseSelector(parts.at(i), &rule);
+	    group << rule;
+	}
+	if(!bOk) {
+	    CARVE_DEBUG(LogStyle, QString("Ignoring style rule with unsupported selector '%1'").arg(selectors.trimmed()));
+	    continue;
+	}
+
+	CarveStyleBlock* block = CarveStyleBlock::parse(declarations);
+	if(!block) { continue; }
+	blocks_ << block;
+
+	for(int i = 0; i < group.size(); ++i) {
+	    Rule& rule = group[i];
+	    rule.block = block;
+	    int index = rules_.size();
+	    rules_ << rule;
+
+	    // file the rule under the most selective part of its subject
+	    const Compound& subject = rule.compounds.last();
+	    if(!subject.id.isEmpty()) { idRules_[subject.id] << index; }
+	    else if(!subject.classes.isEmpty()) { classRules_[subject.classes.first()] << index; }
+	    else if(!subject.tag.isEmpty()) { tagRules_[subject.tag] << index; }
+	    else { universalRules_ << index; }
+	}
+    }
+}
+
+bool CarveStyleSheet::parseSelector(const QString& text, Rule* rule) {
+    rule->specificity = 0;
+    rule->block = NULL;
+    const QChar* pos = text.constData();
+    const QChar* end = pos + text.size();
+
+    skipWhitespace(pos, end);
+    for(;;) {
+	Compound compound;
+	if(!parseCompound(pos, end, &compound, &rule->specificity)) { return false; }
+	rule->compounds << compound;
+
+	const QChar* before = pos;
+	skipWhitespace(pos, end);
+	if(pos >= end) { return true; }
+
+	if(pos->unicode() == '>') {
+	    ++pos;
+	    skipWhitespace(pos, end);
+	    rule->combinators << '>';
+	}
+	else if(pos != before) {
+	    rule->combinators << ' ';
+	}
+	else {
+	    // attribute selectors, pseudo-classes, sibling combinators...
+	    return false;
+	}
+    }
+}
+
+bool CarveStyleSheet::parseCompound(const QChar*& pos, const QChar* end, Compound* compound, int* specificity) {
+    bool bAny = false;
+    if(pos < end && pos->unicode() == '*') {
+	++pos;
+	bAny = true;
+    }
+    else if(pos < end && isIdentChar(*pos)) {
+	compound->tag = readIdent(pos, end);
+	*specificity += 1;
+	bAny = true;
+    }
+
+    while(pos < end) {
+	ushort c = pos->unicode();
+	if(c == '#' || c == '.') {
+	    ++pos;
+	    QString name = readIdent(pos, end);
+	    if(name.isEmpty()) { return false; }
+	    if(c == '#') {
+		// two different ids can never match; keeping the last one is harmless
+		compound->id = name;
+		*specificity += 10000;
+	    }
+	    else {
+		compound->classes << name;
+		*specificity += 100;
+	    }
+	    bAny = true;
+	}
+	else {
+	    break;
+	}
+    }
+    return bAny;
+}
+
+bool CarveStyleSheet::matchesCompound(const Compound& compound, const QDomElement& elem) {
+    if(!compound.tag.isEmpty() && elem.tagName() != compound.tag) { return false; }
+    if(!compound.id.isEmpty() && elem.attribute(CarveAtoms::name(AtomId)) != compound.id) { return false; }
+    if(!compound.classes.isEmpty()) {
+	QString classAttr = elem.attribute(CarveAtoms::name(AtomClass));
+	for(int i = 0; i < compound.classes.size(); ++i) {
+	    if(!hasClass(classAttr, compound.classes.at(i))) { return false; }
+	}
+    }
+    return true;
+}
+
+bool CarveStyleSheet::matchesAncestors(const Rule& rule, int i, const QDomElement& elem) const {
+    if(i == 0) { return true; }
+
+    const Compound& compound = rule.compounds.at(i - 1);
+    bool bChild = rule.combinators.at(i - 1) == '>';
+    QDomElement ancestor = elem.parentNode().toElement();
+    while(!ancestor.isNull()) {
+	if(matchesCompound(compound, ancestor) && matchesAncestors(rule, i - 1, ancestor)) {
+	    return true;
+	}
+	if(bChild) { return false; }
+	ancestor = ancestor.parentNode().toElement();
+    }
+    return false;
+}
+
+// the key sorts rules by specificity first and then by their position in the sheet
+void CarveStyleSheet::addCandidates(const QVector<int>& rules, QVector<qint64>* candidates) const {
+    for(int i = 0; i < rules.size(); ++i) {
+	int index = rules.at(i);
+	*candidates << ((qint64(rules_.at(index).specificity) << 32) | index);
+    }
+}
+
+void CarveStyleSheet::addCandidates(const QHash<QString, QVector<int> >& bucket, const QString& key, QVector<qint64>* candidates) const {
+    QHash<QString, QVector<int> >::const_iterator it = bucket.constFind(key);
+    if(it != bucket.constEnd()) {
+	addCandidates(it.value(), candidates);
+    }
+}
+
+const CarveStyleBlock* CarveStyleSheet::computeStyle(const QDomElement& elem, const QString& inlineStyle) const {
+    // the matching rules, in cascade order
+    QVector<int> matched;
+
+    if(!rules_.isEmpty()) {
+	QVector<qint64> candidates;
+	QString id = elem.attribute(CarveAtoms::name(AtomId));
+	if(!id.isEmpty()) { addCandidates(idRules_, id, &candidates); }
+
+	QString classAttr = elem.attribute(CarveAtoms::name(AtomClass));
+	const QChar* pos = classAttr.constData();
+	const QChar* end = pos + classAttr.size();
+	for(;;) {
+	    skipWhitespace(pos, end);
+	    if(pos >= end) { break; }
+	    const QChar* start = pos;
+	    while(pos < end && !isSVGWhitespace(*pos)) { ++pos; }
+	    addCandidates(classRules_, QString(start, pos - start), &candidates);
+	}
+
+	addCandidates(tagRules_, elem.tagName(), &candidates);
+	addCandidates(universalRules_, &candidates);
+
+	// a class listed twice would otherwise apply its rules twice
+	qSort(candidates);
+	qint64 previous = -1;
+	for(int i = 0; i < candidates.size(); ++i) {
+	    if(candidates.at(i) == previous) { continue; }
+	    previous = candidates.at(i);
+
+	    int index = int(previous & 0xffffffff);
+	    const Rule& rule = rules_.at(index);
+	    int subject = rule.compounds.size() - 1;
+	    if(matchesCompound(rule.compounds.at(subject), elem) && matchesAncestors(rule, subject, elem)) {
+		matched << index;
+	    }
+	}
+    }
+
+    if(matched.isEmpty() && inlineStyle.isEmpty()) { return NULL; }
+
+    // the same rules and style attribute always cascade to the same block
+    QString key(inlineStyle);
+    key.reserve(inlineStyle.size() + 1 + 2 * matched.size());
+    key += QChar(0);
+    for(int i = 0; i < matched.size(); ++i) {
+	key += QChar(ushort(matched.at(i) & 0xffff));
+	key += QChar(ushort(matched.at(i) >> 16));
+    }
+    QHash<QString, CarveStyleBlock*>::const_iterator it = computed_.constFind(key);
+    if(it != computed_.constEnd()) { return it.value(); }
+
+    CarveStyleBlock* style = NULL;
+    for(int i = 0; i < matched.size(); ++i) {
+	if(!style) { style = new CarveStyleBlock(); }
+	style->apply(*rules_.at(matched.at(i)).block);
+    }
+    if(!inlineStyle.isEmpty()) {
+	CarveStyleBlock* inlineBlock = CarveStyleBlock::parse(inlineStyle);
+	if(!style) {
+	    style = inlineBlock;
+	}
+	else if(inlineBlock) {
+	    style->apply(*inlineBlock);
+	    delete inlineBlock;
+	}
+    }
+    // NULL is remembered too, so a style attribute we have no use for is only parsed once
+    computed_.insert(key, style);
+    return style;
+}
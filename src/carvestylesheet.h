@@ -0,0 +1,75 @@
+#ifndef CARVESTYLESHEET_H
+#define CARVESTYLESHEET_H
+
+#include <QDomElement>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class CarveStyleBlock;
+
+// The rules of a document's <style> elements.  Each rule is filed in a bucket
+// under the id, class or tag of its rightmost compound selector, so matching
+// an element only tests the rules that could possibly apply to it.
+//
+// Supported selectors: type, universal, #id and .class compounds joined by
+// descendant (whitespace) or child (>) combinators, in comma-separated groups.
+// Rules using anything else (attributes, pseudo-classes, siblings) are dropped.
+class CarveStyleSheet
+{
+public:
+    CarveStyleSheet();
+    ~CarveStyleSheet();
+
+    void clear();
+    // parses the text of one <style> element and appends its rules
+    void addStyleSheet(const QString& css);
+    int ruleCount() const { return rules_.size(); }
+
+    // the cascaded style of elem: matching rules in order of specificity and
+    // position, then the element's inline style attribute
+    // returns NULL if nothing is declared for the element
+    // Elements matching the same rules with the same style attribute share one
+    // block, which the stylesheet owns until clear().
+    const CarveStyleBlock* computeStyle(const QDomElement& elem, const QString& inlineStyle) const;
+
+private:
+    // unimplemented to prevent copying
+    CarveStyleSheet& operator=(const CarveStyleSheet&);
+    CarveStyleSheet(const CarveStyleSheet&);
+
+    struct Compound {
+	QString tag; // empty for the universal selector
+	QString id;
+	QStringList classes;
+    };
+
+    struct Rule {
+	QVector<Compound> compounds; // leftmost first
+	QVector<char> combinators;   // ' ' or '>' between compounds i and i+1
+	int specificity;
+	const CarveStyleBlock* block;
+    };
+
+    static bool parseSelector(const QString& text, Rule* rule);
+    static bool parseCompound(const QChar*& pos, const QChar* end, Compound* compound, int* specificity);
+    static bool matchesCompound(const Compound& compound, const QDomElement& elem);
+    // whether the ancestors of elem (which matched compound i) satisfy compounds 0..i-1
+    bool matchesAncestors(const Rule& rule, int i, const QDomElement& elem) const;
+    // appends the cascade order keys of the rules filed under key
+    void addCandidates(const QHash<QString, QVector<int> >& bucket, const QString& key, QVector<qint64>* candidates) const;
+    void addCandidates(const QVector<int>& rules, QVector<qint64>* candidates) const;
+
+    QVector<Rule> rules_;
+    QList<CarveStyleBlock*> blocks_;
+    QHash<QString, QVector<int> > idRules_;
+    QHash<QString, QVector<int> > classRules_;
+    QHash<QString, QVector<int> > tagRules_;
+    QVector<int> universalRules_;
+    // cascaded styles by inline style and matched rules (see computeStyle())
+    mutable QHash<QString, CarveStyleBlock*> computed_;
+};
+
+#endif // CARVESTYLESHEET_H
@@ -26,45 +26,100 @@
 
 #include "carvesvgdocument.h"
 #include "carvesvgnode.h"
-#include "carvesvgwindow.h"
 #include "carvesvgelement.h"
-#include "carvescene.h"
+#include "carvescenebuilder.h"
+#include "carvestylesheet.h"
+#include "carveuseelement.h"
+#include "carveuseitem.h"
+#include "profiler.h"
+#include "carvelog.h"
+#include "carveatoms.h"
 
-#include <iostream>
-using std::cout;
-using std::endl;
+#include <QTime>
+#include <QGraphicsItem>
 
-CarveSVGDocument::CarveSVGDocument(const QString& textContent, CarveSVGWindow* parent) :
-	QAbstractItemModel(parent), window_(parent)
+namespace {
+
+// element children are added to the views this many at a time, so expanding
+// a node with a hundred thousand children costs no more than one with a few
+const int FETCH_BATCH_SIZE = 256;
+
+}
+
+CarveSVGDocument::CarveSVGDocument(const QString& textContent, QObject* parent, CarveSceneBuilder* builder) :
+	QAbstractItemModel(parent), builder_(builder), styleSheet_(new CarveStyleSheet()),
+	bStoreValid_(false), bStoreStale_(false), bIdsIndexed_(false), parseTime_(0), storeParseTime_(0)
 {
+    if(!builder_) {
+	builder_ = new CarveSceneBuilder();
+    }
     root_ = NULL;
     setContent(textContent);
 }
 
 CarveSVGDocument::~CarveSVGDocument() {
-    delete root_;
+    arena_.reset();
+    useGeometries_.clear();
+    delete builder_;
+    delete styleSheet_;
 }
 
 bool CarveSVGDocument::setContent(const QString& text) {
-    /*
-    // wipe out scene
-    if(this->window()->scene()) {
-	this->window()->scene()->clear();
-    }
-    */
-
-    // wipe out old model
-    if(root_) delete root_;
+    CARVE_PROFILE("setContent");
+    errors_.clear();
+    CarveLogCollector collector(&errors_);
+
+    // wipe out old scene and model
+    builder_->reset();
+    // every node goes at once, and the memory is reused for the new ones
+    arena_.reset();
+    root_ = NULL;
+    useGeometries_.clear();
+    // the outlines stay cached; the counters are for this content's lookups
+    pathCache_.resetCounters();
+    fetchedRows_.clear();
+    ids_.clear();
+    bIdsIndexed_ = false;
 
     // set the QDomDocument's contents
     // TODO: use text.toUtf8() here?
     // we use namespace processing = false here to ensure that prefixes don't get munged around when re-serializing
     // (we want the namespace prefixes to be where we typed them)
-    bool bResult = this->doc_.setContent(text, false);
+    QTime parseTimer;
+    parseTimer.start();
+    QString errorMsg;
+    int errorLine = 0, errorColumn = 0;
+    bool bResult = this->doc_.setContent(text, false, &errorMsg, &errorLine, &errorColumn);
+    if(!bResult) {
+	CARVE_WARNING(LogParse, QString("Line %1, column %2: %3").arg(errorLine).arg(errorColumn).arg(errorMsg));
+    }
+    // an edit made through the model comes back as the text serialize() wrote
+    // from the store, which has followed the edit already
+    int domParseTime = parseTimer.elapsed();
+    if(!bStoreValid_ || bStoreStale_ || text != serialized_) {
+	// QDom expands the entities of an internal subset (as Illustrator declares
+	// styles: style="&st0;"), the store does not, so the DOM is used instead
+	bStoreValid_ = store_.setContent(text) && !store_.hasInternalSubset();
+	bStoreStale_ = false;
+    }
+    serialized_.clear();
+    parseTime_ = parseTimer.elapsed();
+    storeParseTime_ = parseTime_ - domParseTime;
+
+    // the stylesheet has to be complete before the first node is matched against it
+    styleSheet_->clear();
+    QDomNodeList styles = doc_.elementsByTagName("style");
+    for(int i = 0; i < styles.count(); ++i) {
+	QDomElement style = styles.item(i).toElement();
+	QString type = style.attribute(CarveAtoms::name(AtomType));
+	if(type.isEmpty() || type == "text/css") {
+	    styleSheet_->addStyleSheet(style.text());
+	}
+    }
 
     // set up new data model
 //    QDomElement rootDomNode(doc_.documentElement());
-    root_ = CarveSVGNode::createNode(doc_, 0, this->window_);
+    root_ = CarveSVGNode::createNode(doc_, 0, this);
 
     // inform all views that we've reset
     reset();
@@ -113,6 +168,8 @@ QModelIndex CarveSVGDocument::index(int row, int column, const QModelIndex& pare
         parentItem = static_cast<CarveSVGNode*>(parent.internalPointer());
     }
 
+    // the first request for a row creates its node
+    CarveLogCollector collector(&errors_);
     CarveSVGNode* childItem = parentItem->child(row);
     if(childItem) {
         return createIndex(row, column, childItem);
@@ -131,8 +188,61 @@ int CarveSVGDocument::rowCount(const QModelIndex& parent) const {
 	return 1;
     }
 
+    return fetchedRows_.value(static_cast<CarveSVGNode*>(parent.internalPointer()), 0);
+}
+
+bool CarveSVGDocument::hasChildren(const QModelIndex& parent) const {
+    if(parent.column() > 0) {
+	return false;
+    }
+    if(!parent.isValid()) {
+	return true;
+    }
+    return static_cast<CarveSVGNode*>(parent.internalPointer())->numChildren() > 0;
+}
+
+bool CarveSVGDocument::canFetchMore(const QModelIndex& parent) const {
+    if(!parent.isValid() || parent.column() > 0) {
+	return false;
+    }
     CarveSVGNode* parentItem = static_cast<CarveSVGNode*>(parent.internalPointer());
-    return parentItem->domElem().childNodes().count();
+    return fetchedRows_.value(parentItem, 0) < parentItem->numChildren();
+}
+
+void CarveSVGDocument::fetchMore(const QModelIndex& parent) {
+    if(!canFetchMore(parent)) {
+	return;
+    }
+    CarveSVGNode* parentItem = static_cast<CarveSVGNode*>(parent.internalPointer());
+    int fetched = fetchedRows_.value(parentItem, 0);
+    int count = qMin(FETCH_BATCH_SIZE, parentItem->numChildren() - fetched);
+
+    beginInsertRows(parent, fetched, fetched + count - 1);
+    fetchedRows_[parentItem] = fetched + count;
+    endInsertRows();
+}
+
+QModelIndex CarveSVGDocument::indexForNode(CarveSVGNode* node) {
+    // the document node has no row, and neither do the detached nodes <use> builds its content from
+    if(!node || node == this->root_ || !node->parent() || node->document() != this) {
+	return QModelIndex();
+    }
+    if(node->parent() == this->root_) {
+	return createIndex(0, 0, node);
+    }
+
+    QModelIndex parent = indexForNode(node->parent());
+    if(!parent.isValid()) {
+	return QModelIndex();
+    }
+    int row = node->row();
+    while(row >= rowCount(parent) && canFetchMore(parent)) {
+	fetchMore(parent);
+    }
+    if(row >= rowCount(parent)) {
+	return QModelIndex();
+    }
+    return createIndex(row, 0, node);
 }
 
 QModelIndex CarveSVGDocument::parent(const QModelIndex& child) const {
@@ -174,7 +284,7 @@ QVariant CarveSVGDocument::data(const QModelIndex& index, int role) const {
                 return QString("");
             }
 
-            QDomNode id = attrs.namedItem("id");
+            QDomNode id = attrs.namedItem(CarveAtoms::name(AtomId));
             return id.nodeValue();
         }
 
@@ -184,17 +294,17 @@ QVariant CarveSVGDocument::data(const QModelIndex& index, int role) const {
 
 CarveSVGElement* CarveSVGDocument::svgElem() {
     if(root()->numChildren() != 1) {
-	cout << "Error!  Doc root did not have one child!" << endl;
+	CARVE_ERROR(LogModel, "Document root does not have exactly one child");
     }
     else {
 	CarveSVGNode* docNode = root()->child(0);
 	if(!docNode || docNode->type() != svgSvg) {
-	    cout << "Error!  Root of document was not of type <svg>" << endl;
+	    CARVE_ERROR(LogModel, "Root of document is not an <svg> element");
 	}
 	else {
 	    CarveSVGElement* svg = dynamic_cast<CarveSVGElement*>(docNode);
 	    if(!svg) {
-		cout << "Could not find the <svg> node" << endl;
+		CARVE_ERROR(LogModel, "Could not find the <svg> node");
 	    }
 	    else {
 		return svg;
@@ -203,3 +313,112 @@ CarveSVGElement* CarveSVGDocument::svgElem() {
     }
     return NULL;
 }
+
+void CarveSVGDocument::realizeRect(const QRectF& sceneRect) {
+    // quietly do nothing for a document without an <svg> root (svgElem() would complain)
+    CarveSVGNode* top = root_ ? root_->child(0) : NULL;
+    if(!top || top->type() != svgSvg || !top->gfxItem()) { return; }
+
+    CARVE_PROFILE("realizeRect");
+    CarveLogCollector collector(&errors_);
+    bool bInvertible = false;
+    QTransform toUser = top->gfxItem()->sceneTransform().inverted(&bInvertible);
+    if(!bInvertible) { return; }
+    top->realizeRect(toUser.mapRect(sceneRect));
+}
+
+void CarveSVGDocument::realizeAll() {
+    CarveSVGNode* top = root_ ? root_->child(0) : NULL;
+    if(!top || top->type() != svgSvg) { return; }
+
+    CARVE_PROFILE("realizeAll");
+    CarveLogCollector collector(&errors_);
+    top->realizeAll();
+}
+
+int CarveSVGDocument::storeNode(CarveSVGNode* node) {
+    if(!bStoreValid_ || bStoreStale_ || !node || node->document() != this) { return -1; }
+    return node->storeIndex();
+}
+
+void CarveSVGDocument::traitChanged(CarveSVGNode* node, const QString& name, const QString& value) {
+    int elem = storeNode(node);
+    if(elem < 0) {
+	bStoreStale_ = true;
+	return;
+    }
+    if(value.isEmpty()) { store_.removeAttribute(elem, CarveAtoms::intern(name)); }
+    else { store_.setAttribute(elem, CarveAtoms::intern(name), value); }
+}
+
+void CarveSVGDocument::setTextContent(CarveSVGNode* node, const QString& text) {
+    int elem = storeNode(node);
+    if(elem < 0) { bStoreStale_ = true; }
+    else { store_.setText(elem, text); }
+
+    QDomElement domElem = node->domElem();
+    while(domElem.hasChildNodes()) {
+	domElem.removeChild(domElem.lastChild());
+    }
+    domElem.appendChild(doc_.createTextNode(text));
+}
+
+void CarveSVGDocument::removeNode(CarveSVGNode* node) {
+    int elem = storeNode(node);
+    if(elem < 0) { bStoreStale_ = true; }
+    else { store_.removeNode(elem); }
+
+    QDomElement domElem = node->domElem();
+    domElem.parentNode().removeChild(domElem);
+    invalidateElementIds();
+}
+
+QString CarveSVGDocument::serialize() {
+    CARVE_PROFILE("serialize");
+    if(bStoreValid_ && !bStoreStale_) {
+	serialized_ = store_.toString();
+	return serialized_;
+    }
+    // TODO: make this default indentation a setting
+    return doc_.toString(2);
+}
+
+QDomElement CarveSVGDocument::elementById(const QString& id) {
+    if(!bIdsIndexed_) {
+	CARVE_PROFILE("indexIds");
+	ids_.clear();
+	indexIds(doc_.documentElement());
+	bIdsIndexed_ = true;
+    }
+    return ids_.value(id);
+}
+
+void CarveSVGDocument::indexIds(const QDomElement& elem) {
+    QString id = elem.attribute(CarveAtoms::name(AtomId));
+    // the first element in document order wins, as with getElementById()
+    if(!id.isEmpty() && !ids_.contains(id)) {
+	ids_.insert(id, elem);
+    }
+    for(QDomElement child = elem.firstChildElement(); !child.isNull(); child = child.nextSiblingElement()) {
+	indexIds(child);
+    }
+}
+
+QExplicitlySharedDataPointer<CarveUseGeometry> CarveSVGDocument::useGeometry(const QString& id) {
+    QHash<QString, QExplicitlySharedDataPointer<CarveUseGeometry> >::const_iterator it = useGeometries_.constFind(id);
+    if(it != useGeometries_.constEnd()) {
+	return it.value();
+    }
+
+    QExplicitlySharedDataPointer<CarveUseGeometry> geometry;
+    QDomElement elem = elementById(id);
+    if(elem.isNull()) {
+	CARVE_WARNING(LogModel, QString("<use> references missing element '#%1'").arg(id));
+    }
+    else {
+	geometry = QExplicitlySharedDataPointer<CarveUseGeometry>(CarveUseElement::buildGeometry(elem, this));
+    }
+    // a missing element is cached too, so it is only reported once
+    useGeometries_.insert(id, geometry);
+    return geometry;
+}
@@ -21,12 +21,22 @@
 #define CARVESVGDOCUMENT_H
 
 #include <QString>
+#include <QStringList>
 #include <QDomDocument>
 #include <QAbstractItemModel>
+#include <QHash>
+#include <QRectF>
+#include <QExplicitlySharedDataPointer>
+
+#include "carvearena.h"
+#include "carvedocumentstore.h"
+#include "carvepathcache.h"
 
 class CarveSVGNode;
-class CarveSVGWindow;
 class CarveSVGElement;
+class CarveSceneBuilder;
+class CarveStyleSheet;
+class CarveUseGeometry;
 
 // TODO: make doc_ a pointer?
 
@@ -35,12 +45,26 @@ class CarveSVGDocument : public QAbstractItemModel
     Q_OBJECT
 
 public:
-    CarveSVGDocument(const QString& textContent, CarveSVGWindow* parent);
+    // the document takes ownership of the builder (a plain CarveSceneBuilder is used if none is given)
+    CarveSVGDocument(const QString& textContent, QObject* parent = 0, CarveSceneBuilder* builder = 0);
     ~CarveSVGDocument();
 
     bool setContent(const QString& text);
     CarveSVGNode* root() { return root_; }
+    // time in ms that the last setContent() spent parsing the text into the DOM and the store
+    int parseTime() const { return parseTime_; }
+    // the part of parseTime() spent on the store (0 if it was kept)
+    int storeParseTime() const { return storeParseTime_; }
+    // warnings and errors reported while parsing and building the model
+    const QStringList& errors() const { return errors_; }
     QDomDocument* domDocument() { return &doc_; }
+    // the text of the last setContent() in Carve's own document store, with the
+    // edits made through the model since; NULL if the text is not well-formed
+    // or declares entities of its own
+    CarveDocumentStore* store() { return bStoreValid_ ? &store_ : NULL; }
+    // the store's element for node, or -1 if it has none or the store has missed
+    // an edit (the nodes then read their attributes from the DOM)
+    int storeNode(CarveSVGNode* node);
 
     // QAbstractItemModel interface
     Qt::ItemFlags flags(const QModelIndex& index) const;
@@ -50,19 +74,85 @@ public:
     int columnCount(const QModelIndex& parent = QModelIndex()) const;
     QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const;
     QModelIndex parent(const QModelIndex& child) const;
-
-    CarveSVGWindow* window() { return window_; }
+    // rows are element children only, handed to the views in batches as they scroll
+    bool hasChildren(const QModelIndex& parent = QModelIndex()) const;
+    bool canFetchMore(const QModelIndex& parent) const;
+    void fetchMore(const QModelIndex& parent);
+    // the index of a node of this document, found by walking up its parents;
+    // rows that the views have not fetched yet on the way are fetched
+    QModelIndex indexForNode(CarveSVGNode* node);
+
+    CarveSceneBuilder* builder() { return builder_; }
+    // holds the nodes of the model until the next setContent()
+    CarveArena* arena() { return &arena_; }
+    // the rules of all <style> elements, parsed once per setContent()
+    const CarveStyleSheet* styleSheet() const { return styleSheet_; }
+    // the outlines of path, polyline and polygon elements, kept across setContent()
+    CarvePathCache* pathCache() { return &pathCache_; }
 
     CarveSVGElement* svgElem();
 
+    // create the graphics items of the rendered elements that intersect sceneRect;
+    // everything else is only represented by its cached bounds until it comes into view
+    void realizeRect(const QRectF& sceneRect);
+    // create the graphics items of every rendered element (for rendering off-screen)
+    void realizeAll();
+
+    // the first element with this id, from an index built on first use
+    QDomElement elementById(const QString& id);
+    // called when an id has been added, changed or removed
+    void invalidateElementIds() { bIdsIndexed_ = false; }
+    // the content of the element with this id as <use> instances share it,
+    // built once per setContent(); null if the element does not exist
+    QExplicitlySharedDataPointer<CarveUseGeometry> useGeometry(const QString& id);
+
+    // called by a node after it has changed the DOM
+    void notifyDomChanged() { emit domChanged(); }
+
+    // Edits made through the model change the DOM and are followed in the
+    // store, so serialize() only has to write out what was edited.
+    // called by a node after setting (or, if value is empty, removing) an attribute
+    void traitChanged(CarveSVGNode* node, const QString& name, const QString& value);
+    // replaces the content of the node's element with text
+    void setTextContent(CarveSVGNode* node, const QString& text);
+    // removes the node's element from the DOM
+    void removeNode(CarveSVGNode* node);
+    // the document as text: the source with only the edited nodes written anew,
+    // or the whole DOM reformatted if the store could not follow the edits
+    QString serialize();
+
+signals:
+    // the DOM was modified through the model and no longer matches the text it was parsed from
+    void domChanged();
+
 private:
+    void indexIds(const QDomElement& elem);
+
     // unimplemented to prevent copying
     CarveSVGDocument& operator=(const CarveSVGDocument&);
     CarveSVGDocument(const CarveSVGDocument&);
 
     QDomDocument doc_;
+    CarveDocumentStore store_;
+    bool bStoreValid_;
+    // what serialize() last wrote from the store
+    QString serialized_;
+    // an edit was made that the store could not follow
+    bool bStoreStale_;
+    CarveArena arena_;
     CarveSVGNode* root_;
-    CarveSVGWindow* window_;
+    CarveSceneBuilder* builder_;
+    CarveStyleSheet* styleSheet_;
+    QHash<QString, QDomElement> ids_;
+    bool bIdsIndexed_;
+    QHash<QString, QExplicitlySharedDataPointer<CarveUseGeometry> > useGeometries_;
+    CarvePathCache pathCache_;
+    int parseTime_;
+    int storeParseTime_;
+    // how many element children of each node the views have been told about
+    QHash<const CarveSVGNode*, int> fetchedRows_;
+    // nodes are created lazily from index(), which is const
+    mutable QStringList errors_;
 };
 
 #endif // CARVESVGDOCUMENT_H
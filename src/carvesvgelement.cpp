@@ -18,17 +18,16 @@
 
 */
 #include "carvesvgelement.h"
-#include "carvesvgwindow.h"
+#include "carvesvgdocument.h"
+#include "carvescenebuilder.h"
 #include "carvesvgnode.h"
-#include "carvescene.h"
-#include "carvedesignview.h"
 #include "domhelper.h"
+#include "carveparse.h"
+#include "profiler.h"
+#include "carveatoms.h"
 
 #include <QGraphicsRectItem>
-
-#include <iostream>
-using std::cout;
-using std::endl;
+#include <QGraphicsScene>
 
 /*
 
@@ -50,25 +49,24 @@ using std::endl;
   preserveAspectRatio - not dealing with this in the first iteration
 
  */
-CarveSVGElement::CarveSVGElement(const QDomElement& element, int row, CarveSVGWindow* window, CarveSVGNode* parent) :
-	CarveSVGNode(element, row, window, svgSvg, parent)
+CarveSVGElement::CarveSVGElement(const QDomElement& element, int row, CarveSVGDocument* document, CarveSVGNode* parent) :
+	CarveSVGNode(element, row, document, svgSvg, parent)
 {
     bool bOk = false;
-    CarveScene* scene = this->window_->scene();
 
-    width_ = getFloatTrait(element, "width", &bOk);
+    width_ = getFloatTrait(element, AtomWidth, &bOk);
     // width="100%" is default
     if(!bOk) {
-	width_ = getPercentageTrait(element, "width", &bOk);
+	width_ = getPercentageTrait(element, AtomWidth, &bOk);
 	if(!bOk) { width_ = 100.0; }
 	// relative values are negative
 	width_ = -width_;
     }
 
-    height_ = getFloatTrait(element, "height", &bOk);
+    height_ = getFloatTrait(element, AtomHeight, &bOk);
     // height="100%" is default
     if(!bOk) {
-	height_ = getPercentageTrait(element, "height", &bOk);
+	height_ = getPercentageTrait(element, AtomHeight, &bOk);
 	if(!bOk) { height_ = 100.0; }
 	// relative values are negative
 	height_ = -height_;
@@ -79,15 +77,16 @@ CarveSVGElement::CarveSVGElement(const QDomElement& element, int row, CarveSVGWi
     // if width==0 or height==0, disabled rendering
 //    this->preserveAspectRatio_ = none;
     this->viewBox_ = QRectF(0,0,-1,-1);
-    QStringList strings = getListTrait(element, "viewBox", &bOk);
-    if(bOk && strings.length() == 4) {
-	bool bx, by, bw, bh;
-	qreal x = strings[0].toDouble(&bx);
-	qreal y = strings[1].toDouble(&by);
-	qreal w = strings[2].toDouble(&bw);
-	qreal h = strings[3].toDouble(&bh);
+    QString viewBox = getTrait(element, AtomViewBox, &bOk);
+    QVector<double> numbers;
+    if(bOk && parseNumberList(viewBox.constData(), viewBox.constData() + viewBox.size(), &numbers)
+       && numbers.size() == 4) {
+	qreal x = numbers[0];
+	qreal y = numbers[1];
+	qreal w = numbers[2];
+	qreal h = numbers[3];
 	// viewBox parsed ok
-	if(w > 0 && h > 0 && bx && by && bw && bh) {
+	if(w > 0 && h > 0) {
 	    this->viewBox_ = QRectF(x,y,w,h);
 	    // parse preserveAspectRatio attribute only if viewBox has been provided
 	    arm_ = getAspectRatio(element);
@@ -98,9 +97,6 @@ CarveSVGElement::CarveSVGElement(const QDomElement& element, int row, CarveSVGWi
     canvas_ = new QGraphicsRectItem(0,0,width_,height_);
     canvas_->setBrush(QBrush(QColor(255,255,255)));
     canvas_->setPen(QPen(QColor("transparent")));
-    this->getFillOpacity();
-    this->getStrokeOpacity();
-    this->getStrokeWidth();
     canvas_->setData(0, qVariantFromValue(reinterpret_cast<void*>(this)));
     canvas_->setZValue(0);
 
@@ -112,7 +108,7 @@ CarveSVGElement::CarveSVGElement(const QDomElement& element, int row, CarveSVGWi
     // the <svg> element has the viewbox canvas as its item to which child element get attached
     this->gfxItem_ = viewboxCanvas_;
 
-    scene->addItem(canvas_);
+    document->builder()->scene()->addItem(canvas_);
 }
 
 CarveSVGElement::~CarveSVGElement() {
@@ -120,6 +116,8 @@ CarveSVGElement::~CarveSVGElement() {
 
 // viewWidth and viewHeight are the actual size of the view widget/pane
 void CarveSVGElement::update(int viewWidth, int viewHeight) {
+    CARVE_PROFILE("CarveSVGElement::update");
+
     // if our width and height values are negative here, that means we have percentage values
     // so set the width/height to be a percentage of the view's dimension
     qreal w = width_;
@@ -22,7 +22,6 @@
 
 #include "carvesvgnode.h"
 
-class CarveSVGWindow;
 class CarveSVGNode;
 class QGraphicsRectItem;
 
@@ -48,7 +47,7 @@ enum MeetOrSliceType {
 class CarveSVGElement : public CarveSVGNode
 {
 public:
-    CarveSVGElement(const QDomElement& element, int row, CarveSVGWindow* window, CarveSVGNode* parent = 0);
+    CarveSVGElement(const QDomElement& element, int row, CarveSVGDocument* document, CarveSVGNode* parent = 0);
     virtual ~CarveSVGElement();
 
     void update(int viewWidth, int viewHeight);
@@ -28,9 +28,23 @@
 */
 
 #include "carvesvgnode.h"
-#include "carvesvgwindow.h"
 #include "carvesvgdocument.h"
-#include "carvescene.h"
+#include "carvesvgelement.h"
+#include "carverectelement.h"
+#include "carvecircleelement.h"
+#include "carveellipseelement.h"
+#include "carvelineelement.h"
+#include "carvepolylineelement.h"
+#include "carvepolygonelement.h"
+#include "carvepathelement.h"
+#include "carvegelement.h"
+#include "carvetextelement.h"
+#include "carveaelement.h"
+#include "carveimageelement.h"
+#include "carveuseelement.h"
+#include "carveuseitem.h"
+#include "carvearena.h"
+#include "carvedocumentstore.h"
 
 #include <QBrush>
 #include <QColor>
@@ -44,39 +58,103 @@
 #include <cmath>
 
 #include "domhelper.h"
+#include "profiler.h"
+#include "carvelog.h"
+#include "carvestyle.h"
+#include "carvestylesheet.h"
+#include "carveatoms.h"
+
+CarveSVGNode* CarveSVGNode::createNode(const QDomDocument& doc, int row, CarveSVGDocument* document, CarveSVGNode* parent) {
+    return new(document->arena()) CarveSVGNode(doc, row, document, svgUndefined, parent);
+}
 
-#include <iostream>
-using std::cout;
-using std::endl;
+CarveSVGNode* CarveSVGNode::createNode(const QDomElement& node, int row, CarveSVGDocument* document, CarveSVGNode* parent) {
+    CARVE_PROFILE("createNode");
+    CarveArena* arena = document->arena();
+    switch(CarveAtoms::find(node.nodeName())) {
+	// subclasses of CarveSVGNode
+	case AtomSvg: return new(arena) CarveSVGElement(node, row, document, parent);
+	case AtomRect: return new(arena) CarveRectElement(node, row, document, parent);
+	case AtomCircle: return new(arena) CarveCircleElement(node, row, document, parent);
+	case AtomEllipse: return new(arena) CarveEllipseElement(node, row, document, parent);
+	case AtomLine: return new(arena) CarveLineElement(node, row, document, parent);
+	case AtomPolyline: return new(arena) CarvePolylineElement(node, row, document, parent);
+	case AtomPolygon: return new(arena) CarvePolygonElement(node, row, document, parent);
+	case AtomPath: return new(arena) CarvePathElement(node, row, document, parent);
+	case AtomG: return new(arena) CarveGElement(node, row, document, parent);
+	case AtomText: return new(arena) CarveTextElement(node, row, document, parent);
+	case AtomA: return new(arena) CarveAElement(node, row, document, parent);
+	case AtomImage: return new(arena) CarveImageElement(node, row, document, parent);
+	case AtomUse: return new(arena) CarveUseElement(node, row, document, parent);
+	// instances of CarveSVGNode
+	case AtomLinearGradient: return new(arena) CarveSVGNode(node, row, document, svgLinearGradient, parent);
+	case AtomRadialGradient: return new(arena) CarveSVGNode(node, row, document, svgRadialGradient, parent);
+	case AtomStop: return new(arena) CarveSVGNode(node, row, document, svgStop, parent);
+	case AtomDefs: return new(arena) CarveSVGNode(node, row, document, svgDefs, parent);
+	case AtomSymbol: return new(arena) CarveSVGNode(node, row, document, svgSymbol, parent);
+	// unimplemented
+	default: return new(arena) CarveSVGNode(node, row, document, svgUndefined, parent);
+    }
+}
 
-CarveSVGNode::CarveSVGNode(const QDomDocument& doc, int row, CarveSVGWindow* window, SvgNodeType type, CarveSVGNode* parent) :
+CarveSVGNode::CarveSVGNode(const QDomDocument& doc, int row, CarveSVGDocument* document, SvgNodeType type, CarveSVGNode* parent) :
 	gfxItem_(NULL),
-	window_(window),
-	type_(type),
+	document_(document),
+	style_(NULL),
 	domElem_(QDomElement()), // Set it to Null
+	parent_(parent),
+	transform_(NULL),
 	row_(row),
-	parent_(parent)
+	storeIndex_(-1),
+	type_(type),
+	bChildrenIndexed_(false),
+	bBoundsValid_(false),
+	bTransformParsed_(false),
+	bSubtreeRealized_(false)
 {
-    children_[0] = CarveSVGNode::createNode(doc.documentElement(), 0, this->window_, this);
+    CarveDocumentStore* store = document->store();
+    if(store) { this->storeIndex_ = store->document(); }
+    this->childElems_ << doc.documentElement();
+    this->bChildrenIndexed_ = true;
+    this->children_ << CarveSVGNode::createNode(doc.documentElement(), 0, this->document_, this);
 }
 
-CarveSVGNode::CarveSVGNode(const QDomElement& element, int row, CarveSVGWindow* window, SvgNodeType type, CarveSVGNode* parent) :
+CarveSVGNode::CarveSVGNode(const QDomElement& element, int row, CarveSVGDocument* document, SvgNodeType type, CarveSVGNode* parent) :
 	gfxItem_(NULL),
-	window_(window),
-	type_(type),
+	document_(document),
+	style_(NULL),
 	domElem_(element),
-        row_(row),
-	parent_(parent)
+	parent_(parent),
+	transform_(NULL),
+	row_(row),
+	storeIndex_(parent ? parent->storeChild(row, element) : -1),
+	type_(type),
+	bChildrenIndexed_(false),
+	bBoundsValid_(false),
+	bTransformParsed_(false),
+	bSubtreeRealized_(false)
 {
+    // match the stylesheet once, before the subclass asks for any property
+    this->getStyles();
 }
 
+// the children are in the document's arena too and are destroyed along with it,
+// and the style block belongs to the stylesheet
 CarveSVGNode::~CarveSVGNode() {
-    QHash<int, CarveSVGNode*>::iterator it = children_.begin();
-    while(it != children_.end()) {
-        delete it.value();
-        ++it;
-    }
-    children_.clear();
+}
+
+namespace {
+
+void destroyNode(void* node) {
+    static_cast<CarveSVGNode*>(node)->~CarveSVGNode();
+}
+
+}
+
+void* CarveSVGNode::operator new(size_t size, CarveArena* arena) {
+    void* node = arena->allocate(size);
+    arena->addCleanup(node, &destroyNode);
+    return node;
 }
 
 QDomElement CarveSVGNode::domElem() const {
@@ -91,34 +169,75 @@ CarveSVGNode* CarveSVGNode::parent() {
     return this->parent_;
 }
 
-CarveSVGNode* CarveSVGNode::child(int i) {
-    // return the cached child node
-    if(children_.contains(i)) {
-        return children_[i];
-    }
-
-    // our children array does not yet contain a CarveSVGNode object for this index
-    // so we now lazily create it
-    if (i >= 0 && i < domElem_.childNodes().count()) {
-	QDomNode childNode = domElem_.childNodes().item(i);
-	QDomElement childElem(childNode.toElement());
-	if(!childElem.isNull()) {
-	    CarveSVGNode* childItem = CarveSVGNode::createNode(childElem, i, this->window_, this);
-	    if(childItem->gfxItem()) {
-		// TODO: do it here?
-//	    this->window_->scene()->addItem(childItem->gfxItem());
-	    }
-	    children_[i] = childItem;
-	    return childItem;
-	}
+// QDomNode::childNodes().item() is linear, so the children are mapped in one pass
+void CarveSVGNode::indexChildren() {
+    if(this->bChildrenIndexed_) { return; }
+    for(QDomElement elem = this->domElem_.firstChildElement(); !elem.isNull(); elem = elem.nextSiblingElement()) {
+	this->childElems_ << elem;
+    }
+    this->childElems_.squeeze();
+    this->children_.fill(NULL, this->childElems_.size());
+    this->children_.squeeze();
+    this->bChildrenIndexed_ = true;
+}
+
+int CarveSVGNode::numChildren() {
+    indexChildren();
+    return this->children_.size();
+}
+
+// Detached nodes are given a parent and a row too, but are not among the
+// parent's indexed children.
+int CarveSVGNode::storeChild(int row, const QDomElement& element) {
+    CarveDocumentStore* store = this->document_->store();
+    if(!store || this->storeIndex_ < 0 || !this->bChildrenIndexed_
+	    || row < 0 || row >= this->childElems_.size() || this->childElems_.at(row) != element) {
+	return -1;
+    }
+    int child = store->childElement(this->storeIndex_, row);
+    if(child < 0 || store->nameAtom(child) != CarveAtoms::find(element.tagName())) { return -1; }
+    return child;
+}
+
+QString CarveSVGNode::trait(CarveAtom name, bool* bOk) {
+    int elem = this->document_->storeNode(this);
+    if(elem >= 0) { return this->document_->store()->attribute(elem, name, bOk); }
+    return getTrait(this->domElem_, name, bOk);
+}
+
+double CarveSVGNode::floatTrait(CarveAtom name, bool* bOk) {
+    bool bFound = false;
+    QString value = this->trait(name, &bFound);
+    if(!bFound) {
+	if(bOk) { *bOk = false; }
+	return 0.0;
+    }
+    return value.toDouble(bOk);
+}
+
+QTransform CarveSVGNode::transform() {
+    if(!this->bTransformParsed_) {
+	QTransform parsed = parseTransform(this->trait(AtomTransform));
+	if(!parsed.isIdentity()) { this->transform_ = this->document_->arena()->create<QTransform>(parsed); }
+	this->bTransformParsed_ = true;
     }
+    return this->transform_ ? *this->transform_ : QTransform();
+}
 
-    // else, return NULL
-    return 0;
+CarveSVGNode* CarveSVGNode::child(int i) {
+    indexChildren();
+    if(i < 0 || i >= this->children_.size()) { return NULL; }
+
+    // the node is created the first time it is asked for
+    CarveSVGNode*& childItem = this->children_[i];
+    if(!childItem) {
+	childItem = CarveSVGNode::createNode(this->childElems_.at(i), i, this->document_, this);
+    }
+    return childItem;
 }
 
 // Something in the editor has changed an attribute value on this node
-// This function causes the DOM to be reserialized and the editor to re-sync itself
+// The document announces the change (domChanged()) so the editor can reserialize the DOM and re-sync itself
 // If the attribute's new value is an empty string, the attribute is removed from the DOM
 bool CarveSVGNode::setTrait(const QString& name, const QString& value) {
     bool bResult = false;
@@ -129,22 +248,27 @@ bool CarveSVGNode::setTrait(const QString& name, const QString& value) {
 	    domElem_.removeAttribute(name);
 	}
 
-	// serialize the DOM and set the document's text (but make it undo-able)
-	QTextCursor cursor(window_->edit()->document());
-	cursor.beginEditBlock();
-	cursor.select(QTextCursor::Document);
-	cursor.removeSelectedText();
-	// insert the reserialized DOM
-	// TODO: do a diff between the previous text contents and the reserialized DOM
-	// and then only change this text (this should reduce memory considerably)
-	// TODO: make this default indentation a setting
-	cursor.insertText(window_->model()->domDocument()->toString(2));
-	cursor.endEditBlock();
+	// the attributes are read back from the store, so it has to follow first
+	this->document_->traitChanged(this, name, value);
 
-	this->window_->updateDocImmediately();
+	// a new class or id can change which stylesheet rules apply here and below
+	int atom = CarveAtoms::find(name);
+	if(atom == AtomClass || atom == AtomId || atom == AtomStyle) {
+	    this->restyle();
+	}
+	if(atom == AtomId) {
+	    this->document_->invalidateElementIds();
+	}
+	if(atom == AtomTransform) {
+	    this->transform_ = NULL;
+	    this->bTransformParsed_ = false;
+	}
+
+	this->document_->notifyDomChanged();
+	bResult = true;
     }
     else {
-	cout << "Not reset" << endl;
+	CARVE_DEBUG(LogModel, QString("Attribute '%1' was not changed").arg(name));
     }
 
     return bResult;
@@ -153,18 +277,19 @@ bool CarveSVGNode::setTrait(const QString& name, const QString& value) {
 QRegExp uri("url\\(\\#([\\w]+)\\)");
 
 qreal CarveSVGNode::getFillOpacity() {
+    CARVE_PROFILE("getFillOpacity");
     bool bOk = false;
-    this->fillOpacity_ = 1.0;
+    qreal fillOpacity = 1.0;
 
     qreal tempFillOpacity = 1.0;
 
     // first fetch from the ugly style attribute
-    if(styles_.contains("fill-opacity")) {
-	tempFillOpacity = styles_.value("fill-opacity").toDouble(&bOk);
+    if(style_ && style_->has(StyleFillOpacity)) {
+	tempFillOpacity = style_->number(StyleFillOpacity, &bOk);
     }
     // if the parse failed, then try the attribute
     if(!bOk) {
-	tempFillOpacity = getFloatTrait(this->domElem(), "fill-opacity", &bOk);
+	tempFillOpacity = this->floatTrait(AtomFillOpacity, &bOk);
     }
 
     // TODO: Check SVG spec, is a negative or >1 value for fill-opacity cause it be 1.0 or inherited?
@@ -172,141 +297,148 @@ qreal CarveSVGNode::getFillOpacity() {
     if(!bOk) {
 	// if we have a parent, get the fill-opacity from the parent
 	if(this->parent()) {
-	    this->fillOpacity_ = this->parent()->getFillOpacity();
+	    fillOpacity = this->parent()->getFillOpacity();
 	}
 	else {
-	    this->fillOpacity_ = 1.0;
+	    fillOpacity = 1.0;
 	}
     }
     else {
 	if(tempFillOpacity < 0.0 || tempFillOpacity > 1.0) { tempFillOpacity = 1.0; }
-	this->fillOpacity_ = tempFillOpacity;
+	fillOpacity = tempFillOpacity;
     }
-    return this->fillOpacity_;
+    return fillOpacity;
 }
 
 qreal CarveSVGNode::getStrokeOpacity() {
+    CARVE_PROFILE("getStrokeOpacity");
     bool bOk = false;
-    this->strokeOpacity_ = 1.0;
+    qreal strokeOpacity = 1.0;
 
     qreal tempStrokeOpacity = 1.0;
-    if(styles_.contains("stroke-opacity")) {
-	tempStrokeOpacity = styles_.value("stroke-opacity").toDouble(&bOk);
+    if(style_ && style_->has(StyleStrokeOpacity)) {
+	tempStrokeOpacity = style_->number(StyleStrokeOpacity, &bOk);
     }
     if(!bOk) {
-	tempStrokeOpacity = getFloatTrait(this->domElem(), "stroke-opacity", &bOk);
+	tempStrokeOpacity = this->floatTrait(AtomStrokeOpacity, &bOk);
     }
 
     if(!bOk) {
 	// if we have a parent, get the stroke-opacity from the parent
 	if(this->parent()) {
-	    this->strokeOpacity_ = this->parent()->getStrokeOpacity();
+	    strokeOpacity = this->parent()->getStrokeOpacity();
 	}
 	else {
-	    this->strokeOpacity_ = 1.0;
+	    strokeOpacity = 1.0;
 	}
     }
     else {
 	if(tempStrokeOpacity < 0.0 || tempStrokeOpacity > 1.0) { tempStrokeOpacity = 1.0; }
-	this->strokeOpacity_ = tempStrokeOpacity;
+	strokeOpacity = tempStrokeOpacity;
     }
 
-    return this->strokeOpacity_;
+    return strokeOpacity;
 }
 
 // TODO: convert font-size into something I can use here
 // (ok values are things like "12pt", "10px", "3em", "2ex", 14.4, "medium", etc).
 // see http://www.w3.org/TR/2006/REC-xsl11-20061205/#font-size
 qreal CarveSVGNode::getFontSize() {
+    CARVE_PROFILE("getFontSize");
     bool bOk = false;
 
     QFont dummyFont;
-    this->fontSize_ = dummyFont.pointSizeF();
+    qreal fontSize = dummyFont.pointSizeF();
 
     qreal tempFontSize = dummyFont.pointSizeF();
-    if(styles_.contains("font-size")) {
-	tempFontSize = styles_.value("font-size").toDouble(&bOk);
+    if(style_ && style_->has(StyleFontSize)) {
+	tempFontSize = style_->number(StyleFontSize, &bOk);
     }
     if(!bOk) {
-	tempFontSize = getFloatTrait(this->domElem(), "font-size", &bOk);
+	tempFontSize = this->floatTrait(AtomFontSize, &bOk);
     }
 
     if(!bOk || tempFontSize < 0.0) {
 	// if it didn't parse, it acts like an automatic inherit
 	if(this->parent()) {
-	    this->fontSize_ = this->parent()->getFontSize();
+	    fontSize = this->parent()->getFontSize();
 	}
 	// if there was no parent (i.e. at <svg> node), then just use default font size from Qt (dummyFont above)
     }
     else {
-	this->fontSize_ = tempFontSize;
+	fontSize = tempFontSize;
     }
 
-    return this->fontSize_;
+    return fontSize;
 }
 
 QString CarveSVGNode::getFontFamily() {
+    CARVE_PROFILE("getFontFamily");
     bool bOk = false;
 
     QFont dummyFont;
-    this->fontFamily_ = dummyFont.family();
+    QString fontFamily = dummyFont.family();
 
     QString tempFontFamily = dummyFont.family();
-    if(styles_.contains("font-family")) {
-	tempFontFamily = styles_.value("font-family");
+    if(style_ && style_->has(StyleFontFamily)) {
+	tempFontFamily = style_->value(StyleFontFamily);
+	bOk = true;
     }
     if(!bOk) {
-	tempFontFamily = getTrait(this->domElem(), "font-family", &bOk);
+	tempFontFamily = this->trait(AtomFontFamily, &bOk);
     }
 
     if(!bOk || tempFontFamily == "" || tempFontFamily == "inherit") {
 	if(this->parent()) {
-	    this->fontFamily_ = this->parent()->getFontFamily();
+	    fontFamily = this->parent()->getFontFamily();
 	}
 	// if there was no parent (i.e. at <svg> node), then just use default font fmaily from Qt (dummyFont above)
     }
     else {
-	this->fontFamily_ = tempFontFamily;
+	fontFamily = tempFontFamily;
     }
 
-    return this->fontFamily_;
+    return fontFamily;
 }
 
 qreal CarveSVGNode::getStrokeWidth() {
+    CARVE_PROFILE("getStrokeWidth");
     bool bOk = false;
-    this->strokeWidth_ = 1.0;
+    qreal strokeWidth = 1.0;
 
     qreal tempStrokeWidth = 1.0;
-    if(styles_.contains("stroke-width")) {
-	tempStrokeWidth = styles_.value("stroke-width").toDouble(&bOk);
+    if(style_ && style_->has(StyleStrokeWidth)) {
+	tempStrokeWidth = style_->number(StyleStrokeWidth, &bOk);
     }
     if(!bOk) {
-	tempStrokeWidth = getFloatTrait(this->domElem(), "stroke-width", &bOk);
+	tempStrokeWidth = this->floatTrait(AtomStrokeWidth, &bOk);
     }
 
     if(!bOk) {
 	// if it didn't parse, it acts like an automatic inherit
 	if(this->parent()) {
-	    this->strokeWidth_ = this->parent()->getStrokeWidth();
+	    strokeWidth = this->parent()->getStrokeWidth();
 	}
 	else {
-	    this->strokeWidth_ = 1.0;
+	    strokeWidth = 1.0;
 	}
     }
     else {
 	if(tempStrokeWidth < 0.0) { tempStrokeWidth = 1.0; }
-	this->strokeWidth_ = tempStrokeWidth;
+	strokeWidth = tempStrokeWidth;
     }
 
-    return this->strokeWidth_;
+    return strokeWidth;
 }
 
 Qt::PenCapStyle CarveSVGNode::getStrokeLineCap() {
+    CARVE_PROFILE("getStrokeLineCap");
     // Qt default is "square"
     // SVG default is "butt" (Qt calls this "flat")
     Qt::PenCapStyle lineCapStyle = Qt::FlatCap;
 
-    QString rawLineCap = getTrait(this->domElem(), "stroke-linecap");
+    QString rawLineCap = (style_ && style_->has(StyleStrokeLineCap))
+	? style_->value(StyleStrokeLineCap) : this->trait(AtomStrokeLinecap);
     if(rawLineCap == "round") { lineCapStyle = Qt::RoundCap; }
     else if(rawLineCap == "square") { lineCapStyle = Qt::SquareCap; }
 
@@ -318,17 +450,17 @@ Qt::PenCapStyle CarveSVGNode::getStrokeLineCap() {
 	// if there was no parent (i.e. at <svg> node), then just use default linecap style (flatcap above)
     }
 
-    this->strokeLineCap_ = lineCapStyle;
-
     return lineCapStyle;
 }
 
 Qt::PenJoinStyle CarveSVGNode::getStrokeLineJoin() {
+    CARVE_PROFILE("getStrokeLineJoin");
     // Qt default is "BevelJoin"
     // SVG default is "miter" (Qt calls this "SvgMiterJoin")
     Qt::PenJoinStyle lineJoinStyle = Qt::SvgMiterJoin;
 
-    QString rawLineJoin = getTrait(this->domElem(), "stroke-linejoin");
+    QString rawLineJoin = (style_ && style_->has(StyleStrokeLineJoin))
+	? style_->value(StyleStrokeLineJoin) : this->trait(AtomStrokeLinejoin);
     if(rawLineJoin == "round") { lineJoinStyle = Qt::RoundJoin; }
     else if(rawLineJoin == "bevel") { lineJoinStyle = Qt::BevelJoin; }
 
@@ -340,24 +472,28 @@ Qt::PenJoinStyle CarveSVGNode::getStrokeLineJoin() {
 	// if there was no parent (i.e. at <svg> node), then just use default linejoin style (miter above)
     }
 
-    this->strokeLineJoin_ = lineJoinStyle;
-
     return lineJoinStyle;
 }
 
-
 // TODO: implement pen style
 QPen CarveSVGNode::getStroke(bool* bOk, qreal opacity, qreal width) {
-    if(opacity == -1) { opacity = this->strokeOpacity_; }
-    if(width == -1) { width = this->strokeWidth_; }
+    CARVE_PROFILE("getStroke");
+    if(opacity == -1) { opacity = this->getStrokeOpacity(); }
+    if(width == -1) { width = this->getStrokeWidth(); }
+    return this->resolveStroke(bOk, opacity, width, this->getStrokeLineCap(), this->getStrokeLineJoin());
+}
+
+// the stroke paint of this node or the nearest ancestor that specifies one,
+// with this node's opacity, width, linecap and linejoin
+QPen CarveSVGNode::resolveStroke(bool* bOk, qreal opacity, qreal width, Qt::PenCapStyle cap, Qt::PenJoinStyle join) {
     if(bOk) { *bOk = false; }
 
     QString rawStroke;
-    if(styles_.contains("stroke")) {
-	rawStroke = styles_.value("stroke");
+    if(style_ && style_->has(StyleStroke)) {
+	rawStroke = style_->value(StyleStroke);
     }
     else {
-	rawStroke = getTrait(this->domElem(), "stroke");
+	rawStroke = this->trait(AtomStroke);
     }
 
     if(rawStroke == "none") {
@@ -367,7 +503,7 @@ QPen CarveSVGNode::getStroke(bool* bOk, qreal opacity, qreal width) {
     else if(uri.exactMatch(rawStroke)) {
 	if(uri.capturedTexts().length() == 2) {
 	    // seek out the referenced element in the DOM document
-	    QDomElement paintServer = getElementById(domElem().ownerDocument().documentElement(), uri.capturedTexts().at(1));
+	    QDomElement paintServer = this->document_->elementById(uri.capturedTexts().at(1));
 
 	    if(!paintServer.isNull()) {
 		QString nodeName = paintServer.nodeName();
@@ -378,14 +514,14 @@ QPen CarveSVGNode::getStroke(bool* bOk, qreal opacity, qreal width) {
 		    QLinearGradient g = resolveLinearGradient(paintServer, opacity);
 		    QGradientStops stops = g.stops();
 		    if(stops.size() == 0) {
-			return QPen(QBrush(Qt::NoBrush), width, Qt::SolidLine, this->strokeLineCap_, this->strokeLineJoin_);
+			return QPen(QBrush(Qt::NoBrush), width, Qt::SolidLine, cap, join);
 		    }
 		    // spec says that if only 1 stop is specified, paint a solid color (ignoring opacity, I guess)
 		    else if(stops.size() == 1) {
-			return QPen(QBrush(stops.at(0).second), width, Qt::SolidLine, this->strokeLineCap_, this->strokeLineJoin_);
+			return QPen(QBrush(stops.at(0).second), width, Qt::SolidLine, cap, join);
 		    }
 		    // assign gradient
-		    return QPen(QBrush(g), width);
+		    return QPen(QBrush(g), width, Qt::SolidLine, cap, join);
 		} // linearGradient
 		else if(nodeName == "radialGradient") {
 		    if(bOk) { *bOk = true; }
@@ -395,29 +531,29 @@ QPen CarveSVGNode::getStroke(bool* bOk, qreal opacity, qreal width) {
 
 		    // spec says that if no stops are specified, it's as if 'none' were specified
 		    if(stops.size() == 0) {
-			return QPen(QBrush(Qt::NoBrush), width, Qt::SolidLine, this->strokeLineCap_, this->strokeLineJoin_);
+			return QPen(QBrush(Qt::NoBrush), width, Qt::SolidLine, cap, join);
 		    }
 		    // spec says that if only 1 stop is specified, paint a solid color (ignoring opacity, I guess)
 		    else if(stops.size() == 1) {
-			return QPen(QBrush(stops.at(0).second), width, Qt::SolidLine, this->strokeLineCap_, this->strokeLineJoin_);
+			return QPen(QBrush(stops.at(0).second), width, Qt::SolidLine, cap, join);
 		    }
 
 		    // assign gradient
-		    return QPen(QBrush(g), width, Qt::SolidLine, this->strokeLineCap_, this->strokeLineJoin_);
+		    return QPen(QBrush(g), width, Qt::SolidLine, cap, join);
 		} // radialGradient
 		else if(nodeName == "solidColor") {
 		    // TODO: test this
-		    QBrush stroke(getRGBColorTrait(paintServer, "solid-color", bOk));
+		    QBrush stroke(getRGBColorTrait(paintServer, AtomSolidColor, bOk));
 		    QColor color(stroke.color());
                     color.setAlpha((int)(opacity*255.0));
 		    stroke.setColor(color);
-		    return QPen(stroke, width, Qt::SolidLine, this->strokeLineCap_, this->strokeLineJoin_);
+		    return QPen(stroke, width, Qt::SolidLine, cap, join);
 		} // solidColor
 	    }
 	}
 	else {
-	    cout << "How did we capture more text?" << endl;
-	    return QPen(QBrush(Qt::NoBrush), width, Qt::SolidLine, this->strokeLineCap_, this->strokeLineJoin_);
+	    CARVE_WARNING(LogStyle, "Unexpected text after paint server reference");
+	    return QPen(QBrush(Qt::NoBrush), width, Qt::SolidLine, cap, join);
 	}
     }
 
@@ -430,10 +566,7 @@ QPen CarveSVGNode::getStroke(bool* bOk, qreal opacity, qreal width) {
     if(bOk && !(*bOk)) {
 	// If we reach here, then the stroke attribute was not specified or did not parse or was "inherit"
 	if(this->parent()) {
-	    QPen parentStroke = this->parent()->getStroke(bOk, opacity, width);
-	    parentStroke.setCapStyle(this->strokeLineCap_);
-	    parentStroke.setJoinStyle(this->strokeLineJoin_);
-	    return parentStroke;
+	    return this->parent()->resolveStroke(bOk, opacity, width, cap, join);
 	}
 	else { // default stroke is none
 	    stroke.setBrush(QBrush());
@@ -450,23 +583,24 @@ QPen CarveSVGNode::getStroke(bool* bOk, qreal opacity, qreal width) {
 	stroke.brush().setColor(scolor);
     }
     stroke.setWidthF(width);
-    stroke.setCapStyle(this->strokeLineCap_);
-    stroke.setJoinStyle(this->strokeLineJoin_);
+    stroke.setCapStyle(cap);
+    stroke.setJoinStyle(join);
     if(bOk) { *bOk = true; }
     return stroke;
 }
 
 QBrush CarveSVGNode::getFill(bool* bOk, qreal opacity) {
-    if(opacity == -1) { opacity = this->fillOpacity_; }
+    CARVE_PROFILE("getFill");
+    if(opacity == -1) { opacity = this->getFillOpacity(); }
 
     if(bOk) { *bOk = false; }
 
     QString rawFill;
-    if(styles_.contains("fill")) {
-	rawFill = styles_.value("fill");
+    if(style_ && style_->has(StyleFill)) {
+	rawFill = style_->value(StyleFill);
     }
     else {
-	rawFill = getTrait(this->domElem(), "fill");
+	rawFill = this->trait(AtomFill);
     }
 
     if(rawFill == "none") {
@@ -478,8 +612,8 @@ QBrush CarveSVGNode::getFill(bool* bOk, qreal opacity) {
 	    // seek out the referenced element in the DOM document
 	    // NOTE: QDomDocument::elementById() would seem to be perfect for this except for the tiny
 	    // fact that THIS FUNCTION IS NOT IMPLEMENTED IN QT AND WILL ALWAYS RETURN A NULL NODE!
-	    // Thus, I have to invent my own getElementById() method in domhelper.cpp
-	    QDomElement paintServer = getElementById(domElem().ownerDocument().documentElement(), uri.capturedTexts().at(1));
+	    // Thus, the document keeps its own index of ids
+	    QDomElement paintServer = this->document_->elementById(uri.capturedTexts().at(1));
 
 	    if(!paintServer.isNull()) {
 		QString nodeName = paintServer.nodeName();
@@ -522,7 +656,7 @@ QBrush CarveSVGNode::getFill(bool* bOk, qreal opacity) {
 		} // radialGradient
 		else if(nodeName == "solidColor") {
 		    // TODO: test this
-		    QBrush fill(getRGBColorTrait(paintServer, "solid-color", bOk));
+		    QBrush fill(getRGBColorTrait(paintServer, AtomSolidColor, bOk));
 		    QColor color(fill.color());
                     color.setAlpha((int)(opacity*255.0));
 		    fill.setColor(color);
@@ -531,7 +665,7 @@ QBrush CarveSVGNode::getFill(bool* bOk, qreal opacity) {
 	    }
 	}
 	else {
-	    cout << "How did we capture more text?" << endl;
+	    CARVE_WARNING(LogStyle, "Unexpected text after paint server reference");
 	    return QBrush(Qt::NoBrush);
 	}
     }
@@ -563,59 +697,174 @@ QBrush CarveSVGNode::getFill(bool* bOk, qreal opacity) {
 
 void CarveSVGNode::finishDecorating(QGraphicsItem* item) {
     // set up id tooltip
-    QDomNode idAttr = this->domElem().attributes().namedItem("id");
-    if(!idAttr.isNull()) {
-	item->setToolTip(idAttr.nodeValue());
+    bool bHasId = false;
+    QString id = this->trait(AtomId, &bHasId);
+    if(bHasId) {
+	item->setToolTip(id);
     }
 
     item->setZValue(this->row());
     item->setFlag(QGraphicsItem::ItemIsSelectable, true);
-    item->setTransform(getTransform(this->domElem()));
+    item->setTransform(this->transform());
 
-    // parse the style attribute and store the property/value pairs for this element
-    this->getStyles();
-
-    // add this item to its parent
+    // add this item to its parent (realize() has created the parent's item first)
     CarveSVGNode* theParent = this->parent();
     if(theParent) {
 	item->setParentItem(theParent->gfxItem());
-
-	// if the parent is a <g> or an <a>, then we need to expand
-	// the parent's bounding box (a rect)
-	if(theParent->type() == svgG || theParent->type() == svgA) {
-	    QGraphicsRectItem* parentBox = dynamic_cast<QGraphicsRectItem*>(theParent->gfxItem());
-	    if(parentBox) {
-		QRectF bbox(parentBox->rect());
-		QRectF itemBox(item->boundingRect());
-		if(bbox.width() == -1 && bbox.height() == -1) {
-		    bbox = itemBox;
-		}
-		else {
-		    if(bbox.left() > itemBox.left()) { bbox.setLeft(itemBox.left()); }
-		    if(bbox.top() > itemBox.top()) { bbox.setTop(itemBox.top()); }
-		    if(bbox.right() < itemBox.right()) { bbox.setRight(itemBox.right()); }
-		    if(bbox.bottom() < itemBox.bottom()) { bbox.setBottom(itemBox.bottom()); }
-		}
-		parentBox->setRect(bbox);
-	    }
-	}
     }
 
     this->gfxItem_ = item;
 }
 
+// computes the cascaded style of this element from the document's stylesheet and its style attribute
 void CarveSVGNode::getStyles() {
     QDomElement elem = this->domElem();
     if(elem.isNull()) { return; }
 
-    QString sStyle = getTrait(elem, "style");
-    if(sStyle.length() > 0) {
-	QStringList pairs = sStyle.split(";", QString::SkipEmptyParts);
-	for(int p = 0; p < pairs.length(); ++p) {
-	    QStringList namevalue = pairs.at(p).trimmed().split(":");
-	    if(namevalue.length() == 2) {
-		this->styles_[namevalue.at(0).trimmed()] = namevalue.at(1).trimmed();
+    this->style_ = this->document_->styleSheet()->computeStyle(elem, this->trait(AtomStyle));
+}
+
+// re-matches this node and the nodes created below it, and repaints their items
+// (inherited properties and descendant selectors both reach into the subtree)
+void CarveSVGNode::restyle() {
+    CARVE_PROFILE("restyle");
+    this->getStyles();
+
+    bool bOk = false;
+    switch(this->type_) {
+	case svgRect: case svgCircle: case svgEllipse: case svgPolyline: case svgPolygon: case svgPath: case svgText: {
+	    QAbstractGraphicsShapeItem* item = dynamic_cast<QAbstractGraphicsShapeItem*>(this->gfxItem_);
+	    if(item) {
+		item->setBrush(this->getFill(&bOk));
+		item->setPen(this->getStroke(&bOk));
+	    }
+	    break;
+	}
+	case svgUse: {
+	    CarveUseItem* item = dynamic_cast<CarveUseItem*>(this->gfxItem_);
+	    if(item) {
+		QBrush fill = this->getFill(&bOk);
+		item->setInheritedPaint(fill, this->getStroke(&bOk));
+	    }
+	    break;
+	}
+	case svgLine: {
+	    QGraphicsLineItem* item = dynamic_cast<QGraphicsLineItem*>(this->gfxItem_);
+	    if(item) {
+		item->setPen(this->getStroke(&bOk));
+	    }
+	    break;
+	}
+	default:
+	    break;
+    }
+
+    // only the nodes that exist have anything to restyle
+    for(int i = 0; i < children_.size(); ++i) {
+	if(children_.at(i)) { children_.at(i)->restyle(); }
+    }
+}
+
+// ====================================================================================
+// Scene realization
+
+namespace {
+
+// like QRectF::intersects(), but a horizontal or vertical line still counts
+bool overlaps(const QRectF& a, const QRectF& b) {
+    return a.left() <= b.right() && b.left() <= a.right() && a.top() <= b.bottom() && b.top() <= a.bottom();
+}
+
+// only the content of these is rendered as part of the document
+bool isContainer(SvgNodeType type) {
+    return type == svgSvg || type == svgG || type == svgA;
+}
+
+}
+
+QGraphicsItem* CarveSVGNode::realize() {
+    if(!this->gfxItem_) {
+	if(this->parent_ && !this->parent_->realize()) {
+	    // nothing to attach to
+	    return NULL;
+	}
+	CARVE_PROFILE("realize");
+	this->createItem();
+    }
+    return this->gfxItem_;
+}
+
+QRectF CarveSVGNode::strokedBounds(const QRectF& rect) {
+    if(rect.isNull()) { return rect; }
+    qreal half = this->getStrokeWidth() / 2;
+    return rect.normalized().adjusted(-half, -half, half, half);
+}
+
+QRectF CarveSVGNode::subtreeBounds() {
+    if(!this->bBoundsValid_) {
+	CARVE_PROFILE("subtreeBounds");
+	QRectF bounds = this->geometryBounds();
+	if(this->type_ == svgG || this->type_ == svgA) {
+	    int numChildNodes = this->numChildren();
+	    for(int i = 0; i < numChildNodes; ++i) {
+		CarveSVGNode* theChild = this->child(i);
+		if(theChild) { bounds |= theChild->subtreeBounds(); }
 	    }
 	}
+	if(!bounds.isNull()) {
+	    bounds = this->transform().mapRect(bounds);
+	}
+	this->subtreeBounds_ = bounds;
+	this->bBoundsValid_ = true;
+    }
+    return this->subtreeBounds_;
+}
+
+void CarveSVGNode::realizeRect(const QRectF& rect) {
+    if(this->bSubtreeRealized_ || !isContainer(this->type_)) { return; }
+
+    bool bAllRealized = true;
+    int numChildNodes = this->numChildren();
+    for(int i = 0; i < numChildNodes; ++i) {
+	CarveSVGNode* theChild = this->child(i);
+	if(!theChild || theChild->bSubtreeRealized_) { continue; }
+
+	QRectF bounds = theChild->subtreeBounds();
+	if(bounds.isNull()) {
+	    // renders nothing
+	    theChild->bSubtreeRealized_ = true;
+	    continue;
+	}
+	if(!overlaps(bounds, rect)) {
+	    bAllRealized = false;
+	    continue;
+	}
+
+	theChild->realize();
+	if(theChild->type() == svgG || theChild->type() == svgA) {
+	    // the visible area in the child's own user space
+	    bool bInvertible = false;
+	    QTransform inverse = theChild->transform().inverted(&bInvertible);
+	    theChild->realizeRect(bInvertible ? inverse.mapRect(rect) : rect);
+	    if(!theChild->bSubtreeRealized_) { bAllRealized = false; }
+	}
+	else {
+	    theChild->bSubtreeRealized_ = true;
+	}
+    }
+    this->bSubtreeRealized_ = bAllRealized;
+}
+
+void CarveSVGNode::realizeAll() {
+    if(this->bSubtreeRealized_ || !isContainer(this->type_)) { return; }
+
+    int numChildNodes = this->numChildren();
+    for(int i = 0; i < numChildNodes; ++i) {
+	CarveSVGNode* theChild = this->child(i);
+	if(!theChild) { continue; }
+	theChild->realize();
+	theChild->realizeAll();
+	theChild->bSubtreeRealized_ = true;
     }
+    this->bSubtreeRealized_ = true;
 }
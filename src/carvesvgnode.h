@@ -21,59 +21,94 @@
 #define CARVESVGNODE_H
 
 #include <QDomElement>
-#include <QHash>
+#include <QVector>
 #include <QPen>
 #include <QBrush>
 #include <QPainterPath>
 #include <QGraphicsRectItem>
 
+#include "carveatoms.h"
+
 class QGraphicsItem;
 class QAbstractGraphicsShapeItem;
-class CarveSVGWindow;
+class CarveSVGDocument;
+class CarveStyleBlock;
+class CarveArena;
 
 enum SvgNodeType {
     svgUndefined,
     // actual subclasses of CarveSVGNode
-    svgSvg, svgG, svgRect, svgCircle, svgEllipse, svgLine, svgPolyline, svgPolygon, svgPath, svgText, svgA, svgImage,
+    svgSvg, svgG, svgRect, svgCircle, svgEllipse, svgLine, svgPolyline, svgPolygon, svgPath, svgText, svgA, svgImage, svgUse,
     // instances of CarveSVGNode (never displayed in Design mode)
-    svgLinearGradient, svgRadialGradient, svgStop, svgDefs,
+    svgLinearGradient, svgRadialGradient, svgStop, svgDefs, svgSymbol,
     // Not implemented yet
-    svgUse, svgAudio, svgVideo,
+    svgAudio, svgVideo,
 };
 
 class CarveSVGNode
 {
+    // resolves the style of referenced content through detached nodes
+    friend class CarveUseElement;
+
 public:
     virtual ~CarveSVGNode();
 
+    // Nodes are created in their document's arena and destroyed together when
+    // it is reset, so they are never deleted one by one.  Detached nodes (see
+    // CarveUseElement) live on the stack.
+    static void* operator new(size_t size, CarveArena* arena);
+    static void operator delete(void*, CarveArena*) {}
+    static void operator delete(void*) {}
+
     QDomElement domElem() const;
+    // this node's position among its parent's element children
     int row() const;
     CarveSVGNode* parent();
+    // children are elements only (text and comments are skipped) and are
+    // created on first access
     CarveSVGNode* child(int i);
-    int numChildren() const { return children_.size(); }
+    int numChildren();
     SvgNodeType type() const { return type_; }
+    // this node's element in the document's store, or -1 for detached nodes
+    int storeIndex() const { return storeIndex_; }
     QGraphicsItem* gfxItem() { return gfxItem_; }
-
-    qreal fillOpacity() const { return fillOpacity_; }
-    qreal strokeOpacity() const { return strokeOpacity_; }
-    qreal strokeWidth() const { return strokeWidth_; }
-    // NOTE: these anly make sense for <svg>, <g>, <a>, <text>, <tspan> - still store them here?
-    qreal fontSize() const { return fontSize_; }
-    QString fontFamily() const { return fontFamily_; }
+    CarveSVGDocument* document() { return document_; }
 
     // factory methods
-    static CarveSVGNode* createNode(const QDomDocument& doc, int row, CarveSVGWindow* window, CarveSVGNode* parent = 0);
-    static CarveSVGNode* createNode(const QDomElement& elem, int row, CarveSVGWindow* window, CarveSVGNode* parent = 0);
+    static CarveSVGNode* createNode(const QDomDocument& doc, int row, CarveSVGDocument* document, CarveSVGNode* parent = 0);
+    static CarveSVGNode* createNode(const QDomElement& elem, int row, CarveSVGDocument* document, CarveSVGNode* parent = 0);
 
     bool setTrait(const QString& name, const QString& value);
+    void restyle();
+
+    // Graphics items are created on demand, not with the node.
+    // creates this node's item (and its ancestors') if it does not exist yet; NULL if it renders nothing
+    QGraphicsItem* realize();
+    // the bounds of this node and everything it renders below it, in its parent's user space (cached)
+    QRectF subtreeBounds();
+    // realizes the rendered nodes below this one whose bounds intersect rect (in this node's user space)
+    void realizeRect(const QRectF& rect);
+    // realizes every rendered node below this one
+    void realizeAll();
 
 protected:
-    CarveSVGNode(const QDomDocument& doc, int row, CarveSVGWindow* window, SvgNodeType type, CarveSVGNode* parent = 0);
-    CarveSVGNode(const QDomElement& elem, int row, CarveSVGWindow* window, SvgNodeType type, CarveSVGNode* parent = 0);
+    CarveSVGNode(const QDomDocument& doc, int row, CarveSVGDocument* document, SvgNodeType type, CarveSVGNode* parent = 0);
+    CarveSVGNode(const QDomElement& elem, int row, CarveSVGDocument* document, SvgNodeType type, CarveSVGNode* parent = 0);
+    // an attribute of this node's element, read from the store while it is
+    // current and from the DOM otherwise
+    QString trait(CarveAtom name, bool* bOk = NULL);
+    double floatTrait(CarveAtom name, bool* bOk = NULL);
+    // the transform attribute, parsed once (so an invalid one is reported once)
+    QTransform transform();
     QGraphicsItem* gfxItem_;
-    CarveSVGWindow* window_;
-    QMap<QString, QString> styles_;
-
+    CarveSVGDocument* document_;
+    // the cascaded style (NULL if nothing we use is declared for the element),
+    // shared with every element that has the same rules and style attribute
+    const CarveStyleBlock* style_;
+
+    // Presentation properties are resolved from the style and the ancestors
+    // on each call rather than cached, so that nodes that never render do not
+    // carry paint around; the items keep the resulting pens and brushes.
     qreal getFillOpacity();
     QBrush getFill(bool* bOk = NULL, qreal opacity = -1);
     qreal getStrokeOpacity();
@@ -84,26 +119,39 @@ protected:
     qreal getFontSize();
     QString getFontFamily();
     void finishDecorating(QGraphicsItem* item);
+    QPen resolveStroke(bool* bOk, qreal opacity, qreal width, Qt::PenCapStyle cap, Qt::PenJoinStyle join);
+
+    // subclasses that render create and decorate their item here
+    virtual QGraphicsItem* createItem() { return NULL; }
+    // the area of this element's own geometry in its user space, not counting its children
+    virtual QRectF geometryBounds() { return QRectF(); }
+    // rect grown by half the stroke width
+    QRectF strokedBounds(const QRectF& rect);
     void getStyles();
 
 private:
-    SvgNodeType type_;
+    void indexChildren();
+    // the store's element for the child at row, if element is that child
+    int storeChild(int row, const QDomElement& element);
+
+    // ordered by size, so the small fields share the last word
     QDomElement domElem_;
-    int row_;
     CarveSVGNode* parent_;
-    QHash<int,CarveSVGNode*> children_;
-
-    qreal fillOpacity_;
-    QBrush fill_;
-
-    Qt::PenCapStyle strokeLineCap_;
-    Qt::PenJoinStyle strokeLineJoin_;
-    qreal strokeOpacity_;
-    qreal strokeWidth_;
-    QPen stroke_;
-
-    qreal fontSize_;
-    QString fontFamily_;
+    // in the document's arena; NULL for the identity or until transform() is first called
+    const QTransform* transform_;
+    // the element children and their nodes (NULL until created), indexed by row;
+    // both are filled in on first use
+    QVector<QDomElement> childElems_;
+    QVector<CarveSVGNode*> children_;
+    QRectF subtreeBounds_;
+    int row_;
+    int storeIndex_;
+    SvgNodeType type_;
+    bool bChildrenIndexed_;
+    bool bBoundsValid_;
+    bool bTransformParsed_;
+    // every rendered node below this one has its item
+    bool bSubtreeRealized_;
 };
 
 #endif // CARVESVGNODE_H
@@ -26,6 +26,11 @@
 #include "version.h"
 #include "carvewindow.h"
 #include "carvesvgelement.h"
+#include "carvegraphicsitems.h"
+#include "carvefilewriter.h"
+#include "carvejournal.h"
+#include "carvelog.h"
+#include "carvegzipdevice.h"
 
 #include <QFile>
 #include <QMessageBox>
@@ -37,16 +42,38 @@
 #include <QStack>
 #include <QPlainTextEdit>
 #include <QGridLayout>
-
-#include <iostream>
-using std::cout;
-using std::cerr;
-using std::endl;
+#include <QTextCursor>
+#include <QTextDocument>
+#include <QDesktopServices>
+
+// until a document has been rebuilt once we have no idea how expensive it is
+const int REFRESH_DELAY_DEFAULT = 2000;
+// the delay is kept several times larger than the rebuild cost so that a rebuild
+// never takes up more than a fraction of the time the user spends typing
+const int REFRESH_DELAY_FACTOR = 4;
+const int REFRESH_DELAY_MIN = 250;
+const int REFRESH_DELAY_MAX = 8000;
+// the journal is not compacted before its changes take this much space
+const int JOURNAL_COMPACT_MIN_BYTES = 1 << 20;
+
+// how fast a file was read or written, counting the text (about a byte a
+// character for SVG) rather than what a compressed file takes on disk
+static QString throughputMessage(const QString& verb, const QString& fileName, int chars, int msecs) {
+    double mb = chars / (1024.0 * 1024.0);
+    return QString("%1 %2: %3 MB of text (%4 MB on disk) in %5 ms, %6 MB/s")
+	.arg(verb).arg(QFileInfo(fileName).fileName())
+	.arg(mb, 0, 'f', 2).arg(QFileInfo(fileName).size() / (1024.0 * 1024.0), 0, 'f', 2)
+	.arg(msecs).arg(mb * 1000.0 / qMax(msecs, 1), 0, 'f', 1);
+}
 
 CarveSVGWindow::CarveSVGWindow(CarveWindow* window) : QStackedWidget(),
     untitled_(true),
     filename_(""),
-    mode_(Code), mainwindow_(window)
+    mode_(Code), mainwindow_(window),
+    lastParseTime_(-1), lastRebuildTime_(-1), avgRebuildTime_(-1),
+    refreshDelay_(REFRESH_DELAY_DEFAULT),
+    saveId_(-1), saveRevision_(-1), saveSize_(0),
+    journal_(NULL), bJournaling_(false), journalRevision_(-1)
 {
 
     static int numUntitledFiles = 1;
@@ -80,7 +107,11 @@ CarveSVGWindow::CarveSVGWindow(CarveWindow* window) : QStackedWidget(),
 
     // by making the window the model's parent, I believe this will take
     // care of destroying the model at the appropriate time
-    model_ = new CarveSVGDocument(StarterDoc, this);
+    model_ = new CarveSVGDocument(StarterDoc, this, new CarveGraphicsItemBuilder(this));
+    connect(this->model_, SIGNAL(domChanged()), this, SLOT(domChanged()));
+    // reported from the writer's thread, so the slot runs queued on ours
+    connect(this->mainwindow_->fileWriter(), SIGNAL(written(int, QString, bool, QString)),
+	    this, SLOT(fileWritten(int, QString, bool, QString)));
 
     // seed our text area with initial SVG bare-bones
     this->edit_->setPlainText(StarterDoc);
@@ -88,12 +119,25 @@ CarveSVGWindow::CarveSVGWindow(CarveWindow* window) : QStackedWidget(),
 
     this->edit_->document()->setModified(true);
 
+    // one journal per window, named after this process, which holds the lock
+    // that tells another Carve running at the same time the journal is in use
+    static int numJournals = 0;
+    QDir().mkpath(journalDirectory());
+    CarveJournal::lockSession(journalDirectory());
+    this->journal_ = new CarveJournal(QDir(journalDirectory()).filePath(
+	    QString("%1-%2.journal").arg(QCoreApplication::applicationPid()).arg(numJournals++)), this);
+    connect(this->journal_, SIGNAL(failed(QString)), this, SLOT(journalFailed(QString)));
+    connect(this->edit_->document(), SIGNAL(contentsChange(int, int, int)), this, SLOT(textChanged(int, int, int)));
+    this->journal_->reset(QString(), StarterDoc);
+    this->journalRevision_ = this->edit_->document()->revision();
+    this->bJournaling_ = true;
+
     init();
 }
 
 bool CarveSVGWindow::load(const QString& filename) {
     QFile file(filename);
-    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+    if (!file.open(QFile::ReadOnly)) {
         QMessageBox::warning(this, tr("Carve"),
             tr("Cannot read file %1:\n%2.")
             .arg(filename)
@@ -104,7 +148,12 @@ bool CarveSVGWindow::load(const QString& filename) {
     filename_ = filename;
     untitled_ = false;
 
-    QTextStream in(&file);
+    // a compressed file is inflated a chunk at a time as the stream decodes it
+    CarveGzipDevice gzip(&file);
+    bool bCompressed = CarveGzipDevice::isGzipped(&file);
+    if(bCompressed) { gzip.open(QIODevice::ReadOnly | QIODevice::Text); }
+    else { file.setTextModeEnabled(true); }
+    QTextStream in(bCompressed ? static_cast<QIODevice*>(&gzip) : &file);
     QApplication::setOverrideCursor(Qt::WaitCursor);
     setWindowTitle(QFileInfo(filename_).fileName() + "[*]");
 
@@ -112,8 +161,19 @@ bool CarveSVGWindow::load(const QString& filename) {
     // now set the text of the document, DOM document and determine the character positions
     // of each node in the document
     this->scene_->clear();
+    QTime readTimer;
+    readTimer.start();
     QString rawText = in.readAll();
+    int readTime = readTimer.elapsed();
+    if(gzip.hasError()) {
+	CARVE_WARNING(LogUI, QString("%1: %2").arg(filename).arg(gzip.errorString()));
+    }
+    CARVE_INFO(LogUI, throughputMessage("Read", filename, rawText.size(), readTime));
+    this->bJournaling_ = false;
     this->edit_->setPlainText(rawText);
+    this->bJournaling_ = true;
+    this->journal_->reset(filename_);
+    this->journalRevision_ = this->edit_->document()->revision();
     this->model_->setContent(rawText);
     // ========================================================================
 
@@ -133,7 +193,7 @@ bool CarveSVGWindow::save(const QString& lastPath) {
 
 bool CarveSVGWindow::saveAs(const QString& lastPath) {
     QString path = lastPath; path.append("/").append(filename_);
-    QString fileName = QFileDialog::getSaveFileName(this, tr("Save As"), path, "SVG Files (*.svg)");
+    QString fileName = QFileDialog::getSaveFileName(this, tr("Save As"), path, "SVG Files (*.svg);;Compressed SVG Files (*.svgz)");
     if (fileName.isEmpty())
         return false;
 
@@ -148,28 +208,56 @@ bool CarveSVGWindow::saveAs(const QString& lastPath) {
     return saveFile();
 }
 
+// filename_ now contains the file we want to save: hand a snapshot of the
+// text to the writer, which encodes and writes it on its own thread
 bool CarveSVGWindow::saveFile() {
-    // filename_ now contains the file we want to save
-    QFile file(filename_);
-    if(!file.open(QFile::WriteOnly | QFile::Text)) {
-        QMessageBox::warning(this, tr("MDI"),
+    QString text = this->edit_->toPlainText();
+    this->saveRevision_ = this->edit_->document()->revision();
+    this->saveSize_ = text.size();
+    this->saveTimer_.start();
+    this->saveId_ = this->mainwindow_->fileWriter()->write(filename_, text);
+    return true;
+}
+
+bool CarveSVGWindow::waitForSave() {
+    if(this->saveId_ < 0) { return true; }
+    QString error;
+    bool bOk = this->mainwindow_->fileWriter()->waitFor(this->saveId_, &error);
+    // the queued written() signal for this id is ignored once it arrives
+    fileWritten(this->saveId_, filename_, bOk, error);
+    return bOk;
+}
+
+void CarveSVGWindow::fileWritten(int id, const QString& fileName, bool bOk, const QString& error) {
+    if(id != this->saveId_) { return; }
+    this->saveId_ = -1;
+
+    if(!bOk) {
+        QMessageBox::warning(this, tr("Carve"),
             tr("Cannot write file %1:\n%2.")
-            .arg(filename_)
-            .arg(file.errorString()));
-        return false;
+            .arg(fileName)
+            .arg(error));
+        return;
     }
 
-    QTextStream out(&file);
-    QApplication::setOverrideCursor(Qt::WaitCursor);
-    out << this->edit_->toPlainText();
-    QApplication::restoreOverrideCursor();
-    this->edit_->document()->setModified(false);
-    this->setWindowModified(false);
+    CARVE_INFO(LogUI, throughputMessage("Wrote", fileName, this->saveSize_, this->saveTimer_.elapsed()));
 
-    return true;
+    // anything typed while the file was being written is still unsaved
+    // (and the journal has to keep it, from a snapshot, as the file it applied to is gone)
+    this->journal_->reset(fileName);
+    if(this->edit_->document()->revision() == this->saveRevision_) {
+	this->edit_->document()->setModified(false);
+	this->setWindowModified(false);
+    }
+    else {
+	this->journal_->compact(this->edit_->toPlainText());
+    }
+    emit saved(fileName);
 }
 
 void CarveSVGWindow::closeEvent(QCloseEvent* event) {
+    // a save still being written settles whether there is anything left to save
+    waitForSave();
     if(edit_->document()->isModified()) {
         QMessageBox::StandardButton ret;
         ret = QMessageBox::warning(this, tr("MDI"),
@@ -177,7 +265,8 @@ void CarveSVGWindow::closeEvent(QCloseEvent* event) {
             .arg(this->windowTitle()),
             QMessageBox::Save | QMessageBox::Discard | QMessageBox::Cancel);
         if (ret == QMessageBox::Save) {
-            if(save(dir_.absolutePath())) { event->accept(); }
+            // the window only goes once the file is safely written
+            if(save(dir_.absolutePath()) && waitForSave()) { event->accept(); }
             else { event->ignore(); }
         }
         else if (ret == QMessageBox::Cancel) {
@@ -189,6 +278,75 @@ void CarveSVGWindow::closeEvent(QCloseEvent* event) {
 	delete this->scene_;
         event->accept();
     }
+
+    if(event->isAccepted()) {
+	// saved or thrown away: nothing left to recover
+	this->journal_->discard();
+    }
+}
+
+QString CarveSVGWindow::journalDirectory() {
+    return QDir(QDesktopServices::storageLocation(QDesktopServices::DataLocation)).filePath("journal");
+}
+
+void CarveSVGWindow::recover(const QString& fileName, const QString& text) {
+    if(!fileName.isEmpty()) {
+	filename_ = fileName;
+	untitled_ = false;
+	dir_ = QFileInfo(filename_).absoluteDir();
+	setWindowTitle(QFileInfo(filename_).fileName() + "[*]");
+    }
+
+    this->bJournaling_ = false;
+    this->edit_->setPlainText(text);
+    this->bJournaling_ = true;
+    this->model_->setContent(text);
+    this->edit_->document()->setModified(true);
+    this->setWindowModified(true);
+
+    // the recovered text is still unsaved
+    this->journal_->reset(fileName);
+    this->journal_->compact(text);
+    this->journalRevision_ = this->edit_->document()->revision();
+}
+
+// Records an edit of the text in the journal.  The highlighter's format changes
+// are reported the same way, but only real edits move the document's revision.
+void CarveSVGWindow::textChanged(int position, int charsRemoved, int charsAdded) {
+    QTextDocument* doc = this->edit_->document();
+    if(!this->bJournaling_ || doc->revision() == this->journalRevision_) { return; }
+    this->journalRevision_ = doc->revision();
+
+    // a change that reaches the end of the text also counts the final paragraph
+    // separator, which is not part of the plain text
+    int end = doc->characterCount() - 1;
+    if(position + charsAdded > end) {
+	int overshoot = position + charsAdded - end;
+	charsAdded -= overshoot;
+	charsRemoved = qMax(0, charsRemoved - overshoot);
+    }
+
+    QString inserted;
+    if(charsAdded > 0) {
+	QTextCursor cursor(doc);
+	cursor.setPosition(position);
+	cursor.setPosition(position + charsAdded, QTextCursor::KeepAnchor);
+	// as toPlainText() has it
+	inserted = cursor.selectedText();
+	inserted.replace(QChar::ParagraphSeparator, QChar('\n'));
+	inserted.replace(QChar::LineSeparator, QChar('\n'));
+	inserted.replace(QChar::Nbsp, QChar(' '));
+    }
+    this->journal_->recordChange(position, charsRemoved, inserted);
+
+    // once the changes outweigh the text, a snapshot is cheaper to replay
+    if(this->journal_->changeBytes() > qMax(qint64(JOURNAL_COMPACT_MIN_BYTES), 2 * qint64(doc->characterCount()))) {
+	this->journal_->compact(this->edit_->toPlainText());
+    }
+}
+
+void CarveSVGWindow::journalFailed(const QString& error) {
+    CARVE_WARNING(LogUI, QString("Cannot write the recovery journal of %1: %2").arg(this->windowTitle()).arg(error));
 }
 
 void CarveSVGWindow::init() {
@@ -199,6 +357,33 @@ void CarveSVGWindow::documentWasModified() {
     this->setWindowModified(this->edit_->document()->isModified());
 }
 
+// A node changed the DOM (e.g. from the Properties pane): serialize the
+// document and set the editor's text (but make it undo-able)
+void CarveSVGWindow::domChanged() {
+    this->replaceText(this->model_->serialize());
+    this->updateDocImmediately();
+}
+
+// The serialized document only differs from the editor's text where it was
+// edited, so only the range between the common prefix and suffix is replaced:
+// the rest keeps its highlighting and the undo step stays small
+void CarveSVGWindow::replaceText(const QString& text) {
+    QString current = this->edit_->toPlainText();
+    int common = qMin(current.size(), text.size());
+    int prefix = 0;
+    while(prefix < common && current.at(prefix) == text.at(prefix)) { ++prefix; }
+    int suffix = 0;
+    while(suffix < common - prefix && current.at(current.size() - 1 - suffix) == text.at(text.size() - 1 - suffix)) { ++suffix; }
+    if(prefix == current.size() && prefix == text.size()) { return; }
+
+    QTextCursor cursor(this->edit_->document());
+    cursor.beginEditBlock();
+    cursor.setPosition(prefix);
+    cursor.setPosition(current.size() - suffix, QTextCursor::KeepAnchor);
+    cursor.insertText(text.mid(prefix, text.size() - prefix - suffix));
+    cursor.endEditBlock();
+}
+
 bool CarveSVGWindow::isValidXML() {
     QString t = this->edit_->toPlainText();
     delete this->scene_;
@@ -233,3 +418,18 @@ void CarveSVGWindow::switchMode(SVGWindowMode newMode) {
 void CarveSVGWindow::updateDocImmediately() {
     this->mainwindow_->updateDocImmediately();
 }
+
+void CarveSVGWindow::recordRebuild(int parseTime, int rebuildTime) {
+    lastParseTime_ = parseTime;
+    lastRebuildTime_ = rebuildTime;
+
+    // smooth out the odd slow rebuild (e.g. when the OS swapped us out)
+    if(avgRebuildTime_ < 0) {
+	avgRebuildTime_ = rebuildTime;
+    }
+    else {
+	avgRebuildTime_ = (avgRebuildTime_ + rebuildTime) / 2;
+    }
+
+    refreshDelay_ = qBound(REFRESH_DELAY_MIN, REFRESH_DELAY_FACTOR * avgRebuildTime_, REFRESH_DELAY_MAX);
+}
@@ -23,11 +23,14 @@
 #include <QPlainTextEdit>
 #include <QDir>
 #include <QStackedWidget>
+#include <QList>
+#include <QTime>
 
 class CarveSVGDocument;
 class CarveDesignView;
 class CarveScene;
 class CarveWindow;
+class CarveJournal;
 
 enum SVGWindowMode { Code, Design };
 
@@ -52,15 +55,43 @@ public:
     CarveWindow* mainwindow() { return mainwindow_; }
 
     bool load(const QString& filename);
+    // saving happens in the background: these return once the text has been
+    // handed to the writer, and saved() follows when it is on disk
     bool save(const QString& lastPath);
     bool saveAs(const QString& lastPath);
+    // blocks until the last save is on disk (for whatever needs the file itself)
+    bool waitForSave();
+    // takes over the unsaved text of fileName (empty for an untitled document) recovered from a journal
+    void recover(const QString& fileName, const QString& text);
+    // where the windows keep the journals of their unsaved edits
+    static QString journalDirectory();
 
     void updateDocImmediately();
+    // replaces the editor's text as one undo step, touching only the range that differs
+    void replaceText(const QString& text);
+
+    // adaptive refresh scheduling: the delay before the document is re-parsed
+    // and the scene rebuilt follows how long the last rebuild of this document took
+    int refreshDelay() const { return refreshDelay_; }
+    int lastParseTime() const { return lastParseTime_; }
+    int lastRebuildTime() const { return lastRebuildTime_; }
+    void recordRebuild(int parseTime, int rebuildTime);
+
+    // the DOM Browser rows that were expanded when this window was last active
+    const QList<QList<int> >& domTreeExpansion() const { return domTreeExpansion_; }
+    void setDomTreeExpansion(const QList<QList<int> >& paths) { domTreeExpansion_ = paths; }
+signals:
+    void saved(const QString& fileName);
+
 protected:
     void closeEvent(QCloseEvent *event);
 
 private slots:
     void documentWasModified();
+    void domChanged();
+    void fileWritten(int id, const QString& fileName, bool bOk, const QString& error);
+    void textChanged(int position, int charsRemoved, int charsAdded);
+    void journalFailed(const QString& error);
 
 private:
     bool untitled_;
@@ -72,6 +103,22 @@ private:
     CarveDesignView* view_;
     CarveScene* scene_;
     CarveWindow* mainwindow_;
+    int lastParseTime_;
+    int lastRebuildTime_;
+    int avgRebuildTime_;
+    int refreshDelay_;
+    QList<QList<int> > domTreeExpansion_;
+    // the writer's id of the save in progress (-1 if none), and the revision of the text it saves
+    int saveId_;
+    int saveRevision_;
+    // how much text the save in progress holds, and since when it is under way
+    int saveSize_;
+    QTime saveTimer_;
+    // every edit of the text since it was last saved, in case Carve crashes
+    CarveJournal* journal_;
+    // off while the text is replaced wholesale (the journal starts over instead)
+    bool bJournaling_;
+    int journalRevision_;
 
     void init();
     bool saveFile();
@@ -20,39 +20,65 @@
 
 #include "carvetextelement.h"
 #include "domhelper.h"
+#include "carveatoms.h"
 
 #include <QGraphicsSimpleTextItem>
 #include <QFont>
 #include <QFontMetrics>
+#include <QFontMetricsF>
 
-#include <iostream>
-using std::cout;
-using std::endl;
-
-CarveTextElement::CarveTextElement(const QDomElement& element, int row, CarveSVGWindow* window, CarveSVGNode* parent) :
-	CarveSVGNode(element, row, window, svgText, parent)
+CarveTextElement::CarveTextElement(const QDomElement& element, int row, CarveSVGDocument* document, CarveSVGNode* parent) :
+	CarveSVGNode(element, row, document, svgText, parent)
 {
+}
+
+CarveTextElement::~CarveTextElement() {
+}
+
+QFont CarveTextElement::font() {
+    // TODO: handle font-weight
+    // TODO: handle font-style
+    // TODO: handle font-variant
+    QFont theFont;
+
+    theFont.setFamily(this->getFontFamily());
+    theFont.setPointSizeF(this->getFontSize());
+    return theFont;
+}
+
+QPointF CarveTextElement::position() {
     bool bOk = false;
 
-    qreal x = getFloatTrait(element, "x",&bOk);
+    qreal x = getFloatTrait(this->domElem(), AtomX,&bOk);
     if(!bOk) {
 	x = 0.0;
     }
 
-    qreal y = getFloatTrait(element, "y",&bOk);
+    qreal y = getFloatTrait(this->domElem(), AtomY,&bOk);
     if(!bOk) {
 	y = 0.0;
     }
+    return QPointF(x, y);
+}
+
+QRectF CarveTextElement::geometryBounds() {
+    QFontMetricsF metrics(this->font());
+    // (x,y) is on the baseline
+    return strokedBounds(metrics.boundingRect(this->domElem().text()).translated(this->position()));
+}
+
+QGraphicsItem* CarveTextElement::createItem() {
+    QPointF pos = this->position();
 
     // TODO: handle tspan, a, etc inside the text element
-    QString textContents = element.text();
+    QString textContents = this->domElem().text();
 
     QGraphicsSimpleTextItem* item = new QGraphicsSimpleTextItem(textContents);
     item->setData(0, qVariantFromValue(reinterpret_cast<void*>(this)));
     item->setZValue(this->row());
-    item->setTransform(getTransform(this->domElem()));
+    item->setTransform(this->transform());
     item->setParentItem(this->parent()->gfxItem());    
-    QDomNode idAttr = this->domElem().attributes().namedItem("id");
+    QDomNode idAttr = this->domElem().attributes().namedItem(CarveAtoms::name(AtomId));
     if(!idAttr.isNull()) {
 	item->setToolTip(idAttr.nodeValue());
     }
@@ -60,31 +86,17 @@ CarveTextElement::CarveTextElement(const QDomElement& element, int row, CarveSVG
 
     // TODO: handle text-anchor
     // TODO: handle direction
-    // TODO: handle font-weight
-    // TODO: handle font-style
-    // TODO: handle font-variant
-    QFont theFont;
-
-    theFont.setFamily(this->getFontFamily());
-    theFont.setPointSizeF(this->getFontSize());
+    QFont theFont = this->font();
 
     item->setFont(theFont);
 
     QFontMetrics metrics(theFont);
 
     // TODO: properly position this w.r.t the baseline
-    item->setPos(x,y - metrics.ascent());
+    item->setPos(pos.x(), pos.y() - metrics.ascent());
 
-    this->getFillOpacity();
-    this->getStrokeLineCap();
-    this->getStrokeLineJoin();
-    this->getStrokeOpacity();
-    this->getStrokeWidth();
     item->setBrush(this->getFill());
     item->setPen(this->getStroke());
     this->gfxItem_ = item;
-
-}
-
-CarveTextElement::~CarveTextElement() {
+    return item;
 }
@@ -22,12 +22,20 @@
 
 #include "carvesvgnode.h"
 #include <QString>
+#include <QFont>
 
 class CarveTextElement : public CarveSVGNode
 {
 public:
-    CarveTextElement(const QDomElement& node, int row, CarveSVGWindow* window, CarveSVGNode* parent = 0);
+    CarveTextElement(const QDomElement& node, int row, CarveSVGDocument* document, CarveSVGNode* parent = 0);
     virtual ~CarveTextElement();
+protected:
+    virtual QGraphicsItem* createItem();
+    virtual QRectF geometryBounds();
+
+private:
+    QFont font();
+    QPointF position();
 };
 
 #endif // CARVETEXTELEMENT_H
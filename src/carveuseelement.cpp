@@ -0,0 +1,166 @@
+#include "carveuseelement.h"
+#include "carveuseitem.h"
+#include "carvesvgdocument.h"
+#include "carvescenebuilder.h"
+#include "domhelper.h"
+#include "profiler.h"
+#include "carvelog.h"
+#include "carveatoms.h"
+
+namespace {
+
+// nested <use> references deeper than this are treated as a cycle
+const int MAX_USE_DEPTH = 32;
+
+QString referencedId(const QDomElement& elem) {
+    QString href = getTrait(elem, AtomXlinkHref);
+    if(href.startsWith('#')) { return href.mid(1); }
+    if(!href.isEmpty()) {
+	CARVE_WARNING(LogModel, QString("<use> only supports references within the document ('%1')").arg(href));
+    }
+    return QString();
+}
+
+qreal floatTrait(const QDomElement& elem, CarveAtom name) {
+    bool bOk = false;
+    qreal value = getFloatTrait(elem, name, &bOk);
+    return bOk ? value : 0.0;
+}
+
+QPainterPath pointsPath(const QDomElement& elem, bool bClose) {
+    return parsePoints(getTrait(elem, AtomPoints), bClose);
+}
+
+// the outline of a basic shape or path, in its own user space
+QPainterPath shapePath(const QDomElement& elem, int tag, bool* bOk) {
+    *bOk = true;
+    QPainterPath path;
+    switch(tag) {
+	case AtomRect:
+	    path.addRect(floatTrait(elem, AtomX), floatTrait(elem, AtomY), floatTrait(elem, AtomWidth), floatTrait(elem, AtomHeight));
+	    break;
+	case AtomCircle: {
+	    qreal r = floatTrait(elem, AtomR);
+	    path.addEllipse(QPointF(floatTrait(elem, AtomCx), floatTrait(elem, AtomCy)), r, r);
+	    break;
+	}
+	case AtomEllipse:
+	    path.addEllipse(QPointF(floatTrait(elem, AtomCx), floatTrait(elem, AtomCy)), floatTrait(elem, AtomRx), floatTrait(elem, AtomRy));
+	    break;
+	case AtomLine:
+	    path.moveTo(floatTrait(elem, AtomX1), floatTrait(elem, AtomY1));
+	    path.lineTo(floatTrait(elem, AtomX2), floatTrait(elem, AtomY2));
+	    break;
+	case AtomPolyline: path = pointsPath(elem, false); break;
+	case AtomPolygon: path = pointsPath(elem, true); break;
+	case AtomPath: path = getPathTrait(elem, AtomD); break;
+	default:
+	    // <defs>, <title>, gradients... render nothing
+	    *bOk = false;
+	    return path;
+    }
+
+    path.setFillRule(getTrait(elem, AtomFillRule) == "evenodd" ? Qt::OddEvenFill : Qt::WindingFill);
+    return path;
+}
+
+}
+
+CarveUseElement::CarveUseElement(const QDomElement& element, int row, CarveSVGDocument* document, CarveSVGNode* parent) :
+	CarveSVGNode(element, row, document, svgUse, parent)
+{
+    QString id = referencedId(element);
+    if(!id.isEmpty()) {
+	this->geometry_ = document->useGeometry(id);
+    }
+    this->offset_ = QPointF(floatTrait(element, AtomX), floatTrait(element, AtomY));
+}
+
+CarveUseElement::~CarveUseElement() {
+}
+
+QRectF CarveUseElement::geometryBounds() {
+    if(!this->geometry_) { return QRectF(); }
+    QRectF bounds = this->geometry_->bounds();
+    if(this->geometry_->inheritsStroke()) {
+	bounds = strokedBounds(bounds);
+    }
+    return bounds.translated(this->offset_);
+}
+
+QGraphicsItem* CarveUseElement::createItem() {
+    bool bOk = false;
+
+    CarveUseItem* item = this->document()->builder()->createUseItem(this->geometry_);
+    finishDecorating(item);
+    // x and y translate the referenced content inside the element's own transform
+    item->setTransform(QTransform::fromTranslate(this->offset_.x(), this->offset_.y()) * item->transform());
+    item->setData(0, qVariantFromValue(reinterpret_cast<void*>(this)));
+    QBrush fill = this->getFill(&bOk);
+    item->setInheritedPaint(fill, this->getStroke(&bOk));
+    return item;
+}
+
+CarveUseGeometry* CarveUseElement::buildGeometry(const QDomElement& elem, CarveSVGDocument* document) {
+    CARVE_PROFILE("buildUseGeometry");
+    CarveUseGeometry* geometry = new CarveUseGeometry();
+    QStringList references;
+    references << elem.attribute(CarveAtoms::name(AtomId));
+
+    // the content is styled in its own right; whatever it leaves unspecified
+    // falls through to the instance, so the template root has no parent
+    CarveSVGNode root(elem, 0, document, svgUndefined, NULL);
+    collectParts(&root, getTransform(elem), geometry, &references);
+    return geometry;
+}
+
+void CarveUseElement::collectParts(CarveSVGNode* node, const QTransform& transform, CarveUseGeometry* geometry, QStringList* references) {
+    QDomElement elem = node->domElem();
+    int tag = CarveAtoms::find(elem.tagName());
+
+    if(tag == AtomG || tag == AtomA || tag == AtomSymbol || tag == AtomSvg) {
+	int row = 0;
+	for(QDomElement child = elem.firstChildElement(); !child.isNull(); child = child.nextSiblingElement(), ++row) {
+	    CarveSVGNode childNode(child, row, node->document(), svgUndefined, node);
+	    collectParts(&childNode, getTransform(child) * transform, geometry, references);
+	}
+	return;
+    }
+
+    if(tag == AtomUse) {
+	QString id = referencedId(elem);
+	if(id.isEmpty()) { return; }
+	if(references->contains(id) || references->size() >= MAX_USE_DEPTH) {
+	    CARVE_WARNING(LogModel, QString("Circular <use> reference to '#%1'").arg(id));
+	    return;
+	}
+	QDomElement target = node->document()->elementById(id);
+	if(target.isNull()) {
+	    CARVE_WARNING(LogModel, QString("<use> references missing element '#%1'").arg(id));
+	    return;
+	}
+
+	references->append(id);
+	CarveSVGNode content(target, 0, node->document(), svgUndefined, node);
+	QTransform offset = QTransform::fromTranslate(floatTrait(elem, AtomX), floatTrait(elem, AtomY));
+	collectParts(&content, getTransform(target) * offset * transform, geometry, references);
+	references->removeLast();
+	return;
+    }
+
+    bool bOk = false;
+    QPainterPath path = shapePath(elem, tag, &bOk);
+    if(!bOk) { return; }
+
+    CarveUseGeometry::Part part;
+    part.path = path;
+    part.transform = transform;
+
+    bool bFill = false, bStroke = false;
+    part.fill = node->getFill(&bFill);
+    part.stroke = node->getStroke(&bStroke);
+    // not specified anywhere inside the referenced content: the instance decides
+    part.bInheritFill = !bFill;
+    part.bInheritStroke = !bStroke;
+    geometry->addPart(part);
+}
@@ -0,0 +1,36 @@
+#ifndef CARVEUSEELEMENT_H
+#define CARVEUSEELEMENT_H
+
+#include "carvesvgnode.h"
+
+#include <QStringList>
+#include <QTransform>
+#include <QExplicitlySharedDataPointer>
+
+class CarveUseGeometry;
+
+// A <use> instance.  The referenced content is parsed into a CarveUseGeometry
+// once per document and shared; each instance only carries its own item,
+// transform and the paint its content inherits.
+class CarveUseElement : public CarveSVGNode
+{
+public:
+    CarveUseElement(const QDomElement& node, int row, CarveSVGDocument* document, CarveSVGNode* parent = 0);
+    virtual ~CarveUseElement();
+
+    // the rendered content of elem (a shape, <g>, <symbol> or another <use>)
+    static CarveUseGeometry* buildGeometry(const QDomElement& elem, CarveSVGDocument* document);
+
+protected:
+    virtual QGraphicsItem* createItem();
+    virtual QRectF geometryBounds();
+
+private:
+    QExplicitlySharedDataPointer<CarveUseGeometry> geometry_;
+    // x and y
+    QPointF offset_;
+
+    static void collectParts(CarveSVGNode* node, const QTransform& transform, CarveUseGeometry* geometry, QStringList* references);
+};
+
+#endif // CARVEUSEELEMENT_H
@@ -0,0 +1,76 @@
+#include "carveuseitem.h"
+
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+void CarveUseGeometry::addPart(const Part& part) {
+    parts_ << part;
+    shape_ = QPainterPath();
+
+    QRectF rect = part.path.boundingRect();
+    if(!part.bInheritStroke && part.stroke.style() != Qt::NoPen && part.stroke.brush().style() != Qt::NoBrush) {
+	qreal half = part.stroke.widthF() / 2;
+	rect.adjust(-half, -half, half, half);
+    }
+    bounds_ |= part.transform.mapRect(rect);
+    if(part.bInheritStroke) { bInheritsStroke_ = true; }
+}
+
+QPainterPath CarveUseGeometry::shape() const {
+    if(shape_.isEmpty()) {
+	for(int i = 0; i < parts_.size(); ++i) {
+	    shape_.addPath(parts_.at(i).transform.map(parts_.at(i).path));
+	}
+    }
+    return shape_;
+}
+
+CarveUseItem::CarveUseItem(const QExplicitlySharedDataPointer<CarveUseGeometry>& geometry, QGraphicsItem* parent) :
+	QGraphicsItem(parent),
+	geometry_(geometry),
+	fill_(Qt::black),
+	stroke_(Qt::NoPen)
+{
+}
+
+void CarveUseItem::setInheritedPaint(const QBrush& fill, const QPen& stroke) {
+    prepareGeometryChange();
+    fill_ = fill;
+    stroke_ = stroke;
+}
+
+QRectF CarveUseItem::boundingRect() const {
+    if(!geometry_) { return QRectF(); }
+    QRectF bounds = geometry_->bounds();
+    if(geometry_->inheritsStroke() && stroke_.style() != Qt::NoPen) {
+	qreal half = stroke_.widthF() / 2;
+	bounds.adjust(-half, -half, half, half);
+    }
+    return bounds;
+}
+
+QPainterPath CarveUseItem::shape() const {
+    if(!geometry_) { return QPainterPath(); }
+    return geometry_->shape();
+}
+
+void CarveUseItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*) {
+    if(!geometry_) { return; }
+
+    const QVector<CarveUseGeometry::Part>& parts = geometry_->parts();
+    for(int i = 0; i < parts.size(); ++i) {
+	const CarveUseGeometry::Part& part = parts.at(i);
+	painter->save();
+	painter->setTransform(part.transform, true);
+	painter->setBrush(part.bInheritFill ? fill_ : part.fill);
+	painter->setPen(part.bInheritStroke ? stroke_ : part.stroke);
+	painter->drawPath(part.path);
+	painter->restore();
+    }
+
+    if(option->state & QStyle::State_Selected) {
+	painter->setBrush(Qt::NoBrush);
+	painter->setPen(QPen(option->palette.windowText(), 0, Qt::DashLine));
+	painter->drawRect(boundingRect());
+    }
+}
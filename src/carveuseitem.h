@@ -0,0 +1,67 @@
+#ifndef CARVEUSEITEM_H
+#define CARVEUSEITEM_H
+
+#include <QGraphicsItem>
+#include <QSharedData>
+#include <QExplicitlySharedDataPointer>
+#include <QVector>
+#include <QPainterPath>
+#include <QTransform>
+#include <QBrush>
+#include <QPen>
+
+// The rendered content of an element referenced by <use>, built once per
+// referenced id and shared by every instance.  Paint that the content does not
+// specify itself is inherited from each <use>, so it is left to the instance.
+class CarveUseGeometry : public QSharedData
+{
+public:
+    struct Part {
+	QPainterPath path;
+	// from the part's user space to the referenced element's
+	QTransform transform;
+	QBrush fill;
+	QPen stroke;
+	bool bInheritFill;
+	bool bInheritStroke;
+    };
+
+    CarveUseGeometry() : bInheritsStroke_(false) {}
+
+    void addPart(const Part& part);
+    const QVector<Part>& parts() const { return parts_; }
+    bool isEmpty() const { return parts_.isEmpty(); }
+    // the painted area, excluding the width of inherited strokes
+    QRectF bounds() const { return bounds_; }
+    bool inheritsStroke() const { return bInheritsStroke_; }
+    // the outline of all parts, for selection
+    QPainterPath shape() const;
+
+private:
+    QVector<Part> parts_;
+    QRectF bounds_;
+    bool bInheritsStroke_;
+    mutable QPainterPath shape_;
+};
+
+// One <use> instance: a reference to the shared geometry plus its own
+// transform (kept by QGraphicsItem) and inherited paint.
+class CarveUseItem : public QGraphicsItem
+{
+public:
+    CarveUseItem(const QExplicitlySharedDataPointer<CarveUseGeometry>& geometry, QGraphicsItem* parent = 0);
+
+    void setInheritedPaint(const QBrush& fill, const QPen& stroke);
+    const CarveUseGeometry* geometry() const { return geometry_.data(); }
+
+    QRectF boundingRect() const;
+    QPainterPath shape() const;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = 0);
+
+private:
+    QExplicitlySharedDataPointer<CarveUseGeometry> geometry_;
+    QBrush fill_;
+    QPen stroke_;
+};
+
+#endif // CARVEUSEITEM_H
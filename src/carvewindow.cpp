@@ -18,15 +18,21 @@
 
 */
 #include "carvewindow.h"
-#include "../ui_HelpDialog.h"
-#include "../ui_PreferencesDialog.h"
-#include "../ui_FindDialog.h"
+#include "ui_HelpDialog.h"
+#include "ui_PreferencesDialog.h"
+#include "ui_FindDialog.h"
 #include "carvesvgdocument.h"
 #include "carvesvgwindow.h"
 #include "carvepreviewwindow.h"
 #include "version.h"
 #include "domtreeview.h"
 #include "propertiespane.h"
+#include "diagnosticspane.h"
+#include "profilerpane.h"
+#include "carvesvgnode.h"
+#include "carvelog.h"
+#include "carvefilewriter.h"
+#include "carvejournal.h"
 
 #include <QtGlobal>
 #include <QFileDialog>
@@ -42,70 +48,26 @@
 #include <QDockWidget>
 #include <QGraphicsView>
 #include <QGraphicsSvgItem>
-
-#include <iostream>
-using std::cout;
-using std::cerr;
-using std::endl;
+#include <QTime>
+#include <QDir>
+#include <QDateTime>
 
 const char* szXMLDisabled = "<span style='background-color:#eee; color:lightgrey; font-weight:bold'>&nbsp;XML&nbsp;</span>";
 const char* szXMLValid = "<span style='background-color:green; color:white; font-weight:bold'>&nbsp;XML&nbsp;</span>";
 const char* szXMLInvalid = "<span style='background-color:red; color:white; font-weight:bold'>&nbsp;XML&nbsp;</span>";
 
 const int MAX_DOCUMENTS = 16;
+// used until a document has told us how long it takes to rebuild (see CarveSVGWindow::refreshDelay())
 const int REFRESH_XML_TIMER = 2000;
 
 Ui::PreferencesDialog prefUI;
 
-// TODO: make this factory method a separate compilation unit eventually
-
-#include "carvesvgnode.h"
-#include "carvesvgelement.h"
-#include "carverectelement.h"
-#include "carvecircleelement.h"
-#include "carveellipseelement.h"
-#include "carvelineelement.h"
-#include "carvepolylineelement.h"
-#include "carvepolygonelement.h"
-#include "carvepathelement.h"
-#include "carvegelement.h"
-#include "carvetextelement.h"
-#include "carveaelement.h"
-#include "carveimageelement.h"
-
-CarveSVGNode* CarveSVGNode::createNode(const QDomDocument& doc, int row, CarveSVGWindow* window, CarveSVGNode* parent) {
-    return new CarveSVGNode(doc, row, window, svgUndefined, parent);
-}
-
-CarveSVGNode* CarveSVGNode::createNode(const QDomElement& node, int row, CarveSVGWindow* window, CarveSVGNode* parent) {
-    QString tagName = node.nodeName();
-    // subclasses of CarveSVGNode
-    if(tagName == "svg") { return new CarveSVGElement(node, row, window, parent); }
-    else if(tagName == "rect") { return new CarveRectElement(node, row, window, parent); }
-    else if(tagName == "circle") { return new CarveCircleElement(node, row, window, parent); }
-    else if(tagName == "ellipse") { return new CarveEllipseElement(node, row, window, parent); }
-    else if(tagName == "line") { return new CarveLineElement(node, row, window, parent); }
-    else if(tagName == "polyline") { return new CarvePolylineElement(node, row, window, parent); }
-    else if(tagName == "polygon") { return new CarvePolygonElement(node, row, window, parent); }
-    else if(tagName == "path") { return new CarvePathElement(node, row, window, parent); }
-    else if(tagName == "g") { return new CarveGElement(node, row, window, parent); }
-    else if(tagName == "text") { return new CarveTextElement(node, row, window, parent); }
-    else if(tagName == "a") { return new CarveAElement(node, row, window, parent); }
-    else if(tagName == "image") { return new CarveImageElement(node, row, window, parent); }
-    // instances of CarveSVGNode
-    else if(tagName == "linearGradient") { return new CarveSVGNode(node, row, window, svgLinearGradient, parent); }
-    else if(tagName == "radialGradient") { return new CarveSVGNode(node, row, window, svgRadialGradient, parent); }
-    else if(tagName == "stop") { return new CarveSVGNode(node, row, window, svgStop, parent); }
-    else if(tagName == "defs") { return new CarveSVGNode(node, row, window, svgDefs, parent); }
-    // unimplemented
-    return new CarveSVGNode(node, row, window, svgUndefined, parent);
-}
-
 CarveWindow::CarveWindow(QWidget *parent, Qt::WFlags flags)
     : QMainWindow(parent, flags),
       domBrowserColumn0Width(-1),
       timerDocModified(new QTimer(this)),
-      lastFindText(""), lastReplaceText("")
+      lastFindText(""), lastReplaceText(""),
+      fileWriter_(new CarveFileWriter(this))
 {
     QIcon icon(":/toolbars/images/Carve-48.png");
     this->setWindowIcon(icon);
@@ -197,6 +159,47 @@ CarveWindow::CarveWindow(QWidget *parent, Qt::WFlags flags)
     updateDocumentMenus();
 
     this->timerDocModified->start(REFRESH_XML_TIMER);
+
+    // once the window is up, offer whatever a crashed session left unsaved
+    QTimer::singleShot(0, this, SLOT(recoverJournals()));
+}
+
+// Journals are deleted when their window closes, so any that are left and
+// whose process no longer holds its lock belong to a session that did not end
+// cleanly; those of other instances still running are left alone
+void CarveWindow::recoverJournals() {
+    QDir dir(CarveSVGWindow::journalDirectory());
+    QStringList journals = dir.entryList(QStringList() << "*.journal", QDir::Files, QDir::Time | QDir::Reversed);
+    for(int i = 0; i < journals.size(); ++i) {
+	QString path = dir.filePath(journals.at(i));
+	if(!CarveJournal::isAbandoned(path)) { continue; }
+	QString fileName, text, error;
+	if(CarveJournal::replay(path, &fileName, &text, &error)) {
+	    QString name = fileName.isEmpty() ? tr("an untitled document") : QFileInfo(fileName).fileName();
+	    QMessageBox::StandardButton ret = QMessageBox::question(this, tr("Carve"),
+		tr("Carve did not shut down cleanly.\nDo you want to recover the unsaved changes to %1 from %2?")
+		.arg(name).arg(QFileInfo(path).lastModified().toString()),
+		QMessageBox::Yes | QMessageBox::No, QMessageBox::Yes);
+	    if(ret == QMessageBox::Yes) {
+		if(ui.mdiArea->subWindowList().size() >= MAX_DOCUMENTS) {
+		    // kept, to be offered again the next time Carve starts
+		    QMessageBox::warning(this, tr("Carve"),
+			tr("Too many documents are open to recover the changes to %1.\n"
+			   "They will be offered again the next time Carve starts.").arg(name));
+		    continue;
+		}
+		CarveSVGWindow* childWin = createMDIChild();
+		childWin->recover(fileName, text);
+		prepareNewChildWindow(childWin);
+	    }
+	}
+	else if(!error.isEmpty()) {
+	    QMessageBox::warning(this, tr("Carve"), tr("Unsaved changes could not be recovered:\n%1").arg(error));
+	}
+	// a recovered document keeps a journal of its own
+	QFile::remove(path);
+    }
+    CarveJournal::removeStaleLocks(dir.path());
 }
 
 void CarveWindow::closeEvent(QCloseEvent* event) {
@@ -208,6 +211,8 @@ void CarveWindow::closeEvent(QCloseEvent* event) {
         event->ignore();
     } else {
         saveSettings();
+        // don't quit halfway through writing a file
+        fileWriter_->waitForIdle();
         event->accept();
     }
 }
@@ -308,6 +313,42 @@ void CarveWindow::loadSettings() {
     settings.endGroup();
     // ========================================================================
 
+    // set up dockable Diagnostics pane (hidden by default)
+    settings.beginGroup("diagnostics");
+    bool bDiagPaneShow = settings.value("visible", false).toBool();
+    Qt::DockWidgetArea diagPaneState = (Qt::DockWidgetArea)settings.value("state", Qt::BottomDockWidgetArea).toInt();
+    QSize diagPaneSize = settings.value("size", QSize(256,128)).toSize();
+
+    QDockWidget* diagDock = new QDockWidget(tr("Diagnostics"), this);
+    this->diagPane = new DiagnosticsPane(diagPaneSize);
+    diagDock->setWidget(this->diagPane);
+    ui.menuWindow->insertAction(ui.menuWindow->actions().at(2), diagDock->toggleViewAction());
+    addDockWidget(diagPaneState != Qt::NoDockWidgetArea ? diagPaneState : Qt::BottomDockWidgetArea, diagDock);
+    if(diagPaneState == Qt::NoDockWidgetArea) {
+	diagDock->setFloating(true);
+    }
+    diagDock->setVisible(bDiagPaneShow);
+    settings.endGroup();
+    // ========================================================================
+
+    // set up dockable Profiler pane (hidden by default, profiling is always off at startup)
+    settings.beginGroup("profiler");
+    bool bProfPaneShow = settings.value("visible", false).toBool();
+    Qt::DockWidgetArea profPaneState = (Qt::DockWidgetArea)settings.value("state", Qt::BottomDockWidgetArea).toInt();
+    QSize profPaneSize = settings.value("size", QSize(256,256)).toSize();
+
+    QDockWidget* profDock = new QDockWidget(tr("Profiler"), this);
+    this->profPane = new ProfilerPane(profPaneSize);
+    profDock->setWidget(this->profPane);
+    ui.menuWindow->insertAction(ui.menuWindow->actions().at(3), profDock->toggleViewAction());
+    addDockWidget(profPaneState != Qt::NoDockWidgetArea ? profPaneState : Qt::BottomDockWidgetArea, profDock);
+    if(profPaneState == Qt::NoDockWidgetArea) {
+	profDock->setFloating(true);
+    }
+    profDock->setVisible(bProfPaneShow);
+    settings.endGroup();
+    // ========================================================================
+
     // text editor font family and size
     settings.beginGroup("texteditor");
     textEditorNewFont.setFamily(settings.value("fontfamily", "Courier").toString());
@@ -362,6 +403,28 @@ void CarveWindow::saveSettings() {
     settings.endGroup();
     // ========================================================================
 
+    // Diagnostics pane state
+    settings.beginGroup("diagnostics");
+    QDockWidget* diagDock = qobject_cast<QDockWidget*>(diagPane->parentWidget());
+    settings.setValue("visible", diagDock->isVisible());
+    settings.setValue("size", QSize(diagPane->size()));
+    Qt::DockWidgetArea diagPaneState = this->dockWidgetArea(diagDock);
+    if(diagDock->isFloating()) { diagPaneState = Qt::NoDockWidgetArea; } // floating
+    settings.setValue("state", (int)diagPaneState);
+    settings.endGroup();
+    // ========================================================================
+
+    // Profiler pane state
+    settings.beginGroup("profiler");
+    QDockWidget* profDock = qobject_cast<QDockWidget*>(profPane->parentWidget());
+    settings.setValue("visible", profDock->isVisible());
+    settings.setValue("size", QSize(profPane->size()));
+    Qt::DockWidgetArea profPaneState = this->dockWidgetArea(profDock);
+    if(profDock->isFloating()) { profPaneState = Qt::NoDockWidgetArea; } // floating
+    settings.setValue("state", (int)profPaneState);
+    settings.endGroup();
+    // ========================================================================
+
     // text editor font family and size
     settings.beginGroup("texteditor");
     settings.setValue("fontfamily", this->textEditorNewFont.family());
@@ -394,6 +457,7 @@ CarveSVGWindow* CarveWindow::createMDIChild() {
     CarveSVGWindow* childWin = new CarveSVGWindow(this);
     this->ui.mdiArea->addSubWindow(childWin);
     connect(childWin->edit(), SIGNAL(destroyed()), this, SLOT(updateDocumentMenus()));
+    connect(childWin, SIGNAL(saved(QString)), this, SLOT(fileSaved(QString)));
     connect(childWin->edit(), SIGNAL(copyAvailable(bool)), this->ui.actionCut, SLOT(setEnabled(bool)));
     connect(childWin->edit(), SIGNAL(copyAvailable(bool)), this->ui.actionCopy, SLOT(setEnabled(bool)));
     return childWin;
@@ -403,7 +467,7 @@ void CarveWindow::prepareNewChildWindow(CarveSVGWindow* childWin) {
     connect(childWin->edit()->document(), SIGNAL(contentsChanged()), this, SLOT(activeDocumentWasModified()));
     connect(childWin->edit(), SIGNAL(undoAvailable(bool)), ui.actionUndo, SLOT(setEnabled(bool)));
     connect(childWin->edit(), SIGNAL(redoAvailable(bool)), ui.actionRedo, SLOT(setEnabled(bool)));
-    this->timerDocModified->start(0);
+    this->updateDocImmediately();
     childWin->setFont(this->textEditorNewFont);
     childWin->show();
 }
@@ -425,7 +489,7 @@ void CarveWindow::fileNew() {
 void CarveWindow::fileOpen() {
     // only allow N child windows at a time
     if(ui.mdiArea->subWindowList().size() < MAX_DOCUMENTS) {
-        QString fileName = QFileDialog::getOpenFileName(this, tr("Open SVG Document"), lastPath, "SVG Documents (*.svg)");
+        QString fileName = QFileDialog::getOpenFileName(this, tr("Open SVG Document"), lastPath, "SVG Documents (*.svg *.svgz)");
         if (!fileName.isEmpty()) {
             // sync up lastPath
             lastPath = QFileInfo(fileName).absoluteDir().canonicalPath();
@@ -489,7 +553,7 @@ void CarveWindow::fileSave() {
 	if(childWin->isUntitled()) { fileSaveAs(); }
 	else if(childWin->save(lastPath)) {
 	    lastPath = QFileInfo(childWin->getFilename()).absoluteDir().canonicalPath().toStdString().c_str();
-	    statusBar()->showMessage(tr("File saved"), 3000);
+	    statusBar()->showMessage(tr("Saving..."));
 	}
     }
     else {
@@ -502,13 +566,17 @@ void CarveWindow::fileSaveAs() {
     if(childWin && childWin->saveAs(lastPath)) {
         lastPath = QFileInfo(childWin->getFilename()).absoluteDir().canonicalPath().toStdString().c_str();
         setCurrentFile(childWin->getFilename());
-        statusBar()->showMessage(tr("File saved"), 3000);
+        statusBar()->showMessage(tr("Saving..."));
     }
     else {
         // TODO: display some error dialog
     }
 }
 
+void CarveWindow::fileSaved(const QString& fileName) {
+    statusBar()->showMessage(tr("Saved %1").arg(QFileInfo(fileName).fileName()), 3000);
+}
+
 void CarveWindow::fileQuit() {
     this->close();
 }
@@ -781,10 +849,10 @@ void CarveWindow::enablePaste() {
 void CarveWindow::controlPlay() {
     static bool bPreviewWindowShown = false;
     CarveSVGWindow* childWin = this->activeSVGWindow();
-    if(childWin && childWin->save(lastPath) && !bPreviewWindowShown) {
+    // the preview loads the file, so it has to be on disk first
+    if(childWin && childWin->save(lastPath) && childWin->waitForSave() && !bPreviewWindowShown) {
 	bPreviewWindowShown = true;
         // bring up a modal
-        cout << childWin->getFilename().toStdString().c_str() << endl;
         CarvePreviewWindow preview(this, childWin->getFilename());
         preview.exec();
 	bPreviewWindowShown = false;
@@ -844,9 +912,8 @@ void CarveWindow::updateWindowMenu(QMdiSubWindow* window) {
             refreshXMLStatus(false);
 
             // change the DOM Browser tree's model to the new child window's
+	    // (this also brings back the rows that were expanded in it)
 	    domTree->setWindow(childWin);
-	    // expand all nodes
-            domTree->expandAll();
             // set column 0 width the first time
             if(domBrowserColumn0Width != -1) {
                 domTree->setColumnWidth(0, domBrowserColumn0Width);
@@ -937,7 +1004,11 @@ void CarveWindow::updateDocumentMenus() {
 }
 
 void CarveWindow::activeDocumentWasModified() {
-    this->timerDocModified->start(REFRESH_XML_TIMER);
+    // the user is typing again, so any rebuild that is still pending (even one that
+    // was asked for immediately) is pushed back until the document has been quiet
+    // for as long as its last rebuild suggests
+    CarveSVGWindow* childWin = this->activeSVGWindow();
+    this->timerDocModified->start(childWin ? childWin->refreshDelay() : REFRESH_XML_TIMER);
 }
 
 void CarveWindow::refreshXMLStatus(bool bRebuild) {
@@ -947,10 +1018,17 @@ void CarveWindow::refreshXMLStatus(bool bRebuild) {
 	if(bRebuild) {
 	    this->propPane->setNode(NULL);
 
-            // calling isValidXML() rebuilds everything
+	    QTime rebuildTimer;
+	    rebuildTimer.start();
+            // calling isValidXML() rebuilds everything, so the DOM Browser
+            // is reopened at the rows that were expanded before
+            QList<QList<int> > expansion = domTree->expandedPaths();
             bValid = childWin->isValidXML();
-            // expand all nodes
-            domTree->expandAll();
+            domTree->restoreExpansion(expansion);
+
+	    // the next refresh delay for this document is picked from how long this took
+	    childWin->recordRebuild(childWin->model()->parseTime(), rebuildTimer.elapsed());
+	    this->diagPane->updateWindow(childWin);
         }
         if(bValid) {
             labelXML->setText( szXMLValid );
@@ -1015,7 +1093,7 @@ void CarveWindow::selectNode(CarveSVGNode* node) {
 void CarveWindow::deleteNode(CarveSVGNode* node) {
     CarveSVGWindow* window = this->activeSVGWindow();
     if(!window) {
-	cout << "Error!  Deleting a node without an active window" << endl;
+	CARVE_ERROR(LogUI, "Deleting a node without an active window");
     }
 
     // clear the Properties pane
@@ -1036,20 +1114,9 @@ void CarveWindow::deleteNode(CarveSVGNode* node) {
 	window->model()->domDocument()->clear();
     }
     else {
-	// remove the DomElement
-	nodeToDelete.parentNode().removeChild(nodeToDelete);
-
-	// serialize the DOM and set the document's text (but make it undo-able)
-	QTextCursor cursor(window->edit()->document());
-	cursor.beginEditBlock();
-	cursor.select(QTextCursor::Document);
-	cursor.removeSelectedText();
-	// insert the reserialized DOM
-	// TODO: do a diff between the previous text contents and the reserialized DOM
-	// and then only change this text (this should reduce memory considerably)
-	// TODO: make this default indentation a setting
-	cursor.insertText(window->model()->domDocument()->toString(2));
-	cursor.endEditBlock();
+	// remove the element and set the document's text (but make it undo-able)
+	window->model()->removeNode(node);
+	window->replaceText(window->model()->serialize());
     }
 
     this->updateDocImmediately();
@@ -1106,7 +1173,7 @@ void CarveWindow::updateDocImmediately() {
 
 void CarveWindow::fileExportPNG() {
     CarveSVGWindow* childWin = this->activeSVGWindow();
-    if(childWin && childWin->save(lastPath)) {
+    if(childWin && childWin->save(lastPath) && childWin->waitForSave()) {
 	// create QGraphicsView with the SVG loaded in
 	QGraphicsView view;
 	view.setScene(new QGraphicsScene(&view));
@@ -1133,8 +1200,6 @@ void CarveWindow::fileExportPNG() {
 	}
 
 	// finally save the PNG
-	cout << "path = " << path.toStdString().c_str() << endl;
-	cout << "filename = " << fileName.toStdString().c_str() << endl;
 	img.save(fileName);
     }
 }
@@ -26,7 +26,7 @@
 #include <QVector>
 #include <QMdiArea>
 #include <QFont>
-#include "../ui_carvewindow.h"
+#include "ui_carvewindow.h"
 
 class CarveSVGDocument;
 class CarveSVGNode;
@@ -38,6 +38,9 @@ class QDialog;
 class QTreeView;
 class DomTreeView;
 class PropertiesPane;
+class DiagnosticsPane;
+class ProfilerPane;
+class CarveFileWriter;
 
 namespace Ui {
     class PreferencesDialog;
@@ -56,6 +59,8 @@ public:
 
     void updateDocImmediately();
     CarveSVGWindow* activeSVGWindow();
+    // saves the documents of all windows in the background
+    CarveFileWriter* fileWriter() { return fileWriter_; }
 
 protected:
     void closeEvent(QCloseEvent *event);
@@ -80,6 +85,9 @@ private:
     QString lastFindText;
     QString lastReplaceText;
     PropertiesPane* propPane;
+    DiagnosticsPane* diagPane;
+    ProfilerPane* profPane;
+    CarveFileWriter* fileWriter_;
 
     void loadSettings();
     void saveSettings();
@@ -120,6 +128,8 @@ private slots:
     void updateWindowMenu(QMdiSubWindow* window);
     void updateDocumentMenus();
     void activeDocumentWasModified();
+    void fileSaved(const QString& fileName);
+    void recoverJournals();
     void refreshXMLStatus(bool bRebuild = true);
     void chooseNewEditorFont();
     void domBrowserDocked(Qt::DockWidgetArea area);
@@ -0,0 +1,66 @@
+#include "diagnosticspane.h"
+#include "carvesvgwindow.h"
+#include "carvesvgdocument.h"
+
+#include <QTreeWidgetItem>
+#include <QStringList>
+#include <QFileInfo>
+
+DiagnosticsPane::DiagnosticsPane(const QSize& hint) :
+	QTreeWidget(), hint_(hint)
+{
+    setColumnCount(5);
+    setHeaderLabels(QStringList() << tr("Document") << tr("Parse (ms)") << tr("Rebuild (ms)") << tr("Delay (ms)")
+				  << tr("Path cache hits"));
+}
+
+void DiagnosticsPane::updateWindow(CarveSVGWindow* window) {
+    if(!window) { return; }
+
+    QTreeWidgetItem* item = items_.value(window, NULL);
+    if(!item) {
+	item = new QTreeWidgetItem(this);
+	items_[window] = item;
+	connect(window, SIGNAL(destroyed(QObject*)), this, SLOT(windowDestroyed(QObject*)));
+    }
+
+    QString title = window->windowTitle();
+    if(!window->isUntitled()) {
+	title = QFileInfo(window->getFilename()).fileName();
+    }
+    title.remove("[*]");
+
+    item->setText(0, title);
+    QString parseTime("-");
+    if(window->lastParseTime() >= 0) {
+	// the store is parsed beside the DOM, so its share is shown separately
+	parseTime = window->model()
+	    ? tr("%1 (store %2)").arg(window->lastParseTime()).arg(window->model()->storeParseTime())
+	    : QString::number(window->lastParseTime());
+    }
+    item->setText(1, parseTime);
+    item->setText(2, window->lastRebuildTime() < 0 ? QString("-") : QString::number(window->lastRebuildTime()));
+    item->setText(3, QString::number(window->refreshDelay()));
+    if(window->model()) {
+	const CarvePathCache* cache = window->model()->pathCache();
+	int lookups = cache->hits() + cache->misses();
+	item->setText(4, lookups == 0 ? QString("-")
+		      : QString("%1/%2 (%3%)").arg(cache->hits()).arg(lookups).arg(qRound(100 * cache->hitRate())));
+    }
+
+    // replace the list of problems
+    qDeleteAll(item->takeChildren());
+    if(window->model()) {
+	const QStringList& errors = window->model()->errors();
+	for(int i = 0; i < errors.size(); ++i) {
+	    QTreeWidgetItem* child = new QTreeWidgetItem(item);
+	    child->setText(0, errors.at(i));
+	    child->setFirstColumnSpanned(true);
+	}
+	item->setExpanded(!errors.isEmpty());
+    }
+}
+
+void DiagnosticsPane::windowDestroyed(QObject* window) {
+    delete items_.take(window);
+}
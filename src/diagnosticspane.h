@@ -0,0 +1,33 @@
+#ifndef DIAGNOSTICSPANE_H
+#define DIAGNOSTICSPANE_H
+
+#include <QTreeWidget>
+#include <QHash>
+
+class QTreeWidgetItem;
+class CarveSVGWindow;
+
+// Shows how long each open document took to parse and rebuild and the
+// refresh delay that was chosen for it as a result, and how many of its
+// outlines came from the path cache, with the warnings and errors collected
+// while building its model listed underneath
+class DiagnosticsPane : public QTreeWidget
+{
+    Q_OBJECT
+
+public:
+    DiagnosticsPane(const QSize& hint);
+    QSize sizeHint() const { return hint_; }
+
+public slots:
+    void updateWindow(CarveSVGWindow* window);
+
+private slots:
+    void windowDestroyed(QObject* window);
+
+private:
+    QSize hint_;
+    QHash<QObject*, QTreeWidgetItem*> items_;
+};
+
+#endif // DIAGNOSTICSPANE_H
@@ -19,6 +19,10 @@
 */
 
 #include "domhelper.h"
+#include "carvelog.h"
+#include "carveparse.h"
+#include "carvecolor.h"
+#include "carveatoms.h"
 
 #include <QDomNode>
 #include <QString>
@@ -33,10 +37,6 @@
 #include <QTextCursor>
 #include <cmath>
 
-#include <iostream>
-using std::cout;
-using std::endl;
-
 QRegExp commaOrWS("(\\s*\\,\\s*)|\\s+");
 QRegExp coord("\\-?\\d+\\.?\\d*");
 QRegExp pct("(\\d+\\.?\\d*)\\%");
@@ -46,7 +46,7 @@ QDomElement getElementById(const QDomElement& element, const QString& id) {
     if(element.isNull()) { return QDomElement(); }
     if(id.isEmpty() || id.isNull()) { return QDomElement(); }
 
-    if(element.attribute("id") == id) {
+    if(element.attribute(CarveAtoms::name(AtomId)) == id) {
 	return element;
     }
 
@@ -72,6 +72,30 @@ QString getTrait(const QDomElement& element, const QString& name, bool* bOk) {
     return QString();
 }
 
+QString getTrait(const QDomElement& element, CarveAtom name, bool* bOk) {
+    return getTrait(element, CarveAtoms::name(name), bOk);
+}
+
+double getFloatTrait(const QDomElement& element, CarveAtom name, bool* bOk) {
+    return getFloatTrait(element, CarveAtoms::name(name), bOk);
+}
+
+QBrush getRGBColorTrait(const QDomElement& element, CarveAtom name, bool* bOk) {
+    return getRGBColorTrait(element, CarveAtoms::name(name), bOk);
+}
+
+QStringList getListTrait(const QDomElement& element, CarveAtom name, bool* bOk) {
+    return getListTrait(element, CarveAtoms::name(name), bOk);
+}
+
+double getPercentageTrait(const QDomElement& element, CarveAtom name, bool* bOk) {
+    return getPercentageTrait(element, CarveAtoms::name(name), bOk);
+}
+
+QPainterPath getPathTrait(const QDomElement& element, CarveAtom name, bool* bOk) {
+    return getPathTrait(element, CarveAtoms::name(name), bOk);
+}
+
 double getFloatTrait(const QDomElement& element, const QString& name, bool* bOk) {
     if(bOk) { *bOk = false; }
     if(element.isNull()) { return 0.0; }
@@ -100,46 +124,13 @@ double getPercentageTrait(const QDomElement& element, const QString& name, bool*
 QBrush getRGBColorTrait(const QString& colorString, bool* bOk) {
     // TODO: if we match against a url(#name) then try to find that reference first
     // (if it's a gradient or if it's a solidColor element then return QColor() and false?)
-
-    // TODO: this reports an error on std::out or std::err if it's not of the following
-    // formats: #RGB, #RRGGBB, or one of the SVG color names.  How to shut this off?
-    QColor color(colorString);
-    if(color.isValid()) {
+    QRgb rgba;
+    if(parseColor(colorString, &rgba)) {
 	if(bOk) { *bOk = true; }
-	return QBrush(color);
-    }
-
-    // else, need to try and parse the "rgb(r,g,b)" format and return that color if found
-    // From http://www.w3.org/TR/SVGTiny12/painting.html#colorSyntax
-    bool bR, bG, bB;
-
-    // TODO: what whitespace rules should I follow here?  sprinkle some \\s* around?
-    // Integer functional:  rgb(rrr,ggg,bbb)
-    QRegExp intfn("^rgb\\(\\s*(\\d{1,3})\\s*\\,\\s*(\\d{1,3})\\s*\\,\\s*(\\d{1,3})\\)$");
-    if(intfn.exactMatch(colorString)) {
-	QStringList strings(intfn.capturedTexts());
-	int r = strings.at(1).toInt(&bR);
-	int g = strings.at(2).toInt(&bG);
-	int b = strings.at(3).toInt(&bB);
-	if(r >= 0 && r <= 255 && g >= 0 && g <= 255 && b >= 0 && b <= 255 && bR && bG && bB) {
-	    if(bOk) { *bOk = true; }
-	    return QBrush(QColor(r,g,b));
-	}
+	return QBrush(QColor::fromRgba(rgba));
     }
 
-    // Float functional:  rgb(R%, G%, B%)
-    // (1 or more digits, followed by 0 or 1 decimal point, followed by 0 or more digits)
-    QRegExp floatfn("^rgb\\(\\s*(\\d+\\.?\\d*)\\%\\s*\\,\\s*(\\d+\\.?\\d*)\\%\\s*\\,\\s*(\\d+\\.?\\d*)\\%\\)$");
-    if(floatfn.exactMatch(colorString)) {
-	QStringList strings(floatfn.capturedTexts());
-	double r = strings.at(1).toDouble(&bR);
-	double g = strings.at(2).toDouble(&bG);
-	double b = strings.at(3).toDouble(&bB);
-	if(r >= 0 && r <= 100 && g >= 0 && g <= 100 && b >= 0 && b <= 100 && bR && bG && bB) {
-	    if(bOk) { *bOk = true; }
-            return QBrush(QColor((int)((r/100.0)*255),(int)((g/100.0)*255),(int)((b/100.0)*255)));
-	}
-    }
+    if(bOk) { *bOk = false; }
     return QBrush();
 }
 
@@ -167,6 +158,25 @@ QStringList getListTrait(const QDomElement& element, const QString& name, bool*
     return QStringList();
 }
 
+QPolygonF parsePoints(const QString& text, bool* bOk) {
+    QPolygonF points;
+    bool bParsed = parsePointList(text.constData(), text.constData() + text.size(), &points);
+    if(bOk) { *bOk = bParsed && !points.isEmpty(); }
+    return bParsed ? points : QPolygonF();
+}
+
+QPainterPath parsePoints(const QString& text, bool bClose, bool* bOk) {
+    QPainterPath path;
+    bool bParsed = false;
+    QPolygonF points(parsePoints(text, &bParsed));
+    if(bOk) { *bOk = bParsed; }
+    if(!bParsed) { return path; }
+
+    path.addPolygon(points);
+    if(bClose) { path.closeSubpath(); }
+    return path;
+}
+
 // This is so much fun thanks to the spec:
 // Commands are one letter:  M, L, H, V, Z, C, S, Q, T, A
 // command can also be lower-case (relative)
@@ -239,14 +249,24 @@ int findCoords(const QString& text, int index) {
 QPainterPath getPathTrait(const QDomElement& element, const QString& name, bool* bOk) {
     if(bOk) { *bOk = false; }
     if(element.isNull()) { return QPainterPath(); }
-    QPainterPath path;
-    path.moveTo(0,0);
 
     QDomNode attrNode(element.attributes().namedItem(name));
-    if(!attrNode.isNull()) {
-	if(bOk) { *bOk = true; }
+    if(attrNode.isNull()) {
+	QPainterPath path;
+	path.moveTo(0,0);
+	path.closeSubpath();
+	return path;
+    }
+    return parsePath(attrNode.nodeValue(), bOk);
+}
 
-	QString text = attrNode.nodeValue().trimmed();
+QPainterPath parsePath(const QString& data, bool* bOk) {
+    if(bOk) { *bOk = true; }
+    QPainterPath path;
+    path.moveTo(0,0);
+
+    {
+	QString text = data.trimmed();
 
 	int index = 0;
 	EPathParserState state = START, prevState = START;
@@ -490,175 +510,147 @@ QPainterPath getPathTrait(const QDomElement& element, const QString& name, bool*
 		    break; }
 		//*/
 		case ERROR: {
-		    cout << "ERROR in path parsing" << endl;
+		    CARVE_WARNING(LogParse, QString("Error in path data at offset %1").arg(index));
 		    if(bOk) { *bOk = false; }
 		    return QPainterPath(); }
 		case NONE: {
 		    index = text.size();
 		    break; }
 		default: {
-		    cout << "Remaining commands not supported yet" << endl;
+		    CARVE_WARNING(LogParse, QString("Unsupported path command at offset %1").arg(index));
 		    index = text.size();
 		    break; }
 	    } // switch(state)
 	    prevState = state;
 	} // while(index < text.size())
-    } // had the attribute
+    }
 
     path.closeSubpath();
     return path;
 }
 
-QRegExp coorde("[\\-\\+]?\\d+\\.?\\d*([eE][\\-\\+]?\\d+)?");
-QRegExp separateExp("([\\-\\+\\d\\.]+)[eE]([\\-\\+\\d\\.]+)");
-QList<qreal> getTransformValues(const QString& val, bool* bOk) {
-    QList<qreal> results;
-    if(bOk) { *bOk = false; }
+namespace {
 
-    QStringList strings(val.trimmed().split(commaOrWS));
-    if(strings.size() > 0) {
-	for(int i = 0; i < strings.size(); ++i) {
-	    QString num(strings.at(i));
-	    if(coorde.exactMatch(num)) {
-		// if it doesn't contain an exponent, parse to a qreal immediately
-		if(!separateExp.exactMatch(num)) {
-		    results.append(strings.at(i).toDouble(bOk));
-		    if(bOk && *bOk == false) { return QList<qreal>(); }
-		}
-		// else, extract exponent part, parse both to qreals, do math
-		else {
-		    QStringList vals(separateExp.capturedTexts());
-		    if(vals.length() == 3) {
-			if(bOk) { *bOk = true; }
-			qreal base = vals.at(1).toDouble(bOk);
-			if(bOk && *bOk == false) { return QList<qreal>(); }
-			qreal exp = vals.at(2).toDouble(bOk);
-			if(bOk && *bOk == false) { return QList<qreal>(); }
-			results.append( base * pow(10,exp) );
-		    }
-		    else {
-			if(bOk) { *bOk = false; }
-			return QList<qreal>();
-		    }
-		}
-	    }
-	}
+enum TransformType { TransformNone, TransformMatrix, TransformTranslate, TransformScale, TransformRotate, TransformSkewX, TransformSkewY };
+
+bool matchKeyword(const QChar*& pos, const QChar* end, const char* keyword) {
+    const QChar* p = pos;
+    while(*keyword) {
+	if(p >= end || p->unicode() != ushort(*keyword)) { return false; }
+	++p;
+	++keyword;
     }
-    return results;
+    pos = p;
+    return true;
 }
 
-QRegExp xform("\\b(translate|scale|rotate|skewX|skewY|matrix)\\b\\s*\\(([\\-\\+\\.\\d\\s\\,eE]+)\\)");
-QTransform getTransform(const QDomElement& element, bool* bOk) {
+TransformType parseTransformType(const QChar*& pos, const QChar* end) {
+    if(pos >= end) { return TransformNone; }
+    switch(pos->unicode()) {
+	case 'm': return matchKeyword(pos, end, "matrix") ? TransformMatrix : TransformNone;
+	case 't': return matchKeyword(pos, end, "translate") ? TransformTranslate : TransformNone;
+	case 'r': return matchKeyword(pos, end, "rotate") ? TransformRotate : TransformNone;
+	case 's':
+	    if(matchKeyword(pos, end, "scale")) { return TransformScale; }
+	    if(matchKeyword(pos, end, "skewX")) { return TransformSkewX; }
+	    if(matchKeyword(pos, end, "skewY")) { return TransformSkewY; }
+	    return TransformNone;
+	default: return TransformNone;
+    }
+}
+
+}
+
+// Parses an SVG transform list in a single pass, composing each transform
+// directly into the result.  A syntax error anywhere makes the whole list
+// invalid (identity), as in browsers.
+QTransform parseTransform(const QString& text, bool* bOk) {
     if(bOk) { *bOk = false; }
-    if(element.isNull()) { return QTransform(); }
 
-    QList<QTransform> tlist;
-    QDomNode attrNode(element.attributes().namedItem("transform"));
-    if(!attrNode.isNull()) {
-	QString attrValue(attrNode.nodeValue());
-	int index = 0;
-	while((index = xform.indexIn(attrValue,index)) != -1) {
-	    index += xform.matchedLength();
-
-	    // first captured string is the transform type
-	    // second captured string is the values in the parentheses (which must further be parsed)
-	    QStringList strings(xform.capturedTexts());
-	    if(strings.length() == 3) {
-		// parse out parentheses contents
-		// ...
-		QString transformType = strings.at(1);
-		QList<qreal> values(getTransformValues(strings.at(2).trimmed(),bOk));
-
-		if(transformType == "translate") {
-		    if(values.size() == 2) {
-			if(bOk) { *bOk = true; }
-			QTransform t;
-			t.translate(values.at(0), values.at(1));
-			tlist.append(t);
-		    }
-		    else if(values.size() == 1) {
-			if(bOk) { *bOk = true; }
-			QTransform t;
-			t.translate(values.at(0), 0);
-			tlist.append(t);
-		    }
-		}
-		else if(transformType == "scale") {
-		    if(values.size() == 2) {
-			if(bOk) { *bOk = true; }
-			QTransform t;
-			t.scale(values.at(0), values.at(1));
-			tlist.append(t);
-		    }
-		    else if(values.size() == 1) {
-			if(bOk) { *bOk = true; }
-			QTransform t;
-			t.scale(values.at(0), values.at(0));
-			tlist.append(t);
-		    }
-		}
-		else if(transformType == "rotate") {
-		    if(values.size() == 3) {
-			if(bOk) { *bOk = true; }
-			QTransform t;
-			t.translate(values.at(1), values.at(2));
-			t.rotate(values.at(0));
-			t.translate(-values.at(1), -values.at(2));
-			tlist.append(t);
-		    }
-		    else if(values.size() == 1) {
-			if(bOk) { *bOk = true; }
-			QTransform t;
-			t.rotate(values.at(0));
-			tlist.append(t);
-		    }
-		}
-		else if(transformType == "skewX") {
-		    if(values.size() == 1) {
-			if(bOk) { *bOk = true; }
-			QTransform t(1, 0, 0,
-				    tan(values.at(0)*PI/180), 1, 0,
-				    0, 0, 1);
-			tlist.append(t);
-		    }
-		}
-		else if(transformType == "skewY") {
-		    if(values.size() == 1) {
-			if(bOk) { *bOk = true; }
-			QTransform t(1, tan(values.at(0)*PI/180), 0,
-				    0, 1, 0,
-				    0, 0, 1);
-			tlist.append(t);
-		    }
-		}
-		else if(transformType == "matrix") {
-		    if(values.size() == 6) {
-			if(bOk) { *bOk = true; }
-			QTransform t(values.at(0), values.at(1), 0, values.at(2), values.at(3), 0, values.at(4), values.at(5), 1);
-			tlist.append(t);
-		    }
-		}
-		else { // invalid transform type
-		    if(bOk) { *bOk = false; }
-		    return QTransform();
+    QTransform result;
+    const QChar* pos = text.constData();
+    const QChar* end = pos + text.size();
+    bool bAny = false;
+
+    skipWhitespace(pos, end);
+    while(pos < end) {
+	TransformType type = parseTransformType(pos, end);
+	if(type == TransformNone) { break; }
+
+	skipWhitespace(pos, end);
+	if(pos >= end || pos->unicode() != '(') { break; }
+	++pos;
+	skipWhitespace(pos, end);
+
+	double v[6];
+	int n = 0;
+	while(pos < end && pos->unicode() != ')') {
+	    if(n == 6 || !parseNumber(pos, end, &v[n])) { n = -1; break; }
+	    ++n;
+	    skipCommaWhitespace(pos, end);
+	}
+	if(n < 0 || pos >= end) { break; }
+	++pos; // ')'
+
+	// the list is applied right to left, so each transform goes in front of what we have so far
+	bool bValid = true;
+	switch(type) {
+	    case TransformMatrix:
+		if(n == 6) { result = QTransform(v[0], v[1], v[2], v[3], v[4], v[5]) * result; }
+		else { bValid = false; }
+		break;
+	    case TransformTranslate:
+		if(n == 1 || n == 2) { result.translate(v[0], n == 2 ? v[1] : 0); }
+		else { bValid = false; }
+		break;
+	    case TransformScale:
+		if(n == 1 || n == 2) { result.scale(v[0], n == 2 ? v[1] : v[0]); }
+		else { bValid = false; }
+		break;
+	    case TransformRotate:
+		if(n == 1) { result.rotate(v[0]); }
+		else if(n == 3) {
+		    result.translate(v[1], v[2]);
+		    result.rotate(v[0]);
+		    result.translate(-v[1], -v[2]);
 		}
-	    }
-	    else {
-		if(bOk) { *bOk = false; }
-		return QTransform();
-	    }
+		else { bValid = false; }
+		break;
+	    case TransformSkewX:
+		if(n == 1) { result.shear(tan(v[0]*PI/180), 0); }
+		else { bValid = false; }
+		break;
+	    case TransformSkewY:
+		if(n == 1) { result.shear(0, tan(v[0]*PI/180)); }
+		else { bValid = false; }
+		break;
+	    default:
+		bValid = false;
+		break;
 	}
+	if(!bValid) { break; }
+	bAny = true;
+
+	skipCommaWhitespace(pos, end);
     }
 
-    if(tlist.size() > 0) {
-	QTransform t;
-	for(int i = tlist.size()-1; i >= 0; i--) {
-	    t *= tlist.at(i);
-	}
-	return t;
+    if(pos < end) {
+	CARVE_WARNING(LogParse, QString("Invalid transform list '%1'").arg(text));
+	return QTransform();
     }
 
-    return QTransform();
+    if(bOk) { *bOk = bAny; }
+    return result;
+}
+
+QTransform getTransform(const QDomElement& element, bool* bOk) {
+    if(bOk) { *bOk = false; }
+    if(element.isNull()) { return QTransform(); }
+
+    QDomNode attrNode(element.attributes().namedItem(CarveAtoms::name(AtomTransform)));
+    if(attrNode.isNull()) { return QTransform(); }
+
+    return parseTransform(attrNode.nodeValue(), bOk);
 }
 
 // Something in the editor has changed an attribute value on this node
@@ -691,7 +683,7 @@ QGradientStops fetchGradientStops(QDomElement paintServer, qreal opacity) {
 	}
 
 	QColor stopColor;
-	QBrush stopBrush = getRGBColorTrait(stop, "stop-color", &bColor);
+	QBrush stopBrush = getRGBColorTrait(stop, AtomStopColor, &bColor);
 	if(!bColor || stopBrush.style() == Qt::NoBrush) {
 	    stopColor = QColor("black");
 	}
@@ -699,7 +691,7 @@ QGradientStops fetchGradientStops(QDomElement paintServer, qreal opacity) {
 	    stopColor = stopBrush.color();
 	}
 
-	qreal stopOpacity = getFloatTrait(stop, "stop-opacity", &bOpac);
+	qreal stopOpacity = getFloatTrait(stop, AtomStopOpacity, &bOpac);
 	if(!bOpac || stopOpacity < 0 || stopOpacity > 1.0) { stopOpacity = 1.0; }
 
         stopColor.setAlpha((int)(stopOpacity * opacity * 255.0));
@@ -730,7 +722,7 @@ QLinearGradient resolveLinearGradient(const QDomElement& element, qreal opacity,
 
     // check the xlink:href attribute on this element, if it refers to a valid linear/radial gradient
     // that is not in our referenceStack, then go fetch it and copy the valid attributes and stops
-    QString href = getTrait(element, "xlink:href", &bOk);
+    QString href = getTrait(element, AtomXlinkHref, &bOk);
     if(bOk && !href.isEmpty()) {
 	int refIndex = uriFrag.indexIn(href);
 	if(refIndex == 0) {
@@ -746,7 +738,6 @@ QLinearGradient resolveLinearGradient(const QDomElement& element, qreal opacity,
 			// recursively call the resolve function to get the gradient
 			QLinearGradient refGrad = resolveLinearGradient(refElem, opacity, referenceStack);
 			// apply relevant stops and attributes to g
-			cout << "refGrad.end = " << refGrad.finalStop().x() << "," << refGrad.finalStop().y() << endl;
 			g.setStart(refGrad.start());
 			g.setFinalStop(refGrad.finalStop());
 			g.setCoordinateMode(refGrad.coordinateMode());
@@ -762,15 +753,15 @@ QLinearGradient resolveLinearGradient(const QDomElement& element, qreal opacity,
 			g.setSpread(refGrad.spread());
 		    }
 		    else {
-			cout << "Error! Reference '" << refID.toStdString().c_str() << "' is not a linear/radial gradient" << endl;
+			CARVE_WARNING(LogStyle, QString("Reference '%1' is not a linear/radial gradient").arg(refID));
 		    }
 		}
 		else {
-		    cout << "Error!  Gradient reference '" << refID.toStdString().c_str() << "' not found" << endl;
+		    CARVE_WARNING(LogStyle, QString("Gradient reference '%1' not found").arg(refID));
 		}
 	    }
 	    else {
-		cout << "Error!  Circular reference detected with gradient '" << refID.toStdString().c_str() << "'" << endl;
+		CARVE_WARNING(LogStyle, QString("Circular reference detected with gradient '%1'").arg(refID));
 	    }
 	} // found a URI frag
     } // found xlink:href
@@ -788,8 +779,6 @@ QLinearGradient resolveLinearGradient(const QDomElement& element, qreal opacity,
     qreal y1 = element.attribute("y1", QString("%1").arg(curStart.y())).toDouble(&by1);
     qreal x2 = element.attribute("x2", QString("%1").arg(curEnd.x())).toDouble(&bx2);
     qreal y2 = element.attribute("y2", QString("%1").arg(curEnd.y())).toDouble(&by2);
-    cout << "Parsed x2,y2 = " << x2 << "," << y2 << endl;
-    cout << "Flags bx2, by2 = " << bx2 << "," << by2 << endl;
 
     // x1,y1,x2,y2 will now be populated with some value
     // however, if x1="foo", x1 will be 0 but bx1 will be false
@@ -807,7 +796,7 @@ QLinearGradient resolveLinearGradient(const QDomElement& element, qreal opacity,
 
     // gradientUnits attribute
     // (gradientUnits="userSpaceOnUse", objectBoundingBox is the default mode set above)
-    QString gradientUnits(getTrait(element, "gradientUnits"));
+    QString gradientUnits(getTrait(element, AtomGradientUnits));
     if(gradientUnits == "userSpaceOnUse") {
 	g.setCoordinateMode(QGradient::LogicalMode);
     }
@@ -817,7 +806,7 @@ QLinearGradient resolveLinearGradient(const QDomElement& element, qreal opacity,
     }
 
     // spreadMethod attribute, default is "pad" set above
-    QString spreadMethod(getTrait(element, "spreadMethod"));
+    QString spreadMethod(getTrait(element, AtomSpreadMethod));
     if(spreadMethod == "reflect") {
 	g.setSpread(QGradient::ReflectSpread);
     }
@@ -849,7 +838,7 @@ QRadialGradient resolveRadialGradient(const QDomElement& element, qreal opacity,
     // check the xlink:href attribute on this element, if it refers to a valid linear/radial gradient
     // that is not in our referenceStack, then go fetch it and copy the valid attributes and stops
     bool bOk = false;
-    QString href = getTrait(element, "xlink:href", &bOk);
+    QString href = getTrait(element, AtomXlinkHref, &bOk);
     if(bOk && !href.isEmpty()) {
 	int refIndex = uriFrag.indexIn(href);
 	if(refIndex == 0) {
@@ -881,15 +870,15 @@ QRadialGradient resolveRadialGradient(const QDomElement& element, qreal opacity,
 			g.setSpread(refGrad.spread());
 		    }
 		    else {
-			cout << "Error! Reference '" << refID.toStdString().c_str() << "' is not a linear/radial gradient" << endl;
+			CARVE_WARNING(LogStyle, QString("Reference '%1' is not a linear/radial gradient").arg(refID));
 		    }
 		}
 		else {
-		    cout << "Error!  Gradient reference '" << refID.toStdString().c_str() << "' not found" << endl;
+		    CARVE_WARNING(LogStyle, QString("Gradient reference '%1' not found").arg(refID));
 		}
 	    }
 	    else {
-		cout << "Error!  Circular reference detected with gradient '" << refID.toStdString().c_str() << "'" << endl;
+		CARVE_WARNING(LogStyle, QString("Circular reference detected with gradient '%1'").arg(refID));
 	    }
 	} // found a URI frag
     } // found xlink:href
@@ -922,7 +911,7 @@ QRadialGradient resolveRadialGradient(const QDomElement& element, qreal opacity,
 
     // gradientUnits attribute
     // (gradientUnits="userSpaceOnUse", objectBoundingBox is the default mode set above)
-    QString gradientUnits(getTrait(element, "gradientUnits"));
+    QString gradientUnits(getTrait(element, AtomGradientUnits));
     if(gradientUnits == "userSpaceOnUse") {
 	g.setCoordinateMode(QGradient::LogicalMode);
     }
@@ -932,7 +921,7 @@ QRadialGradient resolveRadialGradient(const QDomElement& element, qreal opacity,
     }
 
     // spreadMethod attribute, default is "pad" set above
-    QString spreadMethod(getTrait(element, "spreadMethod"));
+    QString spreadMethod(getTrait(element, AtomSpreadMethod));
     if(spreadMethod == "reflect") {
 	g.setSpread(QGradient::ReflectSpread);
     }
@@ -959,7 +948,7 @@ Qt::AspectRatioMode getAspectRatio(const QDomElement& element) {
     // we ignore the 'defer' portion for now (<image> allows it)
     QRegExp alignRE("[xYMindaxoe]{4,}");
     QRegExp sliceRE("\\s+slice\\s*");
-    QString par = getTrait(element, "preserveAspectRatio");
+    QString par = getTrait(element, AtomPreserveAspectRatio);
     int alignIndex = alignRE.indexIn(par);
     if(!par.isEmpty() && alignIndex >= 0) {
 	int alignLength = alignRE.matchedLength();
@@ -27,11 +27,14 @@
 #include <QColor>
 #include <QBrush>
 #include <QPainterPath>
+#include <QPolygonF>
 #include <QPen>
 #include <QLinearGradient>
 #include <QRadialGradient>
 #include <QStack>
 
+#include "carveatoms.h"
+
 QDomElement getElementById(const QDomElement& element, const QString& id);
 
 // trait access
@@ -43,7 +46,23 @@ QStringList getListTrait(const QDomElement& element, const QString& name, bool*
 double getPercentageTrait(const QDomElement& element, const QString& name, bool* bOk = NULL);
 QPainterPath getPathTrait(const QDomElement& element, const QString& name, bool* bOk = NULL);
 QTransform getTransform(const QDomElement& element, bool* bOk = NULL);
+QTransform parseTransform(const QString& text, bool* bOk = NULL);
+// the outline described by path data (a d attribute)
+QPainterPath parsePath(const QString& text, bool* bOk = NULL);
+// the coordinate pairs of a points attribute; empty (and bOk false) unless
+// the text is a non-empty list of an even number of numbers
+QPolygonF parsePoints(const QString& text, bool* bOk = NULL);
+// the outline through those points, closed for a polygon
+QPainterPath parsePoints(const QString& text, bool bClose, bool* bOk = NULL);
 bool setTrait(QDomElement& element, const QString& name, const QString& value);
+// the same for the known names, which are passed as atoms instead of being
+// converted from string literals on every call
+QString getTrait(const QDomElement& element, CarveAtom name, bool* bOk = NULL);
+double getFloatTrait(const QDomElement& element, CarveAtom name, bool* bOk = NULL);
+QBrush getRGBColorTrait(const QDomElement& element, CarveAtom name, bool* bOk = NULL);
+QStringList getListTrait(const QDomElement& element, CarveAtom name, bool* bOk = NULL);
+double getPercentageTrait(const QDomElement& element, CarveAtom name, bool* bOk = NULL);
+QPainterPath getPathTrait(const QDomElement& element, CarveAtom name, bool* bOk = NULL);
 QGradientStops fetchGradientStops(QDomElement paintServer, qreal opacity);
 QLinearGradient resolveLinearGradient(const QDomElement& element, qreal opacity, QStack<QString> referenceStack = QStack<QString>());
 QRadialGradient resolveRadialGradient(const QDomElement& element, qreal opacity, QStack<QString> referenceStack = QStack<QString>());
@@ -3,15 +3,12 @@
 #include <QMenu>
 #include <QAction>
 #include <QTextBlock>
+#include <QScrollBar>
 #include "carvewindow.h"
 #include "carvesvgnode.h"
 #include "carvesvgwindow.h"
 #include "carvesvgdocument.h"
 
-#include <iostream>
-using std::cout;
-using std::endl;
-
 DomTreeView::DomTreeView(CarveWindow* window, QSize hint) :
 	QTreeView(), hint_(hint), mainwindow(window)
 {
@@ -23,6 +20,9 @@ DomTreeView::DomTreeView(CarveWindow* window, QSize hint) :
 
     // ensures that a right-mouse click will select the item under the mouse
     connect(this, SIGNAL(clicked(QModelIndex)), this, SLOT(nodeClicked(const QModelIndex&)));
+    // the model hands out children in batches: ask for the next one when the end comes into view
+    connect(verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(fetchVisible()));
+    connect(this, SIGNAL(expanded(QModelIndex)), this, SLOT(fetchVisible()));
 }
 
 // TODO: figure out the right way initiate a re-serialization of the DOM (shake out the API)
@@ -53,38 +53,89 @@ void DomTreeView::contextMenuEvent(QContextMenuEvent* e)
 
 void DomTreeView::setWindow(CarveSVGWindow* w) {
     if(!w) { return; }
+    if(this->window && this->model()) {
+	this->window->setDomTreeExpansion(this->expandedPaths());
+    }
     this->window = w;
     this->setModel(this->window->model());
 	this->setRootIsDecorated(true);
+
+    if(this->window->domTreeExpansion().isEmpty()) {
+	// first time this window is shown: open the root element only
+	this->expand(this->model()->index(0, 0, QModelIndex()));
+    }
+    else {
+	this->restoreExpansion(this->window->domTreeExpansion());
+    }
 }
 
-void DomTreeView::nodeClicked(const QModelIndex& index) {
-    CarveSVGNode* node = static_cast<CarveSVGNode*>(index.internalPointer());
-    mainwindow->selectNode(node);
+void DomTreeView::collectExpanded(const QModelIndex& index, QList<int>& path, QList<QList<int> >& paths) const {
+    if(!this->isExpanded(index)) { return; }
+    paths << path;
+    // only the rows fetched so far can be expanded
+    int rows = this->model()->rowCount(index);
+    for(int i = 0; i < rows; ++i) {
+	path << i;
+	collectExpanded(this->model()->index(i, 0, index), path, paths);
+	path.removeLast();
+    }
 }
 
-bool DomTreeView::findIndex(CarveSVGNode* node, QModelIndex& index) {
-    bool bFound = false;
-    if(!index.isValid()) {
-	return false;
+QList<QList<int> > DomTreeView::expandedPaths() const {
+    QList<QList<int> > paths;
+    if(!this->model()) { return paths; }
+    QList<int> path;
+    int rows = this->model()->rowCount(QModelIndex());
+    for(int i = 0; i < rows; ++i) {
+	path << i;
+	collectExpanded(this->model()->index(i, 0, QModelIndex()), path, paths);
+	path.removeLast();
     }
+    return paths;
+}
 
-    CarveSVGNode* iNode = static_cast<CarveSVGNode*>(index.internalPointer());
-    if(node == iNode) { bFound = true; }
-
-    // if the current node is not the node we're searching for, search the children
-    if(!bFound) {
-	QModelIndex saveIndex = index;
-	int numChildren = this->model()->rowCount(index);
-	for(int i = 0; i < numChildren; ++i) {
-	    QModelIndex childIndex = index.child(i,0);
-	    if(findIndex(node, childIndex)) {
-		index = childIndex;
-		return true;
+// Parents are listed before their children, so every path is walked through
+// rows that have just been expanded; rows past the fetched ones are fetched.
+void DomTreeView::restoreExpansion(const QList<QList<int> >& paths) {
+    QAbstractItemModel* model = this->model();
+    if(!model) { return; }
+    for(int i = 0; i < paths.size(); ++i) {
+	const QList<int>& path = paths.at(i);
+	QModelIndex index;
+	for(int j = 0; j < path.size(); ++j) {
+	    int row = path.at(j);
+	    while(row >= model->rowCount(index) && model->canFetchMore(index)) {
+		model->fetchMore(index);
 	    }
+	    index = model->index(row, 0, index);
+	    if(!index.isValid()) { break; }
+	}
+	// the document may have lost the row since it was saved
+	if(index.isValid()) {
+	    this->setExpanded(index, true);
+	}
+    }
+}
+
+// When the last fetched child of a node is in view, fetch the next batch of its children.
+void DomTreeView::fetchVisible() {
+    QAbstractItemModel* model = this->model();
+    if(!model) { return; }
+    QModelIndex last = this->indexAt(QPoint(0, this->viewport()->height() - 1));
+    if(!last.isValid()) { return; }
+    // the bottom row may be deep inside the subtree of the node that has more children
+    for(QModelIndex index = last; index.isValid(); index = index.parent()) {
+	QModelIndex parent = index.parent();
+	if(index.row() == model->rowCount(parent) - 1 && model->canFetchMore(parent)) {
+	    model->fetchMore(parent);
+	    return;
 	}
     }
-    return bFound;
+}
+
+void DomTreeView::nodeClicked(const QModelIndex& index) {
+    CarveSVGNode* node = static_cast<CarveSVGNode*>(index.internalPointer());
+    mainwindow->selectNode(node);
 }
 
 #include <QModelIndexList>
@@ -95,8 +146,8 @@ void DomTreeView::nodeSelected(CarveSVGNode* node) {
 	return;
     }
 
-    QModelIndex modelIndex = this->model()->index(0, 0, QModelIndex());
-    if(this->findIndex(node, modelIndex)) {
+    QModelIndex modelIndex = this->window->model()->indexForNode(node);
+    if(modelIndex.isValid()) {
 
 	QModelIndexList indices(this->selectedIndexes());
 	if(indices.length() > 0) {
@@ -111,6 +162,7 @@ void DomTreeView::nodeSelected(CarveSVGNode* node) {
 	}
 
 	this->setCurrentIndex(modelIndex);
+	this->scrollTo(modelIndex);
     }
 
     // TODO: this should be moved to the CarevSVGWindow and handled there as part of the nodeSelected() signal catching
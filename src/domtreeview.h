@@ -2,6 +2,8 @@
 #define DOMTREEVIEW_H
 
 #include <QTreeView>
+#include <QPointer>
+#include <QList>
 class QContextMenuEvent;
 class QMenu;
 class CarveWindow;
@@ -16,6 +18,11 @@ public:
     DomTreeView(CarveWindow* window, QSize hint);
     QSize sizeHint() const { return hint_; }
     void setWindow(CarveSVGWindow* w);
+
+    // The expanded rows, each as the row numbers leading to it from the top.
+    // Used to carry the expansion state across a rebuild of the model.
+    QList<QList<int> > expandedPaths() const;
+    void restoreExpansion(const QList<QList<int> >& paths);
 protected:
     void contextMenuEvent(QContextMenuEvent* e);
 private:
@@ -23,9 +30,13 @@ private:
     QMenu* menuContext;
     QAction* actionDeleteNode;
     CarveWindow* mainwindow;
-    CarveSVGWindow* window;
+    // guarded: the window may have been closed since it was last active
+    QPointer<CarveSVGWindow> window;
+
+    void collectExpanded(const QModelIndex& index, QList<int>& path, QList<QList<int> >& paths) const;
 
-    bool findIndex(CarveSVGNode* node, QModelIndex& index);
+private slots:
+    void fetchVisible();
 
 public slots:
     void nodeClicked(const QModelIndex& index);
@@ -19,10 +19,15 @@
 */
 #include <QtGui/QApplication>
 #include "carvewindow.h"
+#include "carvelog.h"
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+    // as in QSettings("codedread", "Carve"); also names the data directory
+    a.setOrganizationName("codedread");
+    a.setApplicationName("Carve");
+    CarveLog::init();
     CarveWindow w;
     w.show();
     return a.exec();
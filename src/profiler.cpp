@@ -0,0 +1,98 @@
+#include "profiler.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QFile>
+#include <QTextStream>
+#include <cstring>
+
+// keep at most this many individual events around for the trace export,
+// the per-phase statistics keep counting after that
+const int MAX_PROFILE_EVENTS = 1 << 20;
+
+bool CarveProfiler::enabled_ = false;
+
+static QElapsedTimer profileClock;
+static QVector<CarveProfiler::Event> profileEvents;
+// keyed on the literal's address, merged by name in stats()
+static QHash<const char*, CarveProfiler::PhaseStats> profileStats;
+
+void CarveProfiler::setEnabled(bool enabled) {
+    if(enabled && !profileClock.isValid()) {
+        profileClock.start();
+    }
+    enabled_ = enabled;
+}
+
+void CarveProfiler::clear() {
+    profileEvents.clear();
+    profileStats.clear();
+}
+
+qint64 CarveProfiler::now() {
+    return profileClock.nsecsElapsed();
+}
+
+void CarveProfiler::record(const char* phase, qint64 start, qint64 duration) {
+    if(profileEvents.size() < MAX_PROFILE_EVENTS) {
+        Event e = { phase, start, duration };
+        profileEvents.append(e);
+    }
+
+    QHash<const char*, PhaseStats>::iterator it = profileStats.find(phase);
+    if(it == profileStats.end()) {
+        PhaseStats empty;
+        memset(&empty, 0, sizeof(empty));
+        it = profileStats.insert(phase, empty);
+    }
+
+    PhaseStats& s = it.value();
+    s.count++;
+    s.total += duration;
+    if(duration > s.max) { s.max = duration; }
+
+    int bucket = 0;
+    for(qint64 us = duration / 1000; us > 1 && bucket < NumBuckets-1; us >>= 1) {
+        ++bucket;
+    }
+    s.buckets[bucket]++;
+}
+
+QMap<QString, CarveProfiler::PhaseStats> CarveProfiler::stats() {
+    QMap<QString, PhaseStats> result;
+    QHash<const char*, PhaseStats>::const_iterator it = profileStats.constBegin();
+    for( ; it != profileStats.constEnd(); ++it) {
+        QString name = QString::fromLatin1(it.key());
+        if(!result.contains(name)) {
+            result[name] = it.value();
+            continue;
+        }
+        PhaseStats& s = result[name];
+        s.count += it.value().count;
+        s.total += it.value().total;
+        if(it.value().max > s.max) { s.max = it.value().max; }
+        for(int b = 0; b < NumBuckets; ++b) { s.buckets[b] += it.value().buckets[b]; }
+    }
+    return result;
+}
+
+// Writes the recorded events in the Trace Event format understood by chrome://tracing
+bool CarveProfiler::exportChromeTrace(const QString& filename, QString* error) {
+    QFile file(filename);
+    if(!file.open(QFile::WriteOnly | QFile::Text)) {
+        if(error) { *error = file.errorString(); }
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "{\"traceEvents\":[\n";
+    for(int i = 0; i < profileEvents.size(); ++i) {
+        const Event& e = profileEvents.at(i);
+        out << "{\"name\":\"" << e.phase << "\",\"cat\":\"carve\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+            << ",\"ts\":" << QString::number(e.start / 1000.0, 'f', 3)
+            << ",\"dur\":" << QString::number(e.duration / 1000.0, 'f', 3) << "}";
+        out << (i+1 < profileEvents.size() ? ",\n" : "\n");
+    }
+    out << "],\"displayTimeUnit\":\"ms\"}\n";
+    return true;
+}
@@ -0,0 +1,63 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <QString>
+#include <QVector>
+#include <QMap>
+
+// Scoped timers around the main phases of Carve (parsing, model building, style
+// resolution, highlighting, painting).  Profiling is switched on and off at runtime
+// from the Profiler pane; while it is off a CARVE_PROFILE() scope costs one branch.
+
+class CarveProfiler
+{
+public:
+    struct Event {
+        const char* phase;
+        qint64 start;       // ns since profiling was first enabled
+        qint64 duration;    // ns
+    };
+
+    // durations are bucketed by powers of two, starting at 1 microsecond
+    enum { NumBuckets = 24 };
+
+    struct PhaseStats {
+        int count;
+        qint64 total;
+        qint64 max;
+        int buckets[NumBuckets];
+    };
+
+    static bool isEnabled() { return enabled_; }
+    static void setEnabled(bool enabled);
+    static void clear();
+
+    static qint64 now();
+    static void record(const char* phase, qint64 start, qint64 duration);
+
+    static QMap<QString, PhaseStats> stats();
+    static bool exportChromeTrace(const QString& filename, QString* error = 0);
+
+private:
+    static bool enabled_;
+};
+
+class CarveProfileScope
+{
+public:
+    explicit CarveProfileScope(const char* phase) : phase_(phase), start_(-1) {
+        if(CarveProfiler::isEnabled()) { start_ = CarveProfiler::now(); }
+    }
+    ~CarveProfileScope() {
+        if(start_ >= 0) { CarveProfiler::record(phase_, start_, CarveProfiler::now() - start_); }
+    }
+
+private:
+    const char* phase_;
+    qint64 start_;
+};
+
+// phase must be a string literal (only the pointer is kept)
+#define CARVE_PROFILE(phase) CarveProfileScope carveProfileScope_(phase)
+
+#endif // PROFILER_H
@@ -0,0 +1,170 @@
+#include "profilerpane.h"
+#include "profiler.h"
+
+#include <QCheckBox>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QTreeWidgetItem>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QPainter>
+#include <QTimer>
+#include <QFileDialog>
+#include <QMessageBox>
+
+// how often the pane picks up new samples while profiling
+const int PROFILER_REFRESH = 1000;
+
+class ProfileHistogram : public QWidget
+{
+public:
+    ProfileHistogram() : QWidget() {
+        clear();
+        setMinimumHeight(80);
+    }
+
+    void clear() {
+        for(int b = 0; b < CarveProfiler::NumBuckets; ++b) { buckets_[b] = 0; }
+        update();
+    }
+
+    void setStats(const CarveProfiler::PhaseStats& stats) {
+        for(int b = 0; b < CarveProfiler::NumBuckets; ++b) { buckets_[b] = stats.buckets[b]; }
+        update();
+    }
+
+protected:
+    void paintEvent(QPaintEvent*) {
+        QPainter painter(this);
+        painter.fillRect(rect(), palette().base());
+
+        int maxCount = 0;
+        int lastBucket = 0;
+        for(int b = 0; b < CarveProfiler::NumBuckets; ++b) {
+            if(buckets_[b] > maxCount) { maxCount = buckets_[b]; }
+            if(buckets_[b] > 0) { lastBucket = b; }
+        }
+        if(maxCount == 0) { return; }
+
+        // one bar per power-of-two bucket, labelled with its lower bound
+        int numBars = lastBucket + 1;
+        int labelHeight = fontMetrics().height();
+        qreal barWidth = (qreal)width() / numBars;
+        qreal maxHeight = height() - labelHeight - 2;
+        for(int b = 0; b < numBars; ++b) {
+            qreal h = maxHeight * buckets_[b] / maxCount;
+            QRectF bar(b * barWidth + 1, maxHeight - h, barWidth - 2, h);
+            painter.fillRect(bar, palette().highlight());
+
+            qint64 us = (qint64)1 << b;
+            QString label = us < 1000 ? QString("%1us").arg(us) : QString("%1ms").arg(us / 1000);
+            painter.drawText(QRectF(b * barWidth, maxHeight, barWidth, labelHeight), Qt::AlignCenter, label);
+        }
+    }
+
+private:
+    int buckets_[CarveProfiler::NumBuckets];
+};
+
+ProfilerPane::ProfilerPane(const QSize& hint) :
+        QWidget(), hint_(hint)
+{
+    enabledBox_ = new QCheckBox(tr("Profile"));
+    QPushButton* clearButton = new QPushButton(tr("Clear"));
+    QPushButton* exportButton = new QPushButton(tr("Export Trace..."));
+
+    phases_ = new QTreeWidget();
+    phases_->setRootIsDecorated(false);
+    phases_->setColumnCount(5);
+    phases_->setHeaderLabels(QStringList() << tr("Phase") << tr("Count") << tr("Total (ms)") << tr("Mean (us)") << tr("Max (us)"));
+
+    histogram_ = new ProfileHistogram();
+
+    QHBoxLayout* buttons = new QHBoxLayout;
+    buttons->addWidget(enabledBox_);
+    buttons->addStretch(1);
+    buttons->addWidget(clearButton);
+    buttons->addWidget(exportButton);
+
+    QVBoxLayout* layout = new QVBoxLayout;
+    layout->addLayout(buttons);
+    layout->addWidget(phases_, 1);
+    layout->addWidget(histogram_);
+    setLayout(layout);
+
+    refreshTimer_ = new QTimer(this);
+
+    connect(enabledBox_, SIGNAL(toggled(bool)), this, SLOT(setProfiling(bool)));
+    connect(clearButton, SIGNAL(clicked()), this, SLOT(clearProfile()));
+    connect(exportButton, SIGNAL(clicked()), this, SLOT(exportTrace()));
+    connect(phases_, SIGNAL(itemSelectionChanged()), this, SLOT(phaseChanged()));
+    connect(refreshTimer_, SIGNAL(timeout()), this, SLOT(refresh()));
+}
+
+void ProfilerPane::setProfiling(bool enabled) {
+    CarveProfiler::setEnabled(enabled);
+    if(enabled) {
+        refreshTimer_->start(PROFILER_REFRESH);
+    }
+    else {
+        refreshTimer_->stop();
+        refresh();
+    }
+}
+
+void ProfilerPane::clearProfile() {
+    CarveProfiler::clear();
+    refresh();
+}
+
+void ProfilerPane::exportTrace() {
+    QString fileName = QFileDialog::getSaveFileName(this, tr("Export Chrome Trace"), "carve-trace.json", "Trace Files (*.json)");
+    if(fileName.isEmpty()) {
+        return;
+    }
+
+    QString error;
+    if(!CarveProfiler::exportChromeTrace(fileName, &error)) {
+        QMessageBox::warning(this, tr("Carve"), tr("Cannot write file %1:\n%2.").arg(fileName).arg(error));
+    }
+}
+
+void ProfilerPane::refresh() {
+    QString selected;
+    if(phases_->currentItem()) {
+        selected = phases_->currentItem()->text(0);
+    }
+
+    phases_->clear();
+    QMap<QString, CarveProfiler::PhaseStats> stats = CarveProfiler::stats();
+    QMap<QString, CarveProfiler::PhaseStats>::const_iterator it = stats.constBegin();
+    for( ; it != stats.constEnd(); ++it) {
+        const CarveProfiler::PhaseStats& s = it.value();
+        QTreeWidgetItem* item = new QTreeWidgetItem(phases_);
+        item->setText(0, it.key());
+        item->setText(1, QString::number(s.count));
+        item->setText(2, QString::number(s.total / 1000000.0, 'f', 2));
+        item->setText(3, QString::number(s.count ? s.total / 1000.0 / s.count : 0.0, 'f', 1));
+        item->setText(4, QString::number(s.max / 1000.0, 'f', 1));
+        if(it.key() == selected) {
+            phases_->setCurrentItem(item);
+        }
+    }
+
+    if(!phases_->currentItem()) {
+        histogram_->clear();
+    }
+}
+
+void ProfilerPane::phaseChanged() {
+    QTreeWidgetItem* item = phases_->currentItem();
+    if(!item) {
+        histogram_->clear();
+        return;
+    }
+
+    QMap<QString, CarveProfiler::PhaseStats> stats = CarveProfiler::stats();
+    if(stats.contains(item->text(0))) {
+        histogram_->setStats(stats[item->text(0)]);
+    }
+}
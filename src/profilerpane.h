@@ -0,0 +1,37 @@
+#ifndef PROFILERPANE_H
+#define PROFILERPANE_H
+
+#include <QWidget>
+
+class QCheckBox;
+class QTreeWidget;
+class QTreeWidgetItem;
+class QTimer;
+class ProfileHistogram;
+
+// Per-phase timings collected by CarveProfiler, with a histogram of the
+// selected phase and an export to a Chrome trace file
+class ProfilerPane : public QWidget
+{
+    Q_OBJECT
+
+public:
+    ProfilerPane(const QSize& hint);
+    QSize sizeHint() const { return hint_; }
+
+private slots:
+    void setProfiling(bool enabled);
+    void clearProfile();
+    void exportTrace();
+    void refresh();
+    void phaseChanged();
+
+private:
+    QSize hint_;
+    QCheckBox* enabledBox_;
+    QTreeWidget* phases_;
+    ProfileHistogram* histogram_;
+    QTimer* refreshTimer_;
+};
+
+#endif // PROFILERPANE_H
@@ -1,19 +1,17 @@
 #include "propertiespane.h"
 #include "carvesvgnode.h"
+#include "carvesvgdocument.h"
 #include "domhelper.h"
+#include "carvelog.h"
+#include "carveatoms.h"
 
 #include <QFrame>
 #include <QFormLayout>
 #include <QLabel>
 #include <QLineEdit>
 #include <QString>
-#include <QDomText>
 
-#include <iostream>
-using std::cout;
-using std::endl;
-
-QHash<int, QStringList> PropertiesPane::properties;
+QHash<int, QList<int> > PropertiesPane::properties;
 
 PropertiesPane::PropertiesPane(const QSize& size) :
 	QScrollArea()
@@ -21,154 +19,165 @@ PropertiesPane::PropertiesPane(const QSize& size) :
     // these are the default properties shown in the properties panel
     if(this->properties.isEmpty()) {
 	properties[svgSvg]
-		<< "width"
-		<< "height"
-		<< "viewBox"
-		<< "version"
-		<< "baseProfile"
-		<< "id"
-		<< "style"
+		<< AtomWidth
+		<< AtomHeight
+		<< AtomViewBox
+		<< AtomVersion
+		<< AtomBaseProfile
+		<< AtomId
+		<< AtomStyle
 		;
         properties[svgG]
-                << "id"
-                << "transform"
-                << "fill"
-                << "fill-opacity"
-                << "stroke"
-                << "stroke-opacity"
-                << "font-size"
-		<< "style"
+                << AtomId
+                << AtomTransform
+                << AtomFill
+                << AtomFillOpacity
+                << AtomStroke
+                << AtomStrokeOpacity
+                << AtomFontSize
+		<< AtomStyle
 		;
 	properties[svgRect]
-		<< "id"
-		<< "x"
-		<< "y"
-		<< "width"
-		<< "height"
-		<< "rx"
-		<< "ry"
-		<< "fill"
-		<< "fill-opacity"
-		<< "stroke"
-		<< "stroke-opacity"
-		<< "stroke-width"
-		<< "style"
+		<< AtomId
+		<< AtomX
+		<< AtomY
+		<< AtomWidth
+		<< AtomHeight
+		<< AtomRx
+		<< AtomRy
+		<< AtomFill
+		<< AtomFillOpacity
+		<< AtomStroke
+		<< AtomStrokeOpacity
+		<< AtomStrokeWidth
+		<< AtomStyle
 		;
 	properties[svgCircle]
-		<< "id"
-		<< "cx"
-		<< "cy"
-		<< "r"
-		<< "fill"
-		<< "fill-opacity"
-		<< "stroke"
-		<< "stroke-opacity"
-		<< "stroke-width"
-		<< "style"
+		<< AtomId
+		<< AtomCx
+		<< AtomCy
+		<< AtomR
+		<< AtomFill
+		<< AtomFillOpacity
+		<< AtomStroke
+		<< AtomStrokeOpacity
+		<< AtomStrokeWidth
+		<< AtomStyle
 		;
 	properties[svgEllipse]
-		<< "id"
-		<< "cx"
-		<< "cy"
-		<< "rx"
-		<< "ry"
-		<< "fill"
-		<< "fill-opacity"
-		<< "stroke"
-		<< "stroke-opacity"
-		<< "stroke-width"
-		<< "style"
+		<< AtomId
+		<< AtomCx
+		<< AtomCy
+		<< AtomRx
+		<< AtomRy
+		<< AtomFill
+		<< AtomFillOpacity
+		<< AtomStroke
+		<< AtomStrokeOpacity
+		<< AtomStrokeWidth
+		<< AtomStyle
 		;
 	properties[svgLine]
-		<< "id"
-		<< "x1"
-		<< "y1"
-		<< "x2"
-		<< "y2"
-		<< "stroke"
-		<< "stroke-opacity"
-		<< "stroke-width"
-		<< "style"
+		<< AtomId
+		<< AtomX1
+		<< AtomY1
+		<< AtomX2
+		<< AtomY2
+		<< AtomStroke
+		<< AtomStrokeOpacity
+		<< AtomStrokeWidth
+		<< AtomStyle
 		;
 	properties[svgPolyline]
-		<< "id"
-		<< "stroke"
-		<< "stroke-opacity"
-		<< "stroke-width"
-		<< "style"
+		<< AtomId
+		<< AtomStroke
+		<< AtomStrokeOpacity
+		<< AtomStrokeWidth
+		<< AtomStyle
 		;
 	properties[svgPolygon]
-		<< "id"
-		<< "fill"
-		<< "fill-opacity"
-		<< "stroke"
-		<< "stroke-opacity"
-		<< "stroke-width"
-		<< "style"
+		<< AtomId
+		<< AtomFill
+		<< AtomFillOpacity
+		<< AtomStroke
+		<< AtomStrokeOpacity
+		<< AtomStrokeWidth
+		<< AtomStyle
 		;
 	properties[svgPath]
-		<< "id"
-		<< "fill"
-		<< "fill-opacity"
-		<< "stroke"
-		<< "stroke-opacity"
-		<< "stroke-width"
-		<< "style"
+		<< AtomId
+		<< AtomFill
+		<< AtomFillOpacity
+		<< AtomStroke
+		<< AtomStrokeOpacity
+		<< AtomStrokeWidth
+		<< AtomStyle
 		;
 	properties[svgLinearGradient]
-		<< "id"
-		<< "x1"
-		<< "y1"
-		<< "x2"
-		<< "y2"
-		<< "gradientUnits"
-//		<< "xlink:href"
+		<< AtomId
+		<< AtomX1
+		<< AtomY1
+		<< AtomX2
+		<< AtomY2
+		<< AtomGradientUnits
+//		<< AtomXlinkHref
 		;
 	properties[svgRadialGradient]
-		<< "id"
-		<< "cx"
-		<< "cy"
-		<< "r"
-//		<< "fx"
-//		<< "fy"
-		<< "gradientUnits"
-//		<< "xlink:href"
+		<< AtomId
+		<< AtomCx
+		<< AtomCy
+		<< AtomR
+//		<< AtomFx
+//		<< AtomFy
+		<< AtomGradientUnits
+//		<< AtomXlinkHref
 		;
 	properties[svgStop]
-		<< "offset"
-		<< "stop-color"
-		<< "stop-opacity"
-		<< "style"
+		<< AtomOffset
+		<< AtomStopColor
+		<< AtomStopOpacity
+		<< AtomStyle
 		;
 	properties[svgText]
-		<< "id"
-		<< "#text"
-		<< "x"
-		<< "y"
-		<< "font-size"
-		<< "font-weight"
-		<< "font-family"
-		<< "fill"
-		<< "fill-opacity"
-		<< "stroke"
-		<< "stroke-opacity"
-		<< "stroke-width"
-		<< "style"
+		<< AtomId
+		<< AtomTextContent
+		<< AtomX
+		<< AtomY
+		<< AtomFontSize
+		<< AtomFontWeight
+		<< AtomFontFamily
+		<< AtomFill
+		<< AtomFillOpacity
+		<< AtomStroke
+		<< AtomStrokeOpacity
+		<< AtomStrokeWidth
+		<< AtomStyle
 		;
 	properties[svgA]
-		<< "xlink:href"
-		<< "xlink:title"
-		<< "style"
+		<< AtomXlinkHref
+		<< AtomXlinkTitle
+		<< AtomStyle
 		;
 	properties[svgImage]
-		<< "id"
-		<< "xlink:href"
-		<< "x"
-		<< "y"
-		<< "width"
-		<< "height"
-		<< "preserveAspectRatio"
-		<< "style"
+		<< AtomId
+		<< AtomXlinkHref
+		<< AtomX
+		<< AtomY
+		<< AtomWidth
+		<< AtomHeight
+		<< AtomPreserveAspectRatio
+		<< AtomStyle
+		;
+	properties[svgUse]
+		<< AtomId
+		<< AtomXlinkHref
+		<< AtomX
+		<< AtomY
+		<< AtomTransform
+		<< AtomFill
+		<< AtomStroke
+		<< AtomClass
+		<< AtomStyle
 		;
     }
 
@@ -194,6 +203,7 @@ void PropertiesPane::setNode(CarveSVGNode* node) {
     }
     this->labels.clear();
     this->edits.clear();
+    this->atoms.clear();
 
     this->node_ = node;
 
@@ -212,18 +222,20 @@ void PropertiesPane::createFields(int type) {
     propPane = new QFrame();
     if(this->properties.contains(type)) {
 	QFormLayout* newLayout = new QFormLayout;
-	QStringList& propList = properties[(int)type];
+	const QList<int>& propList = properties[(int)type];
 	for(int i = 0; i < propList.size(); ++i) {
-	    QLabel* theLabel = new QLabel(propList[i]);
+	    QString name = CarveAtoms::name(propList[i]);
+	    QLabel* theLabel = new QLabel(name);
 	    QLineEdit* theEdit = NULL;
-	    if(propList[i] == "#text") {
+	    if(propList[i] == AtomTextContent) {
 		theEdit = new QLineEdit(node_->domElem().text());
 	    }
 	    else {
-		theEdit = new QLineEdit(node_->domElem().attributes().namedItem(propList[i]).nodeValue());
+		theEdit = new QLineEdit(node_->domElem().attributes().namedItem(name).nodeValue());
 	    }
 	    this->labels.append(theLabel);
 	    this->edits.append(theEdit);
+	    this->atoms.append(propList[i]);
 	    connect(theEdit, SIGNAL(editingFinished()), this, SLOT(fieldChanged()));
 	    newLayout->addRow(theLabel, theEdit);
 	}
@@ -234,26 +246,17 @@ void PropertiesPane::createFields(int type) {
 }
 
 void PropertiesPane::fieldChanged() {
-    cout << "field changed" << endl;
     if(!node_) { return; }
 
-    QFormLayout* layout = qobject_cast<QFormLayout*>(propPane->layout());
     QLineEdit* theEdit = qobject_cast<QLineEdit*>(sender());
-    if(layout && theEdit) {
-	QLabel* theLabel = qobject_cast<QLabel*>(layout->labelForField(theEdit));
-	if(theLabel) {
-	    if(theLabel->text() == "#text") {
-		// clear out children
-		QDomElement elem = node_->domElem();
-		while(elem.hasChildNodes()) {
-		    elem.removeChild(node_->domElem().lastChild());
-		}
-		elem.appendChild(elem.ownerDocument().createTextNode(theEdit->text()));
-	    }
-	    else {
-		cout << "Set trait" << endl;
-		node_->setTrait(theLabel->text(), theEdit->text());
-	    }
+    int field = this->edits.indexOf(theEdit);
+    if(field >= 0) {
+	int atom = this->atoms.at(field);
+	if(atom == AtomTextContent) {
+	    node_->document()->setTextContent(node_, theEdit->text());
+	}
+	else {
+	    node_->setTrait(CarveAtoms::name(atom), theEdit->text());
 	}
     }
 }
@@ -28,7 +28,10 @@ private:
     CarveSVGNode* node_;
     QList<QLabel*> labels;
     QList<QLineEdit*> edits;
-    static QHash<int, QStringList> properties;
+    // the attribute atom each field edits
+    QList<int> atoms;
+    // the attributes shown for each node type
+    static QHash<int, QList<int> > properties;
 
     void createFields(int type);
 
@@ -18,15 +18,13 @@
 
 */
 #include "svghighlighter.h"
+#include "profiler.h"
+#include "carvelog.h"
 
 #include <QTextDocument>
 #include <QRegExp>
 #include <QStringList>
 
-#include <iostream>
-using std::cout;
-using std::endl;
-
 SVGHighlighter::SVGHighlighter(QTextDocument* parent) : QSyntaxHighlighter(parent)
 {
     // from http://www.w3.org/TR/SVGTiny12/elementTable.html
@@ -386,6 +384,7 @@ QRegExp rCloseTag("</[a-zA-Z]([a-zA-Z0-9]|\\:)*>");
 QRegExp rAttrName("[a-zA-Z](\\w|\\:|\\-)*=");
 
 void SVGHighlighter::highlightBlock(const QString &text) {
+    CARVE_PROFILE("highlightBlock");
     int index = 0;
     int state = this->previousBlockState();
 
@@ -593,7 +592,7 @@ void SVGHighlighter::highlightBlock(const QString &text) {
                 }
                 break; }
             case POSTDOC: {
-                cout << "Somehow got to POSTDOC" << endl;
+                CARVE_WARNING(LogParse, "Highlighter reached an unexpected POSTDOC state");
                 index = text.size();
                 break; }
             case MALFORMED: {